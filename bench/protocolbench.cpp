@@ -0,0 +1,785 @@
+// MIT License
+//
+// Copyright (c) 2021. Happy GardenPI
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+using namespace std;
+
+#include <hgardenpi-protocol/constants.hpp>
+#include <hgardenpi-protocol/protocol.hpp>
+#include <hgardenpi-protocol/reassembler.hpp>
+#include <hgardenpi-protocol/bulktransfer.hpp>
+#include <hgardenpi-protocol/transport.hpp>
+#include <hgardenpi-protocol/packages/aggregation.hpp>
+#include <hgardenpi-protocol/packages/data.hpp>
+#include <hgardenpi-protocol/packages/error.hpp>
+#include <hgardenpi-protocol/packages/finish.hpp>
+#include <hgardenpi-protocol/packages/station.hpp>
+#include <hgardenpi-protocol/packages/synchro.hpp>
+#include <hgardenpi-protocol/utilities/crcutils.hpp>
+#include <hgardenpi-protocol/3thparts/libcrc/checksum.h>
+using namespace hgardenpi::protocol;
+
+/**
+ * @brief Payload sizes of Data: one frame, biggest single frame and HEAD_MAX_CHUNK full chunks plus the last one
+ */
+static constexpr const int64_t DATA_SIZES[] = {16, HEAD_MAX_PAYLOAD_SIZE - 3, (HEAD_MAX_CHUNK + 1) * HEAD_MAX_PAYLOAD_SIZE - 3};
+
+/**
+ * @brief Report frames/s and bytes/s
+ * @param state of benchmark
+ * @param frames processed by every iteration
+ * @param bytes processed by every iteration
+ */
+static void setRates(benchmark::State &state, size_t frames, size_t bytes)
+{
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+    state.counters["frames/s"] = benchmark::Counter(static_cast<double>(state.iterations() * frames), benchmark::Counter::kIsRate);
+}
+
+/**
+ * @brief Fill fields of a package with realistic values
+ */
+template<typename T>
+static void fillPackage(T &package);
+
+template<>
+void fillPackage(Aggregation &package)
+{
+    package.id = 1;
+    package.setDescription("aggregation of the garden");
+    package.setStart("06:00");
+    package.setEnd("07:30");
+    package.weight = 10;
+}
+
+template<>
+void fillPackage(Data &package)
+{
+    package.setPayload(string(HEAD_MAX_PAYLOAD_SIZE - 3, 'd'));
+}
+
+template<>
+void fillPackage(Error &package)
+{
+    package.setMsg(string(HEAD_MAX_PAYLOAD_SIZE - 3, 'e'));
+}
+
+template<>
+void fillPackage(Finish &)
+{
+}
+
+template<>
+void fillPackage(Station &package)
+{
+    package.id = 1;
+    package.setName("station");
+    package.setDescription("station of the lawn");
+    package.relayNumber = 2;
+    package.wateringTime = 600;
+    package.weight = 10;
+}
+
+template<>
+void fillPackage(Synchro &package)
+{
+    package.setSerial(string(HEAD_MAX_SERIAL_SIZE, 's'));
+}
+
+/**
+ * @brief Encode a Data package with a payload of size bytes
+ * @param size of payload
+ * @return frames
+ */
+static Buffers encodeData(size_t size)
+{
+    Data data;
+    data.setPayload(string(size, 'd'));
+    return encode(&data);
+}
+
+/**
+ * @brief Get total size of frames
+ * @param buffers frames
+ * @return bytes
+ */
+static size_t getSize(const Buffers &buffers)
+{
+    size_t ret = 0;
+    for (auto &&it : buffers)
+    {
+        ret += it.second;
+    }
+    return ret;
+}
+
+/**
+ * @brief Fill a full frame, crc16 is calculated on head and payload
+ */
+static void fillFrame(uint8_t (&frame)[HEAD_MAX_FRAME_SIZE]) noexcept
+{
+    for (auto &&it : frame)
+    {
+        it = rand() % 256;
+    }
+}
+
+static void crc_16Bytewise(benchmark::State &state)
+{
+    uint8_t frame[HEAD_MAX_FRAME_SIZE];
+    fillFrame(frame);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(crc_16(frame, HEAD_MAX_FRAME_SIZE - HEAD_CRC_SIZE));
+    }
+    setRates(state, 1, HEAD_MAX_FRAME_SIZE - HEAD_CRC_SIZE);
+}
+BENCHMARK(crc_16Bytewise);
+
+static void crc16SlicingBy8(benchmark::State &state)
+{
+    uint8_t frame[HEAD_MAX_FRAME_SIZE];
+    fillFrame(frame);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(crc16Table(frame, HEAD_MAX_FRAME_SIZE - HEAD_CRC_SIZE));
+    }
+    setRates(state, 1, HEAD_MAX_FRAME_SIZE - HEAD_CRC_SIZE);
+}
+BENCHMARK(crc16SlicingBy8);
+
+static void crc16Clmul(benchmark::State &state)
+{
+    if (!crc16ClmulSupported())
+    {
+        state.SkipWithError("carry-less multiply not supported");
+        return;
+    }
+    uint8_t frame[HEAD_MAX_FRAME_SIZE];
+    fillFrame(frame);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(crc16Clmul(frame, HEAD_MAX_FRAME_SIZE - HEAD_CRC_SIZE));
+    }
+    setRates(state, 1, HEAD_MAX_FRAME_SIZE - HEAD_CRC_SIZE);
+}
+BENCHMARK(crc16Clmul);
+
+static void crc32cSlicingBy8(benchmark::State &state)
+{
+    uint8_t frame[HEAD_MAX_FRAME_SIZE];
+    fillFrame(frame);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(crc32cTable(frame, HEAD_MAX_FRAME_SIZE - HEAD_CRC_SIZE));
+    }
+    setRates(state, 1, HEAD_MAX_FRAME_SIZE - HEAD_CRC_SIZE);
+}
+BENCHMARK(crc32cSlicingBy8);
+
+static void crc32cHardware(benchmark::State &state)
+{
+    if (!crc32cHardwareSupported())
+    {
+        state.SkipWithError("crc32 instructions not supported");
+        return;
+    }
+    uint8_t frame[HEAD_MAX_FRAME_SIZE];
+    fillFrame(frame);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(crc32cHardware(frame, HEAD_MAX_FRAME_SIZE - HEAD_CRC_SIZE));
+    }
+    setRates(state, 1, HEAD_MAX_FRAME_SIZE - HEAD_CRC_SIZE);
+}
+BENCHMARK(crc32cHardware);
+
+template<typename T>
+static void encodeDispatch(benchmark::State &state)
+{
+    T package;
+    uint8_t out[HEAD_MAX_FRAME_SIZE];
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(encodeInto(package, out, sizeof(out)));
+    }
+    setRates(state, 1, getEncodedSize(package));
+}
+BENCHMARK_TEMPLATE(encodeDispatch, Aggregation);
+BENCHMARK_TEMPLATE(encodeDispatch, Data);
+BENCHMARK_TEMPLATE(encodeDispatch, Error);
+BENCHMARK_TEMPLATE(encodeDispatch, Finish);
+BENCHMARK_TEMPLATE(encodeDispatch, Station);
+BENCHMARK_TEMPLATE(encodeDispatch, Synchro);
+
+template<typename T>
+static void decodeDispatch(benchmark::State &state)
+{
+    T package;
+    uint8_t out[HEAD_MAX_FRAME_SIZE];
+    auto &&frames = encodeInto(package, out, sizeof(out));
+    auto &&head = view(out, frames.size);
+    for (auto _ : state)
+    {
+        auto ptr = head.deserialize();
+        benchmark::DoNotOptimize(ptr);
+        delete ptr;
+    }
+    setRates(state, 1, frames.size);
+}
+BENCHMARK_TEMPLATE(decodeDispatch, Aggregation);
+BENCHMARK_TEMPLATE(decodeDispatch, Data);
+BENCHMARK_TEMPLATE(decodeDispatch, Error);
+BENCHMARK_TEMPLATE(decodeDispatch, Finish);
+BENCHMARK_TEMPLATE(decodeDispatch, Station);
+BENCHMARK_TEMPLATE(decodeDispatch, Synchro);
+
+template<typename T>
+static void serialize(benchmark::State &state)
+{
+    T package;
+    fillPackage(package);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(package.serialize());
+    }
+    setRates(state, 1, package.getSerializedSize());
+}
+BENCHMARK_TEMPLATE(serialize, Aggregation);
+BENCHMARK_TEMPLATE(serialize, Data);
+BENCHMARK_TEMPLATE(serialize, Error);
+BENCHMARK_TEMPLATE(serialize, Finish);
+BENCHMARK_TEMPLATE(serialize, Station);
+BENCHMARK_TEMPLATE(serialize, Synchro);
+
+template<typename T>
+static void serializeInto(benchmark::State &state)
+{
+    T package;
+    fillPackage(package);
+    uint8_t out[HEAD_MAX_PAYLOAD_SIZE];
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(package.serializeInto(out, sizeof(out)));
+    }
+    setRates(state, 1, package.getSerializedSize());
+}
+BENCHMARK_TEMPLATE(serializeInto, Aggregation);
+BENCHMARK_TEMPLATE(serializeInto, Data);
+BENCHMARK_TEMPLATE(serializeInto, Error);
+BENCHMARK_TEMPLATE(serializeInto, Finish);
+BENCHMARK_TEMPLATE(serializeInto, Station);
+BENCHMARK_TEMPLATE(serializeInto, Synchro);
+
+template<typename T>
+static void deserialize(benchmark::State &state)
+{
+    T package;
+    fillPackage(package);
+    uint8_t out[HEAD_MAX_PAYLOAD_SIZE];
+    auto size = static_cast<uint8_t>(package.getSerializedSize());
+    benchmark::DoNotOptimize(package.serializeInto(out, sizeof(out)));
+    for (auto _ : state)
+    {
+        auto ptr = T::deserialize(out, size, 0);
+        benchmark::DoNotOptimize(ptr);
+        delete ptr;
+    }
+    setRates(state, 1, size);
+}
+BENCHMARK_TEMPLATE(deserialize, Aggregation);
+BENCHMARK_TEMPLATE(deserialize, Data);
+BENCHMARK_TEMPLATE(deserialize, Error);
+BENCHMARK_TEMPLATE(deserialize, Finish);
+BENCHMARK_TEMPLATE(deserialize, Station);
+BENCHMARK_TEMPLATE(deserialize, Synchro);
+
+static void textGetter(benchmark::State &state)
+{
+    Station package;
+    fillPackage(package);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(package.getDescription());
+    }
+    setRates(state, 1, package.descriptionLen);
+}
+BENCHMARK(textGetter);
+
+static void textView(benchmark::State &state)
+{
+    Station package;
+    fillPackage(package);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(package.getDescriptionView());
+    }
+    setRates(state, 1, package.descriptionLen);
+}
+BENCHMARK(textView);
+
+template<typename T>
+static void deserializeInto(benchmark::State &state)
+{
+    T package;
+    fillPackage(package);
+    uint8_t out[HEAD_MAX_PAYLOAD_SIZE];
+    auto size = static_cast<uint8_t>(package.getSerializedSize());
+    benchmark::DoNotOptimize(package.serializeInto(out, sizeof(out)));
+    T existing;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(T::deserializeInto(existing, out, size, 0));
+    }
+    setRates(state, 1, size);
+}
+BENCHMARK_TEMPLATE(deserializeInto, Aggregation);
+BENCHMARK_TEMPLATE(deserializeInto, Data);
+BENCHMARK_TEMPLATE(deserializeInto, Error);
+BENCHMARK_TEMPLATE(deserializeInto, Finish);
+BENCHMARK_TEMPLATE(deserializeInto, Station);
+BENCHMARK_TEMPLATE(deserializeInto, Synchro);
+
+static void encodeBuffers(benchmark::State &state)
+{
+    Data data;
+    data.setPayload(string(state.range(0), 'd'));
+    size_t frames = 0;
+    size_t size = 0;
+    for (auto _ : state)
+    {
+        auto &&buffers = encode(&data);
+        frames = buffers.size();
+        size = getSize(buffers);
+        benchmark::DoNotOptimize(buffers);
+    }
+    setRates(state, frames, size);
+}
+BENCHMARK(encodeBuffers)->Arg(DATA_SIZES[0])->Arg(DATA_SIZES[1])->Arg(DATA_SIZES[2]);
+
+static void encodeIntoBuffer(benchmark::State &state)
+{
+    Data data;
+    data.setPayload(string(state.range(0), 'd'));
+    uint8_t out[HEAD_MAX_FRAMES * HEAD_MAX_FRAME_SIZE];
+    EncodedFrames frames;
+    for (auto _ : state)
+    {
+        frames = encodeInto(data, out, sizeof(out));
+        benchmark::DoNotOptimize(out);
+    }
+    setRates(state, frames.count, frames.size);
+}
+BENCHMARK(encodeIntoBuffer)->Arg(DATA_SIZES[0])->Arg(DATA_SIZES[1])->Arg(DATA_SIZES[2]);
+
+static void encodeMessage(benchmark::State &state)
+{
+    Data data;
+    data.setPayload(string(state.range(0), 'd'));
+    size_t frames = 0;
+    size_t size = 0;
+    for (auto _ : state)
+    {
+        auto &&message = encodeMessage(data);
+        frames = message.getCount();
+        size = message.getBytes().size;
+        benchmark::DoNotOptimize(message);
+    }
+    setRates(state, frames, size);
+}
+BENCHMARK(encodeMessage)->Arg(DATA_SIZES[0])->Arg(DATA_SIZES[1])->Arg(DATA_SIZES[2]);
+
+static void streamEncoder(benchmark::State &state)
+{
+    Data data;
+    data.setPayload(string(state.range(0), 'd'));
+    StreamEncoder encoder;
+    size_t frames = 0;
+    size_t size = 0;
+    for (auto _ : state)
+    {
+        frames = 0;
+        size = 0;
+        if (encoder.start(data) != ErrorCode::OK)
+        {
+            state.SkipWithError("start");
+            break;
+        }
+        for (auto frame = encoder.next(); !frame.empty(); frame = encoder.next())
+        {
+            benchmark::DoNotOptimize(frame.data);
+            frames++;
+            size += frame.size;
+        }
+    }
+    setRates(state, frames, size);
+}
+BENCHMARK(streamEncoder)->Arg(DATA_SIZES[0])->Arg(DATA_SIZES[1])->Arg(DATA_SIZES[2]);
+
+static void encodeAdoptedPayload(benchmark::State &state)
+{
+    string payload(state.range(0), 'd');
+    Data data;
+    uint8_t out[HEAD_MAX_FRAMES * HEAD_MAX_FRAME_SIZE];
+    EncodedFrames frames;
+    for (auto _ : state)
+    {
+        //buffer filled by caller and given to package
+        unique_ptr<uint8_t[]> buffer(new uint8_t[payload.size()]);
+        memcpy(buffer.get(), payload.data(), payload.size());
+        data.adoptPayload(move(buffer), payload.size());
+        frames = encodeInto(data, out, sizeof(out));
+        benchmark::DoNotOptimize(out);
+    }
+    setRates(state, frames.count, frames.size);
+}
+BENCHMARK(encodeAdoptedPayload)->Arg(DATA_SIZES[0])->Arg(DATA_SIZES[1])->Arg(DATA_SIZES[2]);
+
+#ifdef HGARDENPI_PROTOCOL_SCATTER
+static void encodeScatter(benchmark::State &state)
+{
+    Data data;
+    data.setPayload(string(state.range(0), 'd'));
+    static ScatterFrames frames;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tryEncodeScatter(data, NOT_SET, frames));
+        benchmark::ClobberMemory();
+    }
+    setRates(state, frames.count, frames.size);
+}
+BENCHMARK(encodeScatter)->Arg(DATA_SIZES[0])->Arg(DATA_SIZES[1])->Arg(DATA_SIZES[2]);
+#endif
+
+template<typename C>
+static void encodeChecksum(benchmark::State &state)
+{
+    Data data;
+    data.setPayload(string(DATA_SIZES[2], 'd'));
+    uint8_t out[HEAD_MAX_FRAMES * (HEAD_MAX_FRAME_SIZE + HEAD_MAX_CHECKSUM_SIZE)];
+    size_t frames = 0;
+    size_t size = 0;
+    for (auto _ : state)
+    {
+        auto &&ret = tryEncodeInto<C>(data, NOT_SET, out, sizeof(out));
+        benchmark::DoNotOptimize(out);
+        frames = ret->count;
+        size = ret->size;
+    }
+    setRates(state, frames, size);
+}
+BENCHMARK_TEMPLATE(encodeChecksum, Crc16Checksum);
+BENCHMARK_TEMPLATE(encodeChecksum, ModbusChecksum);
+BENCHMARK_TEMPLATE(encodeChecksum, CcittChecksum);
+BENCHMARK_TEMPLATE(encodeChecksum, Crc32Checksum);
+BENCHMARK_TEMPLATE(encodeChecksum, NoChecksum);
+BENCHMARK_TEMPLATE(encodeChecksum, Crc32cChecksum);
+
+template<typename C>
+static void viewChecksum(benchmark::State &state)
+{
+    Data data;
+    data.setPayload(string(DATA_SIZES[2], 'd'));
+    uint8_t out[HEAD_MAX_FRAMES * (HEAD_MAX_FRAME_SIZE + HEAD_MAX_CHECKSUM_SIZE)];
+    auto &&frames = tryEncodeInto<C>(data, NOT_SET, out, sizeof(out));
+    for (auto _ : state)
+    {
+        for (uint8_t i = 0; i < frames->count; i++)
+        {
+            benchmark::DoNotOptimize(tryView<C>(&out[frames->offsets[i]], frames->getFrameSize(i)));
+        }
+    }
+    setRates(state, frames->count, frames->size);
+}
+BENCHMARK_TEMPLATE(viewChecksum, Crc16Checksum);
+BENCHMARK_TEMPLATE(viewChecksum, ModbusChecksum);
+BENCHMARK_TEMPLATE(viewChecksum, CcittChecksum);
+BENCHMARK_TEMPLATE(viewChecksum, Crc32Checksum);
+BENCHMARK_TEMPLATE(viewChecksum, NoChecksum);
+BENCHMARK_TEMPLATE(viewChecksum, Crc32cChecksum);
+
+static void decodeFrames(benchmark::State &state)
+{
+    auto &&buffers = encodeData(state.range(0));
+    for (auto _ : state)
+    {
+        for (auto &&it : buffers)
+        {
+            benchmark::DoNotOptimize(decode(it));
+        }
+    }
+    setRates(state, buffers.size(), getSize(buffers));
+}
+BENCHMARK(decodeFrames)->Arg(DATA_SIZES[0])->Arg(DATA_SIZES[1])->Arg(DATA_SIZES[2]);
+
+static void viewFrames(benchmark::State &state)
+{
+    auto &&buffers = encodeData(state.range(0));
+    for (auto _ : state)
+    {
+        for (auto &&it : buffers)
+        {
+            benchmark::DoNotOptimize(view(it));
+        }
+    }
+    setRates(state, buffers.size(), getSize(buffers));
+}
+BENCHMARK(viewFrames)->Arg(DATA_SIZES[0])->Arg(DATA_SIZES[1])->Arg(DATA_SIZES[2]);
+
+static void peekFrames(benchmark::State &state)
+{
+    auto &&buffers = encodeData(state.range(0));
+    for (auto _ : state)
+    {
+        for (auto &&it : buffers)
+        {
+            benchmark::DoNotOptimize(tryPeek(it.first.get(), it.second));
+        }
+    }
+    setRates(state, buffers.size(), getSize(buffers));
+}
+BENCHMARK(peekFrames)->Arg(DATA_SIZES[0])->Arg(DATA_SIZES[1])->Arg(DATA_SIZES[2]);
+
+static void viewBatch(benchmark::State &state)
+{
+    Data data;
+    data.setPayload(string(state.range(0), 'd'));
+    uint8_t out[HEAD_MAX_FRAMES * HEAD_MAX_FRAME_SIZE];
+    auto frames = encodeInto(data, out, sizeof(out));
+    HeadView views[HEAD_MAX_FRAMES];
+    size_t count = 0;
+    size_t consumed = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tryViewBatch(out, frames.size, views, HEAD_MAX_FRAMES, count, consumed));
+        benchmark::DoNotOptimize(views);
+    }
+    setRates(state, frames.count, frames.size);
+}
+BENCHMARK(viewBatch)->Arg(DATA_SIZES[0])->Arg(DATA_SIZES[1])->Arg(DATA_SIZES[2]);
+
+static void composeDecodedChunks(benchmark::State &state)
+{
+    auto &&buffers = encodeData(state.range(0));
+    Heads heads;
+    for (auto &&it : buffers)
+    {
+        heads.push_back(decode(it));
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(composeDecodedChunks(heads));
+    }
+    setRates(state, buffers.size(), getSize(buffers));
+}
+BENCHMARK(composeDecodedChunks)->Arg(DATA_SIZES[0])->Arg(DATA_SIZES[1])->Arg(DATA_SIZES[2]);
+
+static void updateIdToBufferEncoded(benchmark::State &state)
+{
+    auto &&buffers = encodeData(state.range(0));
+    uint8_t id = 0;
+    for (auto _ : state)
+    {
+        updateIdToBufferEncoded(buffers, id++);
+        benchmark::DoNotOptimize(buffers);
+    }
+    setRates(state, buffers.size(), getSize(buffers));
+}
+BENCHMARK(updateIdToBufferEncoded)->Arg(DATA_SIZES[0])->Arg(DATA_SIZES[1])->Arg(DATA_SIZES[2]);
+
+static void reassemblerInterleaved(benchmark::State &state)
+{
+    const auto sources = static_cast<uint16_t>(state.range(0));
+    Data data;
+    data.setPayload(string(HEAD_MAX_PAYLOAD_SIZE * 4, 'd'));
+    auto &&frames = encode(&data);
+    vector<HeadView> views;
+    for (auto &&it : frames)
+    {
+        views.push_back(view(it));
+    }
+
+    //all sources have a partial package at the same time
+    Reassembler reassembler(sources, 1000);
+    for (auto _ : state)
+    {
+        for (auto &&frame : views)
+        {
+            for (uint32_t source = 0; source < sources; source++)
+            {
+                benchmark::DoNotOptimize(reassembler.push(source, frame));
+            }
+        }
+    }
+    setRates(state, views.size() * sources, getSize(frames) * sources);
+}
+BENCHMARK(reassemblerInterleaved)->Arg(1)->Arg(256);
+
+/**
+ * @brief Bytes moved by transfer benchmarks, configuration bundles and firmware images
+ */
+static constexpr const int64_t TRANSFER_SIZES[] = {64 * 1024, 1024 * 1024};
+
+static void transferChunked(benchmark::State &state)
+{
+    //ceiling of chunked packages: data split in Data of HEAD_MAX_CHUNK chunks
+    constexpr size_t slice = DATA_SIZES[2];
+    vector<uint8_t> data(state.range(0), 'd');
+    vector<uint8_t> received(data.size());
+    uint8_t out[HEAD_MAX_FRAMES * HEAD_MAX_FRAME_SIZE];
+    BytesView chunks[HEAD_MAX_FRAMES];
+    size_t frames = 0;
+    Data package;
+    for (auto _ : state)
+    {
+        frames = 0;
+        for (size_t offset = 0; offset < data.size(); offset += slice)
+        {
+            uint16_t size = data.size() - offset < slice ? data.size() - offset : slice;
+            package.setPayload(&data[offset], size);
+            auto &&encoded = tryEncodeInto(package, NOT_SET, out, sizeof(out));
+            uint8_t count = 0;
+            for (uint8_t i = 0; i < encoded->count; i++)
+            {
+                auto &&head = tryView(&out[encoded->offsets[i]], encoded->getFrameSize(i));
+                if (!(head->flags & FIN))
+                {
+                    chunks[count++] = head->payload;
+                }
+            }
+            auto &&composed = tryComposeChunks(encoded->count > 1 ? DAT | CKN : DAT, chunks, count);
+            auto view = static_cast<Data *>(composed->second.get())->getPayloadView();
+            memcpy(&received[offset], view.data, view.size);
+            frames += encoded->count;
+        }
+        benchmark::DoNotOptimize(received.data());
+    }
+    setRates(state, frames, data.size());
+}
+BENCHMARK(transferChunked)->Arg(TRANSFER_SIZES[0])->Arg(TRANSFER_SIZES[1]);
+
+static void transferBulk(benchmark::State &state)
+{
+    vector<uint8_t> data(state.range(0), 'd');
+    vector<uint8_t> received(data.size());
+    size_t frames = 0;
+    for (auto _ : state)
+    {
+        frames = 0;
+        BulkSender sender(1);
+        BulkReceiver receiver(1);
+        if (sender.start(data.data(), data.size()) != ErrorCode::OK)
+        {
+            state.SkipWithError("start");
+            break;
+        }
+        while (!sender.isComplete())
+        {
+            auto frame = sender.next();
+            if (frame.empty())
+            {
+                sender.rewind();
+                continue;
+            }
+            frames++;
+            auto &&head = tryView(frame.data, frame.size);
+            uint32_t offset = receiver.getOffset();
+            auto &&bytes = receiver.receive(*head);
+            memcpy(&received[offset], bytes->data, bytes->size);
+            if (receiver.hasAcknowledge())
+            {
+                auto ack = receiver.acknowledge();
+                (void) sender.acknowledge(*tryView(ack.data, ack.size));
+            }
+        }
+        benchmark::DoNotOptimize(received.data());
+    }
+    setRates(state, frames, data.size());
+}
+BENCHMARK(transferBulk)->Arg(TRANSFER_SIZES[0])->Arg(TRANSFER_SIZES[1]);
+
+/**
+ * @brief Transfer packages on a simulated link of one frame per tick for direction with delay, range(0) is window,
+ * range(1) lose one frame every range(1) (0 none), ticks counter is time of link, stop-and-wait is window 1
+ */
+static void transportLossyLink(benchmark::State &state)
+{
+    constexpr const size_t PACKAGES = 64;
+    constexpr const uint32_t DELAY = 4;
+    Data data;
+    data.setPayload(string(DATA_SIZES[1], 'd'));
+    size_t frames = 0;
+    uint32_t ticks = 0;
+    for (auto _ : state)
+    {
+        Transport sender(state.range(0), DELAY * 4);
+        Transport receiver(state.range(0), DELAY * 4);
+        vector<pair<uint32_t, vector<uint8_t>>> forward;
+        vector<pair<uint32_t, vector<uint8_t>>> backward;
+        size_t written = 0;
+        size_t popped = 0;
+        for (size_t i = 0; i < PACKAGES; i++)
+        {
+            (void) sender.send(data);
+        }
+        uint32_t now = 0;
+        for (; !sender.isIdle() || popped < PACKAGES; now++)
+        {
+            auto write = [&](Transport &from, vector<pair<uint32_t, vector<uint8_t>>> &link)
+            {
+                auto frame = from.poll(now);
+                if (!frame.empty() && (state.range(1) == 0 || ++written % state.range(1) != 0))
+                {
+                    link.emplace_back(now + DELAY, vector<uint8_t>(frame.begin(), frame.end()));
+                }
+            };
+            auto read = [&](vector<pair<uint32_t, vector<uint8_t>>> &link, Transport &to)
+            {
+                size_t i = 0;
+                for (; i < link.size() && link[i].first <= now; i++)
+                {
+                    (void) to.receive(link[i].second.data(), link[i].second.size(), now);
+                }
+                link.erase(link.begin(), link.begin() + i);
+            };
+            write(sender, forward);
+            write(receiver, backward);
+            read(forward, receiver);
+            read(backward, sender);
+            for (auto &&package = receiver.pop(); package && package->second; package = receiver.pop())
+            {
+                popped++;
+            }
+        }
+        frames = sender.getStatistics().sent + sender.getStatistics().retransmitted;
+        ticks = now;
+    }
+    setRates(state, frames, PACKAGES * DATA_SIZES[1]);
+    state.counters["ticks"] = ticks;
+}
+BENCHMARK(transportLossyLink)->Args({1, 0})->Args({16, 0})->Args({1, 20})->Args({16, 20})->Args({16, 5});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,334 @@
+// MIT License
+//
+// Copyright (c) 2021. Happy GardenPI
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <hgardenpi-protocol/constants.hpp>
+#include <hgardenpi-protocol/checksum.hpp>
+#include <hgardenpi-protocol/head.hpp>
+#include <hgardenpi-protocol/result.hpp>
+
+namespace hgardenpi::protocol
+{
+    inline namespace v2
+    {
+
+        /**
+         * @brief size of offset at start of payload of bulk frames
+         */
+        constexpr const inline uint8_t BULK_OFFSET_SIZE = sizeof(uint32_t);
+
+        /**
+         * @brief max bytes of data in one bulk frame
+         */
+        constexpr const inline uint8_t BULK_MAX_DATA = HEAD_MAX_PAYLOAD_SIZE - BULK_OFFSET_SIZE;
+
+        /**
+         * @brief default frames sent before wait an acknowledge
+         */
+        constexpr const inline uint16_t BULK_DEFAULT_WINDOW = 32;
+
+        /**
+         * @brief status byte of acknowledge: data received in order up to offset
+         */
+        constexpr const inline uint8_t BULK_ACK_RECEIVED = 0;
+
+        /**
+         * @brief status byte of acknowledge: a frame is missed, send again from offset
+         */
+        constexpr const inline uint8_t BULK_ACK_RESEND = 1;
+
+        /**
+         * @brief status byte of acknowledge: all data up to total size are received
+         */
+        constexpr const inline uint8_t BULK_ACK_COMPLETE = 2;
+
+        /**
+         * @brief Sender of a bulk transfer, data up to 4 GB are sent without HEAD_MAX_CHUNK limit in frames
+         * with 32 bits offset, a window of frames is sent before wait an acknowledge of receiver
+         * @note frames of session are BLK, never chunked, so they are not taken for packages on a shared link,
+         * and have Head::id of session: payload is offset little endian followed by data, a frame without data
+         * with total size close transfer; receiver answer with BLK | ACK with offset of next byte expected and a
+         * status byte BULK_ACK_RECEIVED, BULK_ACK_RESEND or BULK_ACK_COMPLETE
+         * @note frames not acknowledged in timeout are sent again by poll(), next() has no timer and leaves
+         * retransmission to caller with rewind()
+         * @note no allocation is done, data must live until transfer is complete
+         */
+        class BulkSender final
+        {
+        public:
+
+            /**
+             * @brief Construct a sender
+             * @param id of session, Head::id of all frames
+             * @param window max frames sent and not acknowledged
+             * @param timeout ticks without progress of receiver before send again frames not acknowledged by poll()
+             * @param checksum of frames, receiver must have the same
+             */
+            explicit BulkSender(uint8_t id, uint16_t window = BULK_DEFAULT_WINDOW, uint32_t timeout = 1000,
+                                ChecksumType checksum = ChecksumType::CRC16) noexcept;
+
+            /**
+             * @brief Start or resume a transfer
+             * @param data to send
+             * @param size of data
+             * @param offset first byte to send, to resume a transfer from offset acknowledged by receiver
+             * @return error if offset is out of data
+             */
+            [[nodiscard]] ErrorCode start(const uint8_t *data, uint32_t size, uint32_t offset = 0) noexcept;
+
+            /**
+             * @brief Generate next frame to send, frames not acknowledged are sent again after timeout
+             * @param now current tick, in the same unit of timeout, it can wrap
+             * @return frame or empty view if window is full or all frames are sent, frame is valid until the
+             * next call
+             */
+            [[nodiscard]] BytesView poll(uint32_t now) noexcept;
+
+            /**
+             * @brief Generate next frame to send without retransmission timer
+             * @return frame or empty view if window is full or all frames are sent, frame is valid until the
+             * next call
+             * @note if acknowledges can be lost caller must call rewind() when none arrive in time, otherwise
+             * transfer stops with window full
+             */
+            [[nodiscard]] BytesView next() noexcept;
+
+            /**
+             * @brief Process an acknowledge of receiver, window is moved and frames are sent again from its
+             * offset if receiver ask it
+             * @param frame received
+             * @return error if frame is not an acknowledge of session
+             */
+            [[nodiscard]] ErrorCode acknowledge(const HeadView &frame) noexcept;
+
+            /**
+             * @brief Send again all frames not acknowledged, eg. when acknowledge timeout, poll() call it by itself
+             */
+            void rewind() noexcept;
+
+            /**
+             * @brief Check if receiver has all data
+             * @return true if end of transfer is acknowledged
+             */
+            [[nodiscard]] inline bool isComplete() const noexcept
+            {
+                return complete;
+            }
+
+            /**
+             * @brief Get bytes acknowledged by receiver
+             * @return offset to resume transfer
+             */
+            [[nodiscard]] inline uint32_t getAcknowledged() const noexcept
+            {
+                return acknowledged;
+            }
+
+        private:
+
+            /**
+             * @brief frame generated
+             */
+            uint8_t buffer[HEAD_HEADER_SIZE + HEAD_MAX_PAYLOAD_SIZE + HEAD_MAX_CHECKSUM_SIZE] = {};
+
+            /**
+             * @brief data to send
+             */
+            const uint8_t *data = nullptr;
+
+            /**
+             * @brief size of data
+             */
+            uint32_t size = 0;
+
+            /**
+             * @brief offset of next byte to send
+             */
+            uint32_t sent = 0;
+
+            /**
+             * @brief offset of next byte expected by receiver
+             */
+            uint32_t acknowledged = 0;
+
+            /**
+             * @brief ticks without progress of receiver before retransmission
+             */
+            uint32_t timeout = 0;
+
+            /**
+             * @brief tick of retransmission
+             */
+            uint32_t deadline = 0;
+
+            /**
+             * @brief max frames not acknowledged
+             */
+            uint16_t window = 0;
+
+            /**
+             * @brief Head::id of frames
+             */
+            uint8_t id = 0;
+
+            /**
+             * @brief checksum of frames
+             */
+            ChecksumType checksum = ChecksumType::CRC16;
+
+            /**
+             * @brief frame without data sent
+             */
+            bool finished = false;
+
+            /**
+             * @brief end of transfer acknowledged
+             */
+            bool complete = false;
+
+            /**
+             * @brief receiver acknowledged new bytes since last poll()
+             */
+            bool progress = false;
+        };
+
+        /**
+         * @brief Receiver of a bulk transfer of BulkSender, data are returned in order and acknowledged every
+         * half window, on a gap it ask to send again from the first byte missed
+         * @note no allocation is done
+         */
+        class BulkReceiver final
+        {
+        public:
+
+            /**
+             * @brief Construct a receiver
+             * @param id of session, Head::id of all frames
+             * @param window frames sent by sender before wait an acknowledge
+             * @param offset bytes already received, to resume a transfer
+             * @param checksum of acknowledges, sender must have the same
+             * @note frames of sender are checked by caller with the same checksum, eg. StreamDecoder or tryView()
+             */
+            explicit BulkReceiver(uint8_t id, uint16_t window = BULK_DEFAULT_WINDOW, uint32_t offset = 0,
+                                  ChecksumType checksum = ChecksumType::CRC16) noexcept;
+
+            /**
+             * @brief Receive a frame of session
+             * @param frame received
+             * @return data to append at getOffset() before the call, empty if frame is duplicated, out of order
+             * or end of transfer, or error if frame is not of session
+             */
+            [[nodiscard]] Result<BytesView> receive(const HeadView &frame) noexcept;
+
+            /**
+             * @brief Check if an acknowledge must be sent
+             * @return true if acknowledge() has to be called
+             */
+            [[nodiscard]] inline bool hasAcknowledge() const noexcept
+            {
+                return pending;
+            }
+
+            /**
+             * @brief Generate acknowledge of bytes received, it can be sent any time eg. to resume a transfer
+             * @return frame valid until the next call
+             */
+            [[nodiscard]] BytesView acknowledge() noexcept;
+
+            /**
+             * @brief Get bytes received in order
+             * @return offset of next byte expected
+             */
+            [[nodiscard]] inline uint32_t getOffset() const noexcept
+            {
+                return offset;
+            }
+
+            /**
+             * @brief Check if all data are received
+             * @return true if end of transfer is received after all data
+             */
+            [[nodiscard]] inline bool isComplete() const noexcept
+            {
+                return complete;
+            }
+
+        private:
+
+            /**
+             * @brief acknowledge generated
+             */
+            uint8_t buffer[HEAD_HEADER_SIZE + BULK_OFFSET_SIZE + 1 + HEAD_MAX_CHECKSUM_SIZE] = {};
+
+            /**
+             * @brief offset of next byte expected
+             */
+            uint32_t offset = 0;
+
+            /**
+             * @brief frames received since last acknowledge
+             */
+            uint16_t received = 0;
+
+            /**
+             * @brief frames received before acknowledge
+             */
+            uint16_t threshold = 0;
+
+            /**
+             * @brief Head::id of frames
+             */
+            uint8_t id = 0;
+
+            /**
+             * @brief checksum of acknowledges
+             */
+            ChecksumType checksum = ChecksumType::CRC16;
+
+            /**
+             * @brief acknowledge to send
+             */
+            bool pending = false;
+
+            /**
+             * @brief a gap is detected, sender is asked to send again from offset
+             */
+            bool resend = false;
+
+            /**
+             * @brief resend asked for current gap
+             */
+            bool gap = false;
+
+            /**
+             * @brief end of transfer received after all data
+             */
+            bool complete = false;
+        };
+
+    }
+}
@@ -0,0 +1,270 @@
+// MIT License
+//
+// Copyright (c) 2021. Happy GardenPI
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <hgardenpi-protocol/constants.hpp>
+#include <hgardenpi-protocol/utilities/crcutils.hpp>
+
+namespace hgardenpi::protocol
+{
+    inline namespace v2
+    {
+
+        /**
+         * @brief Checksum of frames of a link, agreed by the peers of link
+         */
+        enum class ChecksumType : uint8_t
+        {
+            /**
+             * @brief crc16 of libcrc crc_16(), default
+             */
+            CRC16 = 0,
+            /**
+             * @brief crc16 Modbus, the crc16 of CRC16 started from 0xFFFF, same result of libcrc crc_modbus()
+             */
+            MODBUS,
+            /**
+             * @brief CRC-CCITT of libcrc crc_ccitt_ffff()
+             */
+            CCITT,
+            /**
+             * @brief CRC32 (IEEE 802.3) of crc32() in crcutils, for noisy links
+             */
+            CRC32,
+            /**
+             * @brief no checksum, for links with their integrity check eg. TCP or Unix sockets
+             */
+            NONE,
+            /**
+             * @brief CRC32C (Castagnoli) calculated by crc32 instructions of cpu, for fast local links
+             */
+            CRC32C,
+        };
+
+        /**
+         * @brief max size of checksum after payload
+         */
+        constexpr const inline uint8_t HEAD_MAX_CHECKSUM_SIZE = sizeof(uint32_t);
+
+        /**
+         * @brief Checksum policy crc16, written little endian after payload as all policies
+         * @note a policy has TYPE, SIZE in bytes, START value and calculate() of bytes split in more buffers, head
+         * is the same for all policies so both peers of a link must agree on it
+         */
+        struct Crc16Checksum final
+        {
+            static constexpr const ChecksumType TYPE = ChecksumType::CRC16;
+
+            static constexpr const uint8_t SIZE = HEAD_CRC_SIZE;
+
+            static constexpr const uint32_t START = 0;
+
+
+            [[nodiscard]] static inline uint32_t calculate(const uint8_t *data, size_t size, uint32_t crc = START) noexcept
+            {
+                return crc16(data, size, static_cast<uint16_t>(crc));
+            }
+        };
+
+        /**
+         * @brief Checksum policy crc16 Modbus
+         * @note it calls the same crc16() of Crc16Checksum, they differ only in START: 0xFFFF instead of 0
+         */
+        struct ModbusChecksum final
+        {
+            static constexpr const ChecksumType TYPE = ChecksumType::MODBUS;
+
+            static constexpr const uint8_t SIZE = sizeof(uint16_t);
+
+            static constexpr const uint32_t START = 0xFFFF;
+
+
+            [[nodiscard]] static inline uint32_t calculate(const uint8_t *data, size_t size, uint32_t crc = START) noexcept
+            {
+                return crc16(data, size, static_cast<uint16_t>(crc));
+            }
+        };
+
+        /**
+         * @brief Checksum policy CRC-CCITT
+         */
+        struct CcittChecksum final
+        {
+            static constexpr const ChecksumType TYPE = ChecksumType::CCITT;
+
+            static constexpr const uint8_t SIZE = sizeof(uint16_t);
+
+            static constexpr const uint32_t START = 0xFFFF;
+
+
+            [[nodiscard]] static inline uint32_t calculate(const uint8_t *data, size_t size, uint32_t crc = START) noexcept
+            {
+                return crcCcitt(data, size, static_cast<uint16_t>(crc));
+            }
+        };
+
+        /**
+         * @brief Checksum policy CRC32 (IEEE 802.3), calculated by crc32() in crcutils
+         */
+        struct Crc32Checksum final
+        {
+            static constexpr const ChecksumType TYPE = ChecksumType::CRC32;
+
+            static constexpr const uint8_t SIZE = sizeof(uint32_t);
+
+            static constexpr const uint32_t START = 0;
+
+
+            [[nodiscard]] static inline uint32_t calculate(const uint8_t *data, size_t size, uint32_t crc = START) noexcept
+            {
+                return crc32(data, size, crc);
+            }
+        };
+
+        /**
+         * @brief Checksum policy without checksum, frames end after payload
+         */
+        struct NoChecksum final
+        {
+            static constexpr const ChecksumType TYPE = ChecksumType::NONE;
+
+            static constexpr const uint8_t SIZE = 0;
+
+            static constexpr const uint32_t START = 0;
+
+
+            [[nodiscard]] static inline uint32_t calculate(const uint8_t *, size_t, uint32_t = START) noexcept
+            {
+                return START;
+            }
+        };
+
+        /**
+         * @brief Checksum policy CRC32C, hardware accelerated when cpu support it
+         */
+        struct Crc32cChecksum final
+        {
+            static constexpr const ChecksumType TYPE = ChecksumType::CRC32C;
+
+            static constexpr const uint8_t SIZE = sizeof(uint32_t);
+
+            static constexpr const uint32_t START = 0;
+
+
+            [[nodiscard]] static inline uint32_t calculate(const uint8_t *data, size_t size, uint32_t crc = START) noexcept
+            {
+                return crc32c(data, size, crc);
+            }
+        };
+
+        /**
+         * @brief Call a function with the checksum policy of a link
+         * @param checksum of link, CRC16 for values not known
+         * @param function called with an instance of policy
+         * @return value returned by function
+         */
+        template<typename F>
+        inline auto withChecksum(ChecksumType checksum, F &&function)
+        {
+            switch (checksum)
+            {
+                case ChecksumType::MODBUS:
+                    return function(ModbusChecksum());
+                case ChecksumType::CCITT:
+                    return function(CcittChecksum());
+                case ChecksumType::CRC32:
+                    return function(Crc32Checksum());
+                case ChecksumType::NONE:
+                    return function(NoChecksum());
+                case ChecksumType::CRC32C:
+                    return function(Crc32cChecksum());
+                default:
+                    return function(Crc16Checksum());
+            }
+        }
+
+        /**
+         * @brief Get size of checksum of a link
+         * @param checksum of link
+         * @return bytes after payload
+         */
+        [[nodiscard]] inline uint8_t getChecksumSize(ChecksumType checksum) noexcept
+        {
+            return withChecksum(checksum, [](auto policy)
+            {
+                return decltype(policy)::SIZE;
+            });
+        }
+
+        /**
+         * @brief Write checksum of a link little endian after data
+         * @param checksum of link
+         * @param data head and payload of frame, followed by room for checksum
+         * @param size of head and payload
+         * @return bytes of checksum written
+         */
+        inline uint8_t fillChecksum(ChecksumType checksum, uint8_t *data, size_t size) noexcept
+        {
+            return withChecksum(checksum, [data, size](auto policy)
+            {
+                using C = decltype(policy);
+                uint32_t value = C::calculate(data, size);
+                for (uint8_t i = 0; i < C::SIZE; i++)
+                {
+                    data[size + i] = static_cast<uint8_t>(value >> (i * 8));
+                }
+                return C::SIZE;
+            });
+        }
+
+        /**
+         * @brief Check checksum of a link of a complete frame
+         * @param checksum of link
+         * @param frame to check
+         * @param size of frame, checksum included
+         * @return true if checksum match, false also if frame is shorter than checksum
+         */
+        [[nodiscard]] inline bool checkChecksum(ChecksumType checksum, const uint8_t *frame, size_t size) noexcept
+        {
+            return withChecksum(checksum, [frame, size](auto policy)
+            {
+                using C = decltype(policy);
+                if (size < C::SIZE)
+                {
+                    return false;
+                }
+                const size_t length = size - C::SIZE;
+                uint32_t value = 0;
+                for (uint8_t i = 0; i < C::SIZE; i++)
+                {
+                    value |= static_cast<uint32_t>(frame[length + i]) << (i * 8);
+                }
+                return C::calculate(frame, length) == value;
+            });
+        }
+    }
+}
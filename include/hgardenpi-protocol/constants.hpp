@@ -31,6 +31,7 @@
 #include <cstdint>
 #include <utility>
 #include <memory>
+#include <memory_resource>
 #include <vector>
 
 namespace hgardenpi::protocol
@@ -41,6 +42,47 @@ namespace hgardenpi::protocol
         typedef std::pair<std::shared_ptr<uint8_t []>, uint16_t> Buffer;
         typedef std::vector<Buffer> Buffers;
 
+        /**
+         * @brief Buffers allocated in a memory resource
+         */
+        typedef std::pmr::vector<Buffer> PmrBuffers;
+
+        /**
+         * @brief Non owning view of a sequence of bytes
+         */
+        struct BytesView final
+        {
+            /**
+             * @brief first byte
+             */
+            const uint8_t *data = nullptr;
+
+            /**
+             * @brief number of bytes
+             */
+            size_t size = 0;
+
+            [[nodiscard]] inline const uint8_t *begin() const noexcept
+            {
+                return data;
+            }
+
+            [[nodiscard]] inline const uint8_t *end() const noexcept
+            {
+                return data + size;
+            }
+
+            [[nodiscard]] inline bool empty() const noexcept
+            {
+                return size == 0;
+            }
+
+            [[nodiscard]] inline uint8_t operator[](size_t i) const noexcept
+            {
+                return data[i];
+            }
+        };
+
         /**
          * Flags used in Head
          */
@@ -79,6 +121,12 @@ namespace hgardenpi::protocol
              * @note check before syn and crt
              */
             ERR = 0x03,
+            /**
+             * @brief Bulk transfer frame of BulkSender and BulkReceiver, it is not a package and it is never chunked
+             * @note this flag can contain only one flag/package
+             * @note check before syn and agg
+             */
+            BLK = 0x05,
 
             //flags
             /**
@@ -144,11 +192,64 @@ namespace hgardenpi::protocol
          */
         constexpr const inline uint8_t HEAD_MAX_SERIAL_SIZE = 128;
 
+        /**
+         * @brief bytes of text fields of packages kept inline, longer values are spilled
+         */
+        constexpr const inline uint16_t HEAD_INLINE_FIELD_SIZE = 30;
+
         /**
          * @brief max heads size
          */
         constexpr const inline uint8_t HEAD_MAX_CHUNK = 16;
 
+        /**
+         * @brief size of head fields before payload: version and flags, id, length
+         */
+        constexpr const inline uint8_t HEAD_HEADER_SIZE = 3;
+
+        /**
+         * @brief size of crc16 after payload
+         */
+        constexpr const inline uint8_t HEAD_CRC_SIZE = 2;
+
+        /**
+         * @brief max size of a frame ready to send
+         */
+        constexpr const inline uint16_t HEAD_MAX_FRAME_SIZE = HEAD_HEADER_SIZE + HEAD_MAX_PAYLOAD_SIZE + HEAD_CRC_SIZE;
+
+        /**
+         * @brief max frames of one package: HEAD_MAX_CHUNK full chunks, the last chunk and FIN
+         */
+        constexpr const inline uint8_t HEAD_MAX_FRAMES = HEAD_MAX_CHUNK + 2;
+
+        /**
+         * @brief mask of flags for package type, without CKN and ACK
+         */
+        constexpr const inline uint8_t HEAD_PACKAGE_MASK = SYN | DAT | AGG | STA | FIN;
+
+        /**
+         * @brief Check flags of a head contain only one package type or BLK, or only ACK for acknowledges of Transport
+         * @param flags of head without version bit
+         * @return true if flags are valid
+         */
+        [[nodiscard]] constexpr inline bool checkFlags(uint8_t flags) noexcept
+        {
+            switch (flags & HEAD_PACKAGE_MASK)
+            {
+                case SYN:
+                case DAT:
+                case ERR:
+                case AGG:
+                case STA:
+                case FIN:
+                case BLK:
+                    return true;
+                case NOT_SET:
+                    return flags == ACK;
+                default:
+                    return false;
+            }
+        }
 
         constexpr const inline uint8_t CURRENT_PROTOCOL_ACTIVE_VERSION = 0;
 
@@ -28,8 +28,11 @@
 #pragma once
 
 #include <memory>
+#include <memory_resource>
+#include <vector>
 
 #include <hgardenpi-protocol/constants.hpp>
+#include <hgardenpi-protocol/pool.hpp>
 
 namespace hgardenpi::protocol
 {
@@ -38,6 +41,7 @@ namespace hgardenpi::protocol
         using std::shared_ptr;
 
         class Package;
+        struct HeadView;
 
         /**
          * Head of data
@@ -67,23 +71,78 @@ namespace hgardenpi::protocol
              */
             uint8_t length = 0;
             /**
-             * @brief Payload data
+             * @brief Payload data, allocated with allocateBuffer() of length bytes or new[]
              */
             uint8_t *payload = nullptr;
             /**
              * @brief CRC16 XMODEM calculate with version + flags + id + length + payload
              */
             uint16_t crc16 = 0;
+            /**
+             * @brief Memory resource where payload is allocated of length bytes, nullptr for allocateBuffer() or new[]
+             */
+            std::pmr::memory_resource *resource = nullptr;
 
             inline ~Head()
             {
                 if (payload)
                 {
-                    delete[] payload;
+                    if (resource)
+                    {
+                        resource->deallocate(payload, length, alignof(uint8_t));
+                    }
+                    else
+                    {
+                        deallocateBuffer(payload, length);
+                    }
                     payload = nullptr;
                 }
             }
 
+            /**
+             * @brief Allocate heads from pools
+             * @param size of head
+             * @return memory
+             * @throw bad_alloc if there is no memory
+             */
+            static inline void *operator new(size_t size)
+            {
+                if (auto ptr = poolAllocate(size))
+                {
+                    return ptr;
+                }
+                throw std::bad_alloc();
+            }
+
+            /**
+             * @brief Allocate heads from pools
+             * @param size of head
+             * @return memory or nullptr if there is no memory
+             */
+            static inline void *operator new(size_t size, const std::nothrow_t &) noexcept
+            {
+                return poolAllocate(size);
+            }
+
+            /**
+             * @brief Give back a head to pools
+             * @param ptr head
+             * @param size of head
+             */
+            static inline void operator delete(void *ptr, size_t size) noexcept
+            {
+                poolDeallocate(ptr, size);
+            }
+
+            /**
+             * @brief Get payload without copy
+             * @return view of payload, valid until head is alive
+             */
+            [[nodiscard]] inline BytesView getPayloadView() const noexcept
+            {
+                return {payload, payload ? length : static_cast<size_t>(0)};
+            }
+
             /**
              * @brief Return payload in HEX format
              * @return sting HEX format
@@ -97,9 +156,98 @@ namespace hgardenpi::protocol
              * @throw exception if there are some memory error
              */
             [[nodiscard]] Package * deserialize(uint8_t chunkOfPackage = 0) const;
+
+            /**
+             * @brief Deserialize from buffer to Package in a memory resource
+             * @param chunkOfPackage if package is split more set de current package
+             * @param resource where allocate package and its fields, nullptr for pools
+             * @return new instance of Package null if something goes wrong, to deallocate with Package::destroy()
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] Package * deserialize(uint8_t chunkOfPackage, std::pmr::memory_resource *resource) const;
+
+            /**
+             * @brief Deserialize a HeadView to Package without copy the frame before
+             * @param head view of received frame
+             * @param chunkOfPackage if package is split more set de current package
+             * @return new instance of Package null if something goes wrong, to deallocate
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] static Package * deserialize(const HeadView &head, uint8_t chunkOfPackage = 0);
+
+            /**
+             * @brief Deserialize a HeadView to Package in a memory resource without copy the frame before
+             * @param head view of received frame
+             * @param chunkOfPackage if package is split more set de current package
+             * @param resource where allocate package and its fields, nullptr for pools
+             * @return new instance of Package null if something goes wrong, to deallocate with Package::destroy()
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] static Package * deserialize(const HeadView &head, uint8_t chunkOfPackage, std::pmr::memory_resource *resource);
+        };
+
+        /**
+         * @brief Non owning view of a received frame, payload point inside caller buffer
+         * @note valid until caller buffer is alive
+         */
+        struct HeadView final
+        {
+            /**
+             * @brief Protocol version
+             */
+            uint8_t version = 0x00;
+            /**
+             * @brief Flags of transmission
+             */
+            uint8_t flags = NOT_SET;
+            /**
+             * @brief Transmission id
+             */
+            uint8_t id = 0;
+            /**
+             * @brief Data length
+             */
+            uint8_t length = 0;
+            /**
+             * @brief Payload data inside caller buffer
+             */
+            BytesView payload;
+            /**
+             * @brief CRC16 XMODEM calculate with version + flags + id + length + payload, or checksum of 16 bits of
+             * link, 0 for checksum of other sizes
+             */
+            uint16_t crc16 = 0;
+
+            /**
+             * @brief Deserialize to Package
+             * @param chunkOfPackage if package is split more set de current package
+             * @return new instance of Package null if something goes wrong, to deallocate
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] inline Package * deserialize(uint8_t chunkOfPackage = 0) const
+            {
+                return Head::deserialize(*this, chunkOfPackage);
+            }
+
+            /**
+             * @brief Deserialize to Package in a memory resource
+             * @param chunkOfPackage if package is split more set de current package
+             * @param resource where allocate package and its fields, nullptr for pools
+             * @return new instance of Package null if something goes wrong, to deallocate with Package::destroy()
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] inline Package * deserialize(uint8_t chunkOfPackage, std::pmr::memory_resource *resource) const
+            {
+                return Head::deserialize(*this, chunkOfPackage, resource);
+            }
         };
 
         typedef std::vector<Head::Ptr> Heads;
+
+        /**
+         * @brief Heads allocated in a memory resource
+         */
+        typedef std::pmr::vector<Head::Ptr> PmrHeads;
 #pragma pack(pop)
     }
 }
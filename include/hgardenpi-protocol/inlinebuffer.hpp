@@ -0,0 +1,264 @@
+// MIT License
+//
+// Copyright (c) 2021. Happy GardenPI
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <memory_resource>
+#include <new>
+
+namespace hgardenpi::protocol
+{
+    inline namespace v2
+    {
+
+        /**
+         * @brief Storage of a text field of a package, values up to N bytes are kept inline and longer values
+         * spill to new[] or to a memory resource
+         * @note length of value is kept by the package, the buffer know only its capacity
+         */
+        template<uint16_t N>
+        class InlineBuffer final
+        {
+            static_assert(N >= sizeof(char *) + sizeof(std::pmr::memory_resource *), "inline storage must contain spilled storage");
+
+        public:
+
+            InlineBuffer() noexcept = default;
+
+            inline InlineBuffer(const InlineBuffer &other) : InlineBuffer()
+            {
+                copy(other);
+            }
+
+            inline InlineBuffer(InlineBuffer &&other) noexcept : InlineBuffer()
+            {
+                move(other);
+            }
+
+            inline ~InlineBuffer() noexcept
+            {
+                release();
+            }
+
+            inline InlineBuffer &operator=(const InlineBuffer &other)
+            {
+                if (this != &other)
+                {
+                    copy(other);
+                }
+                return *this;
+            }
+
+            inline InlineBuffer &operator=(InlineBuffer &&other) noexcept
+            {
+                if (this != &other)
+                {
+                    release();
+                    move(other);
+                }
+                return *this;
+            }
+
+            /**
+             * @brief Get storage
+             * @return inline storage or spilled one, never nullptr
+             */
+            [[nodiscard]] inline char *data() noexcept
+            {
+                return isInline() ? storage : getSpill().data;
+            }
+
+            /**
+             * @brief Get storage
+             * @return inline storage or spilled one, never nullptr
+             */
+            [[nodiscard]] inline const char *data() const noexcept
+            {
+                return isInline() ? storage : getSpill().data;
+            }
+
+            /**
+             * @brief Get bytes that storage can contain
+             * @return N if inline
+             */
+            [[nodiscard]] inline uint16_t getCapacity() const noexcept
+            {
+                return capacity;
+            }
+
+            /**
+             * @brief Check if storage is inline
+             * @return false if spilled
+             */
+            [[nodiscard]] inline bool isInline() const noexcept
+            {
+                return capacity == N;
+            }
+
+            /**
+             * @brief Get a byte of storage
+             * @param i index
+             * @return byte or '\0' if i exceed capacity
+             */
+            [[nodiscard]] inline char operator[](size_t i) const noexcept
+            {
+                return i < capacity ? data()[i] : '\0';
+            }
+
+            /**
+             * @brief Get a storage that can contain size bytes, current one is reused if size fit in it
+             * @param size bytes needed
+             * @param resource where spill if size not fit, nullptr for new[]
+             * @return storage, content is not preserved when storage change
+             * @throw bad_alloc if there is no memory
+             */
+            inline char *reserve(size_t size, std::pmr::memory_resource *resource)
+            {
+                if (size <= capacity)
+                {
+                    return data();
+                }
+
+                Spill spill{resource ? static_cast<char *>(resource->allocate(size, alignof(char))) : new char[size], resource};
+                release();
+                setSpill(spill);
+                capacity = static_cast<uint16_t>(size);
+                return spill.data;
+            }
+
+            /**
+             * @brief Copy storage to a buffer, bytes over capacity are written as 0
+             * @param out buffer
+             * @param length bytes to write
+             */
+            inline void copyTo(uint8_t *out, size_t length) const noexcept
+            {
+                size_t copied = length < capacity ? length : capacity;
+                memcpy(out, data(), copied);
+                memset(out + copied, 0, length - copied);
+            }
+
+            /**
+             * @brief Fill storage with 0, capacity is kept
+             */
+            inline void clear() noexcept
+            {
+                memset(data(), 0, capacity);
+            }
+
+            /**
+             * @brief Give back spilled storage and come back inline
+             */
+            inline void release() noexcept
+            {
+                if (isInline())
+                {
+                    return;
+                }
+                auto spill = getSpill();
+                if (spill.resource)
+                {
+                    spill.resource->deallocate(spill.data, capacity, alignof(char));
+                }
+                else
+                {
+                    delete[] spill.data;
+                }
+                memset(storage, 0, N);
+                capacity = N;
+            }
+
+        private:
+
+            /**
+             * @brief Spilled storage, kept in place of inline storage
+             */
+            struct Spill
+            {
+                char *data;
+                std::pmr::memory_resource *resource;
+            };
+
+            /**
+             * @brief inline storage or Spill, not aligned to keep buffer in N + 2 bytes
+             */
+            char storage[N] = {};
+
+            /**
+             * @brief bytes that storage can contain, greater than N if spilled
+             */
+            uint16_t capacity = N;
+
+            /**
+             * @brief Read spilled storage
+             * @return spill, valid only if not inline
+             */
+            [[nodiscard]] inline Spill getSpill() const noexcept
+            {
+                Spill ret;
+                memcpy(&ret, storage, sizeof(ret));
+                return ret;
+            }
+
+            /**
+             * @brief Write spilled storage in place of inline storage
+             * @param spill to write
+             */
+            inline void setSpill(const Spill &spill) noexcept
+            {
+                memcpy(storage, &spill, sizeof(spill));
+            }
+
+            /**
+             * @brief Copy other reusing storage if it fit, spilled storage is allocated in the memory resource of
+             * self or by new[] if self is inline, bytes after other capacity are filled with 0
+             * @param other to copy
+             */
+            inline void copy(const InlineBuffer &other)
+            {
+                auto buffer = reserve(other.capacity, isInline() ? nullptr : getSpill().resource);
+                memcpy(buffer, other.data(), other.capacity);
+                memset(buffer + other.capacity, 0, capacity - other.capacity);
+            }
+
+            /**
+             * @brief Take storage of other, other come back inline
+             * @param other to move
+             */
+            inline void move(InlineBuffer &other) noexcept
+            {
+                memcpy(storage, other.storage, N);
+                capacity = other.capacity;
+                if (!other.isInline())
+                {
+                    memset(other.storage, 0, N);
+                    other.capacity = N;
+                }
+            }
+        };
+
+    }
+}
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <hgardenpi-protocol/packages/package.hpp>
+#include <hgardenpi-protocol/head.hpp>
 
 #include <utility>
 #include <string>
@@ -58,7 +59,7 @@ namespace hgardenpi::protocol
             /**
              * @brief description of aggregation
              */
-            char *description = nullptr;
+            InlineBuffer<HEAD_INLINE_FIELD_SIZE> description;
             /**
              * @brief manual check if the aggregation start automatically or manually by follow fields
              */
@@ -94,7 +95,7 @@ namespace hgardenpi::protocol
             /**
              * @brief start scheduling period if enhanced
              */
-            char *start = nullptr;
+            InlineBuffer<HEAD_INLINE_FIELD_SIZE> start;
             /**
              * @brief length of end
              */
@@ -102,7 +103,7 @@ namespace hgardenpi::protocol
             /**
              * @brief end scheduling period if enhanced
              */
-            char *end = nullptr;
+            InlineBuffer<HEAD_INLINE_FIELD_SIZE> end;
             /**
              * @brief If true execute sequentially the station otherwise execute all station at the same time
              * @note not implemented in this version, may be in next version
@@ -113,29 +114,10 @@ namespace hgardenpi::protocol
              */
             uint16_t weight = 0;
             /**
-             * @brief status of station
+             * @brief status of station, not serialized, Status::UNACTIVE when deserialized
              */
             Status status = Status::ACTIVE;
 
-            inline ~Aggregation() noexcept override
-            {
-                if (description)
-                {
-                    delete[] description;
-                    description = nullptr;
-                }
-                if (start)
-                {
-                    delete[] start;
-                    start = nullptr;
-                }
-                if (end)
-                {
-                    delete[] end;
-                    end = nullptr;
-                }
-            }
-
             /**
              * @brief Set description
              * @param description
@@ -187,12 +169,30 @@ namespace hgardenpi::protocol
              */
             [[maybe_unused]] [[nodiscard]] string getDescription() const noexcept;
 
+            /**
+             * @brief Get description without copy
+             * @return view until first '\0', valid until description change
+             */
+            [[maybe_unused]] [[nodiscard]] inline std::string_view getDescriptionView() const noexcept
+            {
+                return viewField(description, descriptionLen);
+            }
+
             /**
              * @brief Get start
              * @return start
              */
             [[maybe_unused]] [[nodiscard]] string getStart() const noexcept;
 
+            /**
+             * @brief Get start without copy
+             * @return view until first '\0', valid until start change
+             */
+            [[maybe_unused]] [[nodiscard]] inline std::string_view getStartView() const noexcept
+            {
+                return viewField(start, startLen);
+            }
+
             /**
              * @brief Get end
              * @return end
@@ -200,21 +200,91 @@ namespace hgardenpi::protocol
             [[maybe_unused]] [[nodiscard]] string getEnd() const noexcept;
 
             /**
-             * @brief Serialize self to buffer
+             * @brief Get end without copy
+             * @return view until first '\0', valid until end change
+             */
+            [[maybe_unused]] [[nodiscard]] inline std::string_view getEndView() const noexcept
+            {
+                return viewField(end, endLen);
+            }
+
+            /**
+             * @brief Flag of package type
+             */
+            static constexpr const Flags FLAG = AGG;
+
+            /**
+             * @brief Get flag of package type
+             * @return Flags::AGG
+             */
+            [[nodiscard]] inline Flags getFlag() const noexcept override { return FLAG; }
+
+            /**
+             * @brief Get the size of self serialized
+             * @return number of bytes written by serializeInto()
+             */
+            [[nodiscard]] size_t getSerializedSize() const noexcept override;
+
+            /**
+             * @brief Serialize self to a buffer owned by caller
              * @param buffer of data
-             * @return self serialized
+             * @param size of buffer
+             * @return false if buffer is too small
              */
-            [[nodiscard]] Buffer serialize() const override;
+            [[nodiscard]] bool serializeInto(uint8_t *buffer, size_t size) const noexcept override;
 
             /**
              * @brief Deserialize from buffer to Aggregation
              * @param buffer of data
              * @param length of data
              * @param chunkOfPackage number of chunk id  is split in more chunks
-             * @return new instance of Aggregation or nullptr if error, to deallocate
+             * @param resource where allocate package and its fields, nullptr for pools
+             * @return new instance of Aggregation or nullptr if error, to deallocate with Package::destroy()
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] static Aggregation * deserialize(const uint8_t *buffer, uint8_t length, uint8_t chunkOfPackage, std::pmr::memory_resource *resource = nullptr);
+
+            /**
+             * @brief Deserialize from a frame view to Aggregation without copy the frame
+             * @param head view of received frame
+             * @param chunkOfPackage number of chunk id  is split in more chunks
+             * @param resource where allocate package and its fields, nullptr for pools
+             * @return new instance of Aggregation or nullptr if error, to deallocate with Package::destroy()
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] static inline Aggregation * deserialize(const HeadView &head, uint8_t chunkOfPackage = 0, std::pmr::memory_resource *resource = nullptr)
+            {
+                return deserialize(head.payload.data, head.length, chunkOfPackage, resource);
+            }
+
+            /**
+             * @brief Deserialize from buffer to an existing Aggregation, storage of fields is reused when new values
+             * fit in it
+             * @param existing package to fill
+             * @param buffer of data
+             * @param length of data
+             * @param chunkOfPackage number of chunk id  is split in more chunks
+             * @return false if buffer is not valid or its fields overrun length
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] static bool deserializeInto(Aggregation &existing, const uint8_t *buffer, uint8_t length, uint8_t chunkOfPackage);
+
+            /**
+             * @brief Deserialize from a frame view to an existing Aggregation without copy the frame
+             * @param existing package to fill
+             * @param head view of received frame
+             * @param chunkOfPackage number of chunk id  is split in more chunks
+             * @return false if frame not contain an Aggregation
              * @throw exception if there are some memory error
              */
-            [[nodiscard]] static Aggregation * deserialize(const uint8_t *buffer, uint8_t length, uint8_t chunkOfPackage);
+            [[nodiscard]] static inline bool deserializeInto(Aggregation &existing, const HeadView &head, uint8_t chunkOfPackage = 0)
+            {
+                if ((head.flags & HEAD_PACKAGE_MASK) != FLAG)
+                {
+                    return false;
+                }
+                return deserializeInto(existing, head.payload.data, head.length, chunkOfPackage);
+            }
         };
 #pragma pack(pop)
     }
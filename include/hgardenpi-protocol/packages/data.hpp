@@ -29,8 +29,10 @@
 #pragma clang diagnostic ignored "-Wshadow"
 #pragma once
 #include <string>
+#include <memory>
 
 #include <hgardenpi-protocol/packages/package.hpp>
+#include <hgardenpi-protocol/head.hpp>
 
 namespace hgardenpi::protocol
 {
@@ -63,43 +65,144 @@ namespace hgardenpi::protocol
              */
             uint8_t chunkLength = 0;
 
+            /**
+             * @brief true if payload was adopted from caller by adoptPayload(), it is deleted with delete[]
+             */
+            bool payloadAdopted = false;
+
+            Data() noexcept = default;
+
+            /**
+             * @brief Copy a data, payload and chunk are allocated again, also if payload of other is adopted
+             * @param other to copy
+             * @throw bad_alloc if there is no memory
+             */
+            Data(const Data &other);
+
+            /**
+             * @brief Assign a data, storage of payload and chunk is reused if other ones fit in it
+             * @param other to copy
+             * @return self
+             * @throw bad_alloc if there is no memory
+             */
+            Data &operator=(const Data &other);
+
             inline ~Data() noexcept override
             {
-                if (payload)
-                {
-                    delete [] payload;
-                    payload = nullptr;
-                }
+                resetPayload();
+                deallocateField(chunk, chunkLength);
+            }
 
-                if (chunk)
-                {
-                    delete [] chunk;
-                    chunk = nullptr;
-                }
+            /**
+             * @brief Flag of package type
+             */
+            static constexpr const Flags FLAG = DAT;
+
+            /**
+             * @brief Get flag of package type
+             * @return Flags::DAT
+             */
+            [[nodiscard]] inline Flags getFlag() const noexcept override { return FLAG; }
+
+            /**
+             * @brief Get the size of self serialized
+             * @return number of bytes written by serializeInto()
+             */
+            [[nodiscard]] size_t getSerializedSize() const noexcept override;
+
+            /**
+             * @brief Serialize self to a buffer owned by caller
+             * @param buffer of data
+             * @param size of buffer
+             * @return false if buffer is too small
+             */
+            [[nodiscard]] bool serializeInto(uint8_t *buffer, size_t size) const noexcept override;
+
+            /**
+             * @brief Get payload to frame without copy
+             * @return view of payload, empty if there is no payload and it must be filled with 0
+             */
+            [[nodiscard]] inline BytesView getSerializedTail() const noexcept override
+            {
+                return getPayloadView();
             }
 
             /**
-             * Serialize self to buffer
-             * @return self serialized
+             * @brief Serialize payload length to a buffer owned by caller, all self if there is no payload
+             * @param buffer of data
+             * @param size of buffer
+             * @return false if buffer is too small
              */
-            [[nodiscard]] Buffer serialize() const override;
+            [[nodiscard]] bool serializeHeadInto(uint8_t *buffer, size_t size) const noexcept override;
 
             /**
              * @brief Deserialize from buffer to Data
              * @param buffer of data
              * @param length of data
              * @param chunkOfPackage number of chunk id  is split in more chunks
-             * @return new instance of Data or nullptr if error, to deallocate
+             * @param resource where allocate package and its fields, nullptr for pools
+             * @return new instance of Data or nullptr if error, to deallocate with Package::destroy()
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] static Data * deserialize(const uint8_t *buffer, uint8_t length , uint8_t chunkOfPackage, std::pmr::memory_resource *resource = nullptr);
+
+            /**
+             * @brief Deserialize from a frame view to Data without copy the frame
+             * @param head view of received frame
+             * @param chunkOfPackage number of chunk id  is split in more chunks
+             * @param resource where allocate package and its fields, nullptr for pools
+             * @return new instance of Data or nullptr if error, to deallocate with Package::destroy()
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] static inline Data * deserialize(const HeadView &head, uint8_t chunkOfPackage = 0, std::pmr::memory_resource *resource = nullptr)
+            {
+                return deserialize(head.payload.data, head.length, chunkOfPackage, resource);
+            }
+
+            /**
+             * @brief Deserialize from buffer to an existing Data, storage of fields is reused when new values
+             * fit in it
+             * @param existing package to fill
+             * @param buffer of data
+             * @param length of data
+             * @param chunkOfPackage number of chunk id  is split in more chunks
+             * @return false if buffer is not valid
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] static bool deserializeInto(Data &existing, const uint8_t *buffer, uint8_t length, uint8_t chunkOfPackage);
+
+            /**
+             * @brief Deserialize from a frame view to an existing Data without copy the frame
+             * @param existing package to fill
+             * @param head view of received frame
+             * @param chunkOfPackage number of chunk id  is split in more chunks
+             * @return false if frame not contain a Data
              * @throw exception if there are some memory error
              */
-            [[nodiscard]] static Data * deserialize(const uint8_t *buffer, uint8_t length , uint8_t chunkOfPackage);
+            [[nodiscard]] static inline bool deserializeInto(Data &existing, const HeadView &head, uint8_t chunkOfPackage = 0)
+            {
+                if ((head.flags & HEAD_PACKAGE_MASK) != FLAG)
+                {
+                    return false;
+                }
+                return deserializeInto(existing, head.payload.data, head.length, chunkOfPackage);
+            }
 
             /**
-             * @brief Get payload
-             * @return payload
+             * @brief Get payload, binary safe
+             * @return copy of all bytes of payload
              */
             [[maybe_unused]] [[nodiscard]] string getPayload() const noexcept;
 
+            /**
+             * @brief Get payload without copy, binary safe
+             * @return view of all bytes, valid until payload change
+             */
+            [[maybe_unused]] [[nodiscard]] inline BytesView getPayloadView() const noexcept
+            {
+                return {reinterpret_cast<const uint8_t *>(payload), payload ? length : static_cast<size_t>(0)};
+            }
+
             /**
              * @brief Set payload
              * @param payload
@@ -116,10 +219,49 @@ namespace hgardenpi::protocol
             }
 
             /**
-             * @brief Get chunk message
-             * @return chunk
+             * @brief Set payload from raw bytes, binary safe
+             * @param data bytes to copy
+             * @param size of data
+             * @throw bad_alloc if there is no memory
+             */
+            [[maybe_unused]] void setPayload(const uint8_t *data, uint16_t size);
+
+            /**
+             * @brief Take ownership of a buffer of caller as payload without copy, it is framed in place by encode
+             * @param data buffer allocated with new uint8_t[]
+             * @param size of data
+             */
+            [[maybe_unused]] void adoptPayload(std::unique_ptr<uint8_t[]> &&data, uint16_t size) noexcept;
+
+            /**
+             * @brief Give ownership of payload to caller, payload allocated in a memory resource is copied
+             * @param size of payload returned
+             * @return payload or nullptr if it is empty
+             * @throw bad_alloc if there is no memory
+             */
+            [[maybe_unused]] [[nodiscard]] std::unique_ptr<uint8_t[]> releasePayload(uint16_t &size);
+
+            /**
+             * @brief Get chunk message, binary safe
+             * @return copy of all bytes of chunk
              */
             [[maybe_unused]] [[nodiscard]] string getChunk() const noexcept;
+
+            /**
+             * @brief Get chunk without copy, binary safe
+             * @return view of all bytes, valid until chunk change
+             */
+            [[maybe_unused]] [[nodiscard]] inline BytesView getChunkView() const noexcept
+            {
+                return {reinterpret_cast<const uint8_t *>(chunk), chunk ? chunkLength : static_cast<size_t>(0)};
+            }
+
+        private:
+
+            /**
+             * @brief Give back payload to its owner and set it to nullptr, length is not changed
+             */
+            void resetPayload() noexcept;
         };
 #pragma pack(pop)
     }
@@ -30,6 +30,7 @@
 #include <string>
 
 #include <hgardenpi-protocol/packages/package.hpp>
+#include <hgardenpi-protocol/head.hpp>
 
 
 namespace hgardenpi::protocol
@@ -52,7 +53,7 @@ namespace hgardenpi::protocol
             /**
              * @brief message error
              */
-            char *msg = nullptr;
+            InlineBuffer<HEAD_INLINE_FIELD_SIZE> msg;
             /**
              * @brief data payload
              */
@@ -62,35 +63,122 @@ namespace hgardenpi::protocol
              */
             uint8_t chunkLength = 0;
 
+            Error() noexcept = default;
+
+            /**
+             * @brief Copy an error, chunk is allocated again
+             * @param other to copy
+             * @throw bad_alloc if there is no memory
+             */
+            Error(const Error &other);
+
+            /**
+             * @brief Assign an error, storage of chunk is reused if other chunk fit in it
+             * @param other to copy
+             * @return self
+             * @throw bad_alloc if there is no memory
+             */
+            Error &operator=(const Error &other);
+
             inline ~Error() noexcept override
             {
-                if (msg)
-                {
-                    delete [] msg;
-                    msg = nullptr;
-                }
-                if (chunk)
-                {
-                    delete [] chunk;
-                    chunk = nullptr;
-                }
+                deallocateField(chunk, chunkLength);
+            }
+
+            /**
+             * @brief Flag of package type
+             */
+            static constexpr const Flags FLAG = ERR;
+
+            /**
+             * @brief Get flag of package type
+             * @return Flags::ERR
+             */
+            [[nodiscard]] inline Flags getFlag() const noexcept override { return FLAG; }
+
+            /**
+             * @brief Get the size of self serialized
+             * @return number of bytes written by serializeInto()
+             */
+            [[nodiscard]] size_t getSerializedSize() const noexcept override;
+
+            /**
+             * @brief Serialize self to a buffer owned by caller
+             * @param buffer of data
+             * @param size of buffer
+             * @return false if buffer is too small
+             */
+            [[nodiscard]] bool serializeInto(uint8_t *buffer, size_t size) const noexcept override;
+
+            /**
+             * @brief Get message to frame without copy
+             * @return view of message, empty if message is shorter than length and it must be padded
+             */
+            [[nodiscard]] inline BytesView getSerializedTail() const noexcept override
+            {
+                return length <= msg.getCapacity() ? getMsgView() : BytesView();
             }
 
             /**
-             * Serialize self to buffer
-             * @return self serialized
+             * @brief Serialize message length to a buffer owned by caller, all self if message must be padded
+             * @param buffer of data
+             * @param size of buffer
+             * @return false if buffer is too small
              */
-            [[nodiscard]] Buffer serialize() const override;
+            [[nodiscard]] bool serializeHeadInto(uint8_t *buffer, size_t size) const noexcept override;
 
             /**
              * @brief Deserialize from buffer to Error
              * @param buffer of data
              * @param length of data
              * @param chunkOfPackage number of chunk id  is split in more chunks
-             * @return new instance of Error or nullptr if error, to deallocate
+             * @param resource where allocate package and its fields, nullptr for pools
+             * @return new instance of Error or nullptr if error, to deallocate with Package::destroy()
              * @throw exception if there are some memory error
              */
-            [[nodiscard]] static Error * deserialize(const uint8_t *buffer, uint8_t length , uint8_t chunkOfPackage);
+            [[nodiscard]] static Error * deserialize(const uint8_t *buffer, uint8_t length , uint8_t chunkOfPackage, std::pmr::memory_resource *resource = nullptr);
+
+            /**
+             * @brief Deserialize from a frame view to Error without copy the frame
+             * @param head view of received frame
+             * @param chunkOfPackage number of chunk id  is split in more chunks
+             * @param resource where allocate package and its fields, nullptr for pools
+             * @return new instance of Error or nullptr if error, to deallocate with Package::destroy()
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] static inline Error * deserialize(const HeadView &head, uint8_t chunkOfPackage = 0, std::pmr::memory_resource *resource = nullptr)
+            {
+                return deserialize(head.payload.data, head.length, chunkOfPackage, resource);
+            }
+
+            /**
+             * @brief Deserialize from buffer to an existing Error, storage of fields is reused when new values
+             * fit in it
+             * @param existing package to fill
+             * @param buffer of data
+             * @param length of data
+             * @param chunkOfPackage number of chunk id  is split in more chunks
+             * @return false if buffer is not valid
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] static bool deserializeInto(Error &existing, const uint8_t *buffer, uint8_t length, uint8_t chunkOfPackage);
+
+            /**
+             * @brief Deserialize from a frame view to an existing Error without copy the frame
+             * @param existing package to fill
+             * @param head view of received frame
+             * @param chunkOfPackage number of chunk id  is split in more chunks
+             * @return false if frame not contain an Error
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] static inline bool deserializeInto(Error &existing, const HeadView &head, uint8_t chunkOfPackage = 0)
+            {
+                if ((head.flags & HEAD_PACKAGE_MASK) != FLAG)
+                {
+                    return false;
+                }
+                return deserializeInto(existing, head.payload.data, head.length, chunkOfPackage);
+            }
 
             /**
              * @brief Get msg
@@ -98,6 +186,15 @@ namespace hgardenpi::protocol
              */
             [[maybe_unused]] [[nodiscard]] string getMsg() const noexcept;
 
+            /**
+             * @brief Get msg without copy, binary safe
+             * @return view of all bytes, valid until msg change
+             */
+            [[maybe_unused]] [[nodiscard]] inline BytesView getMsgView() const noexcept
+            {
+                return {reinterpret_cast<const uint8_t *>(msg.data()), length < msg.getCapacity() ? length : msg.getCapacity()};
+            }
+
             /**
              * @brief Set msg
              * @param msg
@@ -118,6 +215,15 @@ namespace hgardenpi::protocol
             * @return cunk
             */
             [[maybe_unused]] [[nodiscard]] string getChunk() const noexcept;
+
+            /**
+             * @brief Get chunk without copy, binary safe
+             * @return view of all bytes, valid until chunk change
+             */
+            [[maybe_unused]] [[nodiscard]] inline BytesView getChunkView() const noexcept
+            {
+                return {reinterpret_cast<const uint8_t *>(chunk), chunk ? chunkLength : static_cast<size_t>(0)};
+            }
         };
 #pragma pack(pop)
     }
@@ -30,6 +30,7 @@
 #include <string>
 
 #include <hgardenpi-protocol/packages/package.hpp>
+#include <hgardenpi-protocol/head.hpp>
 #include <hgardenpi-protocol/constants.hpp>
 
 namespace hgardenpi::protocol
@@ -49,6 +50,29 @@ namespace hgardenpi::protocol
         {
         public:
 
+            /**
+             * @brief Flag of package type
+             */
+            static constexpr const Flags FLAG = FIN;
+
+            /**
+             * @brief Get flag of package type
+             * @return Flags::FIN
+             */
+            [[nodiscard]] inline Flags getFlag() const noexcept override { return FLAG; }
+
+            /**
+             * @brief Get the size of self serialized
+             * @return always 0, Finish has no field
+             */
+            [[nodiscard]] inline size_t getSerializedSize() const noexcept override { return 0; }
+
+            /**
+             * @brief Serialize self to a buffer owned by caller
+             * @return always true, nothing to write
+             */
+            [[nodiscard]] inline bool serializeInto(uint8_t *, size_t) const noexcept override { return true; }
+
             /**
              * Serialize self to buffer
              * @return self serialized
@@ -58,9 +82,53 @@ namespace hgardenpi::protocol
             /**
              * @brief Deserialize from buffer to Finish
              * @param buffer of data
-             * @return new instance of Finish or nullptr if error, to deallocate
+             * @param resource where allocate package and its fields, nullptr for pools
+             * @return new instance of Finish or nullptr if error, to deallocate with Package::destroy()
+             * @throw bad_alloc if there is no memory
+             */
+            [[nodiscard]] static inline Finish * deserialize(const uint8_t *, uint8_t, uint8_t, std::pmr::memory_resource *resource = nullptr)
+            {
+                return create<Finish>(resource);
+            }
+
+            /**
+             * @brief Deserialize from a frame view to Finish without copy the frame
+             * @param head view of received frame
+             * @param chunkOfPackage number of chunk id  is split in more chunks
+             * @param resource where allocate package and its fields, nullptr for pools
+             * @return new instance of Finish or nullptr if error, to deallocate with Package::destroy()
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] static inline Finish * deserialize(const HeadView &head, uint8_t chunkOfPackage = 0, std::pmr::memory_resource *resource = nullptr)
+            {
+                return deserialize(head.payload.data, head.length, chunkOfPackage, resource);
+            }
+
+            /**
+             * @brief Deserialize from buffer to an existing Finish
+             * @return always true, Finish has no field
+             */
+            [[nodiscard]] static inline bool deserializeInto(Finish &, const uint8_t *, uint8_t, uint8_t) noexcept
+            {
+                return true;
+            }
+
+            /**
+             * @brief Deserialize from a frame view to an existing Finish without copy the frame
+             * @param existing package to fill
+             * @param head view of received frame
+             * @param chunkOfPackage number of chunk id  is split in more chunks
+             * @return false if frame not contain a Finish
+             * @throw exception if there are some memory error
              */
-            [[nodiscard]] static inline Finish * deserialize(const uint8_t *buffer, uint8_t, uint8_t) noexcept { return new Finish; }
+            [[nodiscard]] static inline bool deserializeInto(Finish &existing, const HeadView &head, uint8_t chunkOfPackage = 0)
+            {
+                if ((head.flags & HEAD_PACKAGE_MASK) != FLAG)
+                {
+                    return false;
+                }
+                return deserializeInto(existing, head.payload.data, head.length, chunkOfPackage);
+            }
 
         };
 
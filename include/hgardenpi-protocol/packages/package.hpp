@@ -28,23 +28,21 @@
 #pragma once
 
 #define HGARDENPI_PROTOCOL_SETTER(field, fieldLength)  \
-fieldLength = field.size(); \
-this->field = new char [fieldLength]; \
-memset(this->field, 0, fieldLength); \
-memcpy(this->field, &field[0], fieldLength);
+copyField(this->field, fieldLength, reinterpret_cast<const uint8_t *>(field.data()), static_cast<decltype(fieldLength)>(field.size()));
 
 #define HGARDENPI_PROTOCOL_GETTER(field, fieldLength)  \
-string ret; \
-for (int i = 0; i < fieldLength && field[i]; i++) \
-{ \
-    ret += field[i]; \
-} \
-return ret;
+return string(viewField(field, fieldLength));
 
 #include <cstdint>
+#include <cstddef>
+#include <cstring>
 #include <memory>
+#include <memory_resource>
+#include <new>
+#include <string_view>
 
 #include <hgardenpi-protocol/constants.hpp>
+#include <hgardenpi-protocol/inlinebuffer.hpp>
 
 namespace hgardenpi::protocol
 {
@@ -59,14 +57,240 @@ namespace hgardenpi::protocol
         {
             typedef std::shared_ptr<Package> Ptr;
 
+            /**
+             * @brief Memory resource where self and its fields are allocated, nullptr for pools and new[]
+             */
+            std::pmr::memory_resource *resource = nullptr;
+
+            Package() noexcept = default;
+
+            /**
+             * @brief Copy a package, the copy is not allocated in the memory resource of other
+             */
+            inline Package(const Package &) noexcept
+            {
+            }
+
+            /**
+             * @brief Assign a package, memory resource of self is kept
+             */
+            inline Package &operator=(const Package &) noexcept
+            {
+                return *this;
+            }
+
             virtual inline ~Package() = default;
 
+            /**
+             * @brief Allocate packages from pools
+             * @param size of package
+             * @return memory
+             * @throw bad_alloc if there is no memory
+             */
+            static void *operator new(size_t size);
+
+            /**
+             * @brief Allocate packages from pools
+             * @param size of package
+             * @return memory or nullptr if there is no memory
+             */
+            static void *operator new(size_t size, const std::nothrow_t &) noexcept;
+
+            /**
+             * @brief Give back a package to pools
+             * @param ptr package
+             * @param size of package, dynamic type
+             */
+            static void operator delete(void *ptr, size_t size) noexcept;
+
+            /**
+             * @brief Construct a package in a memory resource
+             * @param resource where allocate package and its fields, nullptr for pools
+             * @return new instance of T, to deallocate with destroy()
+             * @throw bad_alloc if there is no memory
+             */
+            template<typename T>
+            [[nodiscard]] static inline T *create(std::pmr::memory_resource *resource)
+            {
+                if (!resource)
+                {
+                    return new T;
+                }
+                auto ret = ::new(resource->allocate(sizeof(T))) T;
+                ret->resource = resource;
+                return ret;
+            }
+
+            /**
+             * @brief Destroy a package allocated by create() or new
+             * @param package to destroy, can be nullptr
+             */
+            static void destroy(Package *package) noexcept;
+
+            /**
+             * @brief Allocate a field of package in resource
+             * @param size bytes
+             * @return field
+             * @throw bad_alloc if there is no memory
+             */
+            [[nodiscard]] char *allocateField(size_t size) const;
+
+            /**
+             * @brief Give back a field allocated by allocateField() and set it to nullptr
+             * @param field to deallocate, can be nullptr
+             * @param size bytes, the same passed to allocateField()
+             */
+            void deallocateField(char *&field, size_t size) const noexcept;
+
+            /**
+             * @brief Reuse a field allocated by allocateField() if size fit in it, otherwise allocate it again
+             * @param field to reuse, updated if allocated again
+             * @param fieldSize current size of field
+             * @param size bytes needed
+             * @note in a memory resource a field is reused only for the same size, deallocate need it
+             * @throw bad_alloc if there is no memory
+             */
+            void reuseField(char *&field, size_t fieldSize, size_t size) const;
+
+            /**
+             * @brief Copy bytes in a field reusing its storage if they fit in it
+             * @param field to fill, deallocated if length is 0
+             * @param fieldLength current length of field, updated to length
+             * @param data bytes to copy
+             * @param length of data
+             * @throw bad_alloc if there is no memory
+             */
+            template<typename L>
+            inline void copyField(char *&field, L &fieldLength, const uint8_t *data, L length) const
+            {
+                if (length == 0)
+                {
+                    deallocateField(field, fieldLength);
+                }
+                else
+                {
+                    reuseField(field, fieldLength, length);
+                    memcpy(field, data, length);
+                }
+                fieldLength = length;
+            }
+
+            /**
+             * @brief Copy bytes in an inline field, spill in resource only if they not fit in it
+             * @param field to fill
+             * @param fieldLength current length of field, updated to length
+             * @param data bytes to copy
+             * @param length of data
+             * @throw bad_alloc if there is no memory
+             */
+            template<uint16_t N, typename L>
+            inline void copyField(InlineBuffer<N> &field, L &fieldLength, const uint8_t *data, L length) const
+            {
+                if (length > 0)
+                {
+                    memcpy(field.reserve(length, resource), data, length);
+                }
+                fieldLength = length;
+            }
+
+            /**
+             * @brief View text of a field without copy
+             * @param field text, can be nullptr
+             * @param length of field
+             * @return view until first '\0' or length
+             */
+            [[nodiscard]] static inline std::string_view viewField(const char *field, size_t length) noexcept
+            {
+                if (!field)
+                {
+                    return {};
+                }
+                auto end = static_cast<const char *>(memchr(field, '\0', length));
+                return {field, end ? static_cast<size_t>(end - field) : length};
+            }
+
+            /**
+             * @brief View text of an inline field without copy
+             * @param field text
+             * @param length of field, bounded to capacity of field
+             * @return view until first '\0' or length
+             */
+            template<uint16_t N>
+            [[nodiscard]] static inline std::string_view viewField(const InlineBuffer<N> &field, size_t length) noexcept
+            {
+                return viewField(field.data(), length < field.getCapacity() ? length : field.getCapacity());
+            }
+
+            /**
+             * @brief Check that a field of a serialized package lies inside its payload
+             * @param offset of field in payload
+             * @param size of field
+             * @param length of payload
+             * @return false if field overruns payload
+             */
+            [[nodiscard]] static constexpr inline bool fieldInBounds(size_t offset, size_t size, size_t length) noexcept
+            {
+                return offset <= length && size <= length - offset;
+            }
+
+            /**
+             * @brief Get flag of package type, used for dispatch without RTTI
+             * @return one of Flags::SYN, Flags::DAT, Flags::ERR, Flags::AGG, Flags::STA, Flags::FIN
+             */
+            [[nodiscard]] virtual Flags getFlag() const noexcept = 0;
+
+            /**
+             * @brief Get the size of self serialized
+             * @return number of bytes written by serializeInto()
+             */
+            [[nodiscard]] virtual size_t getSerializedSize() const noexcept = 0;
+
+            /**
+             * @brief Serialize self to a buffer owned by caller, no allocation is done
+             * @param buffer of data, it must contain at least getSerializedSize() bytes
+             * @param size of buffer
+             * @return false if buffer is too small or self can't be serialized
+             */
+            [[nodiscard]] virtual bool serializeInto(uint8_t *buffer, size_t size) const noexcept = 0;
+
+            /**
+             * @brief Get last bytes of self serialized that can be framed from package memory without copy
+             * @return view of the tail of serializeInto() output, empty if all bytes are written by serializeHeadInto()
+             */
+            [[nodiscard]] virtual inline BytesView getSerializedTail() const noexcept
+            {
+                return {};
+            }
+
+            /**
+             * @brief Serialize bytes of self before getSerializedTail() to a buffer owned by caller
+             * @param buffer of data, it must contain at least getSerializedSize() - getSerializedTail().size bytes
+             * @param size of buffer
+             * @return false if buffer is too small or self can't be serialized
+             */
+            [[nodiscard]] virtual inline bool serializeHeadInto(uint8_t *buffer, size_t size) const noexcept
+            {
+                return serializeInto(buffer, size);
+            }
+
             /**
              * @brief Serialize self to buffer
-             * @param buffer of data
              * @return self serialized
+             * @throw runtime_exception if something goes wrong
              */
-            [[nodiscard]] virtual Buffer serialize() const = 0;
+            [[nodiscard]] virtual Buffer serialize() const;
+        };
+
+        /**
+         * @brief Deleter of packages for smart pointers, packages allocated in a memory resource are given back
+         * to it
+         */
+        struct PackageDeleter
+        {
+            inline void operator()(Package *package) const noexcept
+            {
+                Package::destroy(package);
+            }
         };
 #pragma pack(pop)
     }
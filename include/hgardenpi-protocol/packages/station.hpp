@@ -30,6 +30,7 @@
 #pragma once
 
 #include <hgardenpi-protocol/packages/package.hpp>
+#include <hgardenpi-protocol/head.hpp>
 #include <hgardenpi-protocol/constants.hpp>
 
 #include <string>
@@ -59,7 +60,7 @@ namespace hgardenpi::protocol
             /**
              * @brief name of station
              */
-            char *name = nullptr;
+            InlineBuffer<HEAD_INLINE_FIELD_SIZE> name;
             /**
             * @brief description length
             */
@@ -67,7 +68,7 @@ namespace hgardenpi::protocol
             /**
              * @brief description of station
              */
-            char *description = nullptr;
+            InlineBuffer<HEAD_INLINE_FIELD_SIZE> description;
             /**
              * @brief relay number association
              */
@@ -86,30 +87,25 @@ namespace hgardenpi::protocol
              */
             uint16_t weight = 0;
             /**
-             * @brief status of station
+             * @brief status of station, not serialized, Status::UNACTIVE when deserialized
              */
             Status status = Status::ACTIVE;
 
-            inline ~Station() override
-            {
-                if (name)
-                {
-                    delete[] name;
-                    name = nullptr;
-                }
-                if (description)
-                {
-                    delete[] description;
-                    description = nullptr;
-                }
-            }
-
             /**
              * @brief Get name
              * @return msg
              */
             [[maybe_unused]] [[nodiscard]] string getName() const noexcept;
 
+            /**
+             * @brief Get name without copy
+             * @return view until first '\0', valid until name change
+             */
+            [[maybe_unused]] [[nodiscard]] inline std::string_view getNameView() const noexcept
+            {
+                return viewField(name, nameLen);
+            }
+
             /**
              * @brief Set name
              * @param name
@@ -131,6 +127,15 @@ namespace hgardenpi::protocol
              */
             [[maybe_unused]] [[nodiscard]] string getDescription() const noexcept;
 
+            /**
+             * @brief Get description without copy
+             * @return view until first '\0', valid until description change
+             */
+            [[maybe_unused]] [[nodiscard]] inline std::string_view getDescriptionView() const noexcept
+            {
+                return viewField(description, descriptionLen);
+            }
+
             /**
              * @brief Set description
              * @param description
@@ -147,18 +152,82 @@ namespace hgardenpi::protocol
             }
 
             /**
-             * Serialize self to buffer
-             * @return self serialized
+             * @brief Flag of package type
+             */
+            static constexpr const Flags FLAG = STA;
+
+            /**
+             * @brief Get flag of package type
+             * @return Flags::STA
+             */
+            [[nodiscard]] inline Flags getFlag() const noexcept override { return FLAG; }
+
+            /**
+             * @brief Get the size of self serialized
+             * @return number of bytes written by serializeInto()
              */
-            [[nodiscard]] Buffer serialize() const override;
+            [[nodiscard]] size_t getSerializedSize() const noexcept override;
+
+            /**
+             * @brief Serialize self to a buffer owned by caller
+             * @param buffer of data
+             * @param size of buffer
+             * @return false if buffer is too small
+             */
+            [[nodiscard]] bool serializeInto(uint8_t *buffer, size_t size) const noexcept override;
 
             /**
              * @brief Deserialize from buffer to Station
              * @param buffer of data
-             * @return new instance of Station or nullptr if error, to deallocate
+             * @param length of data
+             * @param chunkOfPackage number of chunk id  is split in more chunks
+             * @param resource where allocate package and its fields, nullptr for pools
+             * @return new instance of Station or nullptr if error, to deallocate with Package::destroy()
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] static Station * deserialize(const uint8_t *buffer, uint8_t length, uint8_t chunkOfPackage, std::pmr::memory_resource *resource = nullptr);
+
+            /**
+             * @brief Deserialize from a frame view to Station without copy the frame
+             * @param head view of received frame
+             * @param chunkOfPackage number of chunk id  is split in more chunks
+             * @param resource where allocate package and its fields, nullptr for pools
+             * @return new instance of Station or nullptr if error, to deallocate with Package::destroy()
              * @throw exception if there are some memory error
              */
-            [[nodiscard]] static Station * deserialize(const uint8_t *buffer, uint8_t, uint8_t);
+            [[nodiscard]] static inline Station * deserialize(const HeadView &head, uint8_t chunkOfPackage = 0, std::pmr::memory_resource *resource = nullptr)
+            {
+                return deserialize(head.payload.data, head.length, chunkOfPackage, resource);
+            }
+
+            /**
+             * @brief Deserialize from buffer to an existing Station, storage of fields is reused when new values
+             * fit in it
+             * @param existing package to fill
+             * @param buffer of data
+             * @param length of data
+             * @param chunkOfPackage number of chunk id  is split in more chunks
+             * @return false if buffer is not valid or its fields overrun length
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] static bool deserializeInto(Station &existing, const uint8_t *buffer, uint8_t length, uint8_t chunkOfPackage);
+
+            /**
+             * @brief Deserialize from a frame view to an existing Station without copy the frame
+             * @param existing package to fill
+             * @param head view of received frame
+             * @param chunkOfPackage number of chunk id  is split in more chunks
+             * @return false if frame not contain a Station
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] static inline bool deserializeInto(Station &existing, const HeadView &head, uint8_t chunkOfPackage = 0)
+            {
+                if ((head.flags & HEAD_PACKAGE_MASK) != FLAG)
+                {
+                    return false;
+                }
+                return deserializeInto(existing, head.payload.data, head.length, chunkOfPackage);
+            }
         };
 #pragma pack(pop)
     }
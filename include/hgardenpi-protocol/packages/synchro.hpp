@@ -32,6 +32,7 @@
 #include <string>
 
 #include <hgardenpi-protocol/packages/package.hpp>
+#include <hgardenpi-protocol/head.hpp>
 #include <hgardenpi-protocol/constants.hpp>
 
 namespace hgardenpi::protocol
@@ -55,16 +56,7 @@ namespace hgardenpi::protocol
             /**
              * @brief serial of device
              */
-            char *serial = nullptr;
-
-            inline ~Synchro() noexcept override
-            {
-                if (serial)
-                {
-                    delete[] serial;
-                    serial = nullptr;
-                }
-            }
+            InlineBuffer<HEAD_INLINE_FIELD_SIZE> serial;
 
             /**
  * @brief Get msg
@@ -72,6 +64,15 @@ namespace hgardenpi::protocol
  */
             [[maybe_unused]] [[nodiscard]] string getSerial() const noexcept;
 
+            /**
+             * @brief Get serial without copy
+             * @return view until first '\0', valid until serial change
+             */
+            [[maybe_unused]] [[nodiscard]] inline std::string_view getSerialView() const noexcept
+            {
+                return viewField(serial, length);
+            }
+
             /**
              * @brief Set serial
              * @param serial
@@ -92,14 +93,83 @@ namespace hgardenpi::protocol
              * @param buffer of data
              * @param length of data
              * @param chunkOfPackage number of chunk id  is split in more chunks
-             * @return new instance of Synchro or nullptr if error, to deallocate
+             * @param resource where allocate package and its fields, nullptr for pools
+             * @return new instance of Synchro or nullptr if error, to deallocate with Package::destroy()
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] static Synchro * deserialize(const uint8_t *buffer, uint8_t length, uint8_t chunkOfPackage, std::pmr::memory_resource *resource = nullptr);
+
+            /**
+             * @brief Deserialize from a frame view to Synchro without copy the frame
+             * @param head view of received frame
+             * @param chunkOfPackage number of chunk id  is split in more chunks
+             * @param resource where allocate package and its fields, nullptr for pools
+             * @return new instance of Synchro or nullptr if error, to deallocate with Package::destroy()
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] static inline Synchro * deserialize(const HeadView &head, uint8_t chunkOfPackage = 0, std::pmr::memory_resource *resource = nullptr)
+            {
+                return deserialize(head.payload.data, head.length, chunkOfPackage, resource);
+            }
+
+            /**
+             * @brief Deserialize from buffer to an existing Synchro, storage of fields is reused when new values
+             * fit in it
+             * @param existing package to fill
+             * @param buffer of data
+             * @param length of data
+             * @param chunkOfPackage number of chunk id  is split in more chunks
+             * @return false if buffer is not valid or its fields overrun length
+             * @throw exception if there are some memory error
+             */
+            [[nodiscard]] static bool deserializeInto(Synchro &existing, const uint8_t *buffer, uint8_t length, uint8_t chunkOfPackage);
+
+            /**
+             * @brief Deserialize from a frame view to an existing Synchro without copy the frame
+             * @param existing package to fill
+             * @param head view of received frame
+             * @param chunkOfPackage number of chunk id  is split in more chunks
+             * @return false if frame not contain a Synchro
              * @throw exception if there are some memory error
              */
-            [[nodiscard]] static Synchro * deserialize(const uint8_t *buffer, uint8_t length, uint8_t chunkOfPackage);
+            [[nodiscard]] static inline bool deserializeInto(Synchro &existing, const HeadView &head, uint8_t chunkOfPackage = 0)
+            {
+                if ((head.flags & HEAD_PACKAGE_MASK) != FLAG)
+                {
+                    return false;
+                }
+                return deserializeInto(existing, head.payload.data, head.length, chunkOfPackage);
+            }
+
+            /**
+             * @brief Flag of package type
+             */
+            static constexpr const Flags FLAG = SYN;
+
+            /**
+             * @brief Get flag of package type
+             * @return Flags::SYN
+             */
+            [[nodiscard]] inline Flags getFlag() const noexcept override { return FLAG; }
+
+            /**
+             * @brief Get the size of self serialized
+             * @return number of bytes written by serializeInto()
+             */
+            [[nodiscard]] size_t getSerializedSize() const noexcept override;
+
+            /**
+             * @brief Serialize self to a buffer owned by caller
+             * @param buffer of data
+             * @param size of buffer
+             * @return false if buffer is too small or serial exceed HEAD_MAX_SERIAL_SIZE
+             */
+            [[nodiscard]] bool serializeInto(uint8_t *buffer, size_t size) const noexcept override;
 
             /**
              * Serialize self to buffer
              * @return self serialized
+             * @throw runtime_exception if serial exceed HEAD_MAX_SERIAL_SIZE
              */
             [[nodiscard]] Buffer serialize() const override;
         };
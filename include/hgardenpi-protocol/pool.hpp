@@ -0,0 +1,302 @@
+// MIT License
+//
+// Copyright (c) 2021. Happy GardenPI
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+
+#include <hgardenpi-protocol/constants.hpp>
+
+namespace hgardenpi::protocol
+{
+    inline namespace v2
+    {
+
+        /**
+         * @brief Fixed size blocks allocator, blocks are taken from slabs allocated on demand and never
+         * given back to system
+         * @note thread safe
+         */
+        class Pool final
+        {
+        public:
+
+            /**
+             * @brief Statistics of pool
+             */
+            struct Statistics
+            {
+                /**
+                 * @brief size of every block
+                 */
+                size_t blockSize = 0;
+
+                /**
+                 * @brief slabs allocated
+                 */
+                size_t slabs = 0;
+
+                /**
+                 * @brief blocks in all slabs
+                 */
+                size_t blocks = 0;
+
+                /**
+                 * @brief blocks in use
+                 */
+                size_t used = 0;
+
+                /**
+                 * @brief max blocks in use at the same time
+                 */
+                size_t peak = 0;
+
+                /**
+                 * @brief blocks allocated since start
+                 */
+                size_t allocations = 0;
+            };
+
+            /**
+             * @brief Construct an empty pool
+             * @param blockSize size of every block, rounded to alignment of max_align_t
+             * @param blocksPerSlab blocks allocated together when pool is empty
+             */
+            Pool(size_t blockSize, size_t blocksPerSlab) noexcept;
+
+            Pool(const Pool &) = delete;
+            Pool &operator=(const Pool &) = delete;
+
+            ~Pool() noexcept;
+
+            /**
+             * @brief Take a block
+             * @return block or nullptr if there is no memory
+             */
+            [[nodiscard]] void *allocate() noexcept;
+
+            /**
+             * @brief Give back a block
+             * @param ptr block returned by allocate()
+             */
+            void deallocate(void *ptr) noexcept;
+
+            /**
+             * @brief Give back a block only if it is of this pool, ownership is checked under the same lock
+             * @param ptr to give back, can be nullptr
+             * @return false if ptr is not a block of this pool
+             */
+            [[nodiscard]] bool deallocateOwned(void *ptr) noexcept;
+
+            /**
+             * @brief Check if a pointer is a block of this pool
+             * @param ptr to check
+             * @return true if ptr is inside a slab
+             */
+            [[nodiscard]] bool owns(const void *ptr) const noexcept;
+
+            /**
+             * @brief Get statistics of pool
+             * @return copy of statistics
+             */
+            [[nodiscard]] Statistics getStatistics() const noexcept;
+
+        private:
+
+            struct Slab;
+            struct Block;
+
+            /**
+             * @brief lock of free list and slabs
+             */
+            mutable std::mutex lock;
+
+            /**
+             * @brief blocks allocated together
+             */
+            size_t blocksPerSlab = 0;
+
+            /**
+             * @brief slabs allocated sorted by address, searched by owns() in logarithmic time
+             */
+            Slab **slabs = nullptr;
+
+            /**
+             * @brief capacity of slabs
+             */
+            size_t slabsCapacity = 0;
+
+            /**
+             * @brief free blocks
+             */
+            Block *freeBlocks = nullptr;
+
+            /**
+             * @brief statistics of pool
+             */
+            Statistics statistics;
+
+            /**
+             * @brief Allocate one more slab and add its blocks to free list
+             * @return false if there is no memory
+             */
+            bool grow() noexcept;
+
+            /**
+             * @brief Check if a pointer is a block of this pool, lock must be taken
+             * @param ptr to check
+             * @return true if ptr is inside a slab
+             */
+            [[nodiscard]] bool isOwned(const void *ptr) const noexcept;
+        };
+
+        /**
+         * @brief Size of blocks of the pools used by the library, the last one contain a whole frame
+         */
+        constexpr const inline std::array<size_t, 4> POOL_BLOCK_SIZES = {32, 64, 128, HEAD_MAX_FRAME_SIZE};
+
+        /**
+         * @brief Allocate from the pool of the smallest block that contain size, bigger sizes are allocated
+         * by operator new
+         * @param size bytes
+         * @return memory or nullptr if there is no memory
+         */
+        [[nodiscard]] void *poolAllocate(size_t size) noexcept;
+
+        /**
+         * @brief Give back memory allocated by poolAllocate()
+         * @param ptr memory
+         * @param size bytes, the same passed to poolAllocate()
+         */
+        void poolDeallocate(void *ptr, size_t size) noexcept;
+
+        /**
+         * @brief Allocate a buffer for a frame or a payload from the pool of the smallest block that contain it,
+         * pooled up to HEAD_MAX_FRAME_SIZE bytes
+         * @param size bytes
+         * @return buffer or nullptr if there is no memory
+         */
+        [[nodiscard]] uint8_t *allocateBuffer(size_t size) noexcept;
+
+        /**
+         * @brief Give back a buffer, buffers allocated with new[] are deleted
+         * @param buffer from allocateBuffer() or new[]
+         * @param size bytes, the same passed to allocateBuffer(), it selects the only pool searched
+         */
+        void deallocateBuffer(uint8_t *buffer, size_t size) noexcept;
+
+        /**
+         * @brief Get statistics of the pools used by the library
+         * @return statistics in order of POOL_BLOCK_SIZES
+         */
+        [[nodiscard]] std::array<Pool::Statistics, POOL_BLOCK_SIZES.size()> getPoolStatistics() noexcept;
+
+        /**
+         * @brief Allocator for standard library on pools, eg. std::allocate_shared()
+         */
+        template<typename T>
+        struct PoolAllocator
+        {
+            typedef T value_type;
+
+            PoolAllocator() noexcept = default;
+
+            template<typename U>
+            inline PoolAllocator(const PoolAllocator<U> &) noexcept
+            {
+            }
+
+            [[nodiscard]] inline T *allocate(size_t n)
+            {
+                if (auto ptr = poolAllocate(n * sizeof(T)))
+                {
+                    return static_cast<T *>(ptr);
+                }
+                throw std::bad_alloc();
+            }
+
+            inline void deallocate(T *ptr, size_t n) noexcept
+            {
+                poolDeallocate(ptr, n * sizeof(T));
+            }
+
+            template<typename U>
+            inline bool operator==(const PoolAllocator<U> &) const noexcept
+            {
+                return true;
+            }
+
+            template<typename U>
+            inline bool operator!=(const PoolAllocator<U> &) const noexcept
+            {
+                return false;
+            }
+        };
+
+        /**
+         * @brief Deleter of buffers for smart pointers
+         */
+        struct BufferDeleter
+        {
+            /**
+             * @brief size of buffer
+             */
+            size_t size = 0;
+
+            inline void operator()(uint8_t *buffer) const noexcept
+            {
+                deallocateBuffer(buffer, size);
+            }
+        };
+
+        /**
+         * @brief Deleter for smart pointers of buffers allocated in a memory resource
+         */
+        struct MemoryResourceDeleter
+        {
+            /**
+             * @brief where buffer is allocated
+             */
+            std::pmr::memory_resource *resource = nullptr;
+
+            /**
+             * @brief size of buffer
+             */
+            size_t size = 0;
+
+            inline void operator()(uint8_t *buffer) const noexcept
+            {
+                if (buffer)
+                {
+                    resource->deallocate(buffer, size, alignof(uint8_t));
+                }
+            }
+        };
+
+    }
+}
@@ -32,11 +32,20 @@
 
 
 #include  <utility>
+#include  <iterator>
 #include  <stdexcept>
+#include  <memory_resource>
+#if __has_include(<sys/uio.h>)
+#include  <sys/uio.h>
+#define HGARDENPI_PROTOCOL_SCATTER
+#endif
 
+#include <hgardenpi-protocol/checksum.hpp>
 #include <hgardenpi-protocol/constants.hpp>
 #include <hgardenpi-protocol/head.hpp>
 #include <hgardenpi-protocol/packages/package.hpp>
+#include <hgardenpi-protocol/pool.hpp>
+#include <hgardenpi-protocol/result.hpp>
 
 
 namespace hgardenpi::protocol
@@ -58,13 +67,702 @@ namespace hgardenpi::protocol
         [[maybe_unused]]  Buffers encode(Package *package, Flags additionalFags = NOT_SET);
 
         /**
-        * Decode a buffer contain a Happy GardenPI Head
-        * @param data buffer
+         * Encode a buffer contain a Happy GardenPI Head, never throw
+         * @param package package to send
+         * @param additionalFags additional flags to decorate package
+         * @return a vector of buffer to send or error
+         */
+        [[maybe_unused]] Result<Buffers> tryEncode(const Package *package, Flags additionalFags = NOT_SET) noexcept;
+
+        /**
+         * Encode a buffer contain a Happy GardenPI Head with checksum agreed by a link at runtime, never throw
+         * @param package package to send
+         * @param additionalFags additional flags to decorate package
+         * @param checksum of link
+         * @return a vector of buffer to send or error
+         */
+        [[maybe_unused]] Result<Buffers> tryEncode(const Package *package, Flags additionalFags, ChecksumType checksum) noexcept;
+
+        /**
+         * Encode a buffer contain a Happy GardenPI Head in a memory resource
+         * @param package package to send
+         * @param additionalFags additional flags to decorate package
+         * @param resource where allocate vector, buffers and their control blocks, nullptr for pools
+         * @return a vector of buffer to send
+         * @throw runtime_exception if something goes wrong
+         */
+        [[maybe_unused]] PmrBuffers encode(const Package *package, Flags additionalFags, std::pmr::memory_resource *resource);
+
+        /**
+         * Encode a buffer contain a Happy GardenPI Head in a memory resource, never throw
+         * @param package package to send
+         * @param additionalFags additional flags to decorate package
+         * @param resource where allocate vector, buffers and their control blocks, nullptr for pools
+         * @return a vector of buffer to send or error
+         */
+        [[maybe_unused]] Result<PmrBuffers> tryEncode(const Package *package, Flags additionalFags, std::pmr::memory_resource *resource) noexcept;
+
+        /**
+         * @brief Frames written by encodeInto() in caller buffer
+         */
+        struct EncodedFrames final
+        {
+            /**
+             * @brief Offset of every frame in caller buffer
+             */
+            uint16_t offsets[HEAD_MAX_FRAMES] = {};
+
+            /**
+             * @brief Number of frames written
+             */
+            uint8_t count = 0;
+
+            /**
+             * @brief Total bytes written
+             */
+            size_t size = 0;
+
+            /**
+             * @brief Get size of a frame
+             * @param frame index of frame, less than count
+             * @return size of frame in bytes
+             */
+            [[nodiscard]] inline uint16_t getFrameSize(uint8_t frame) const noexcept
+            {
+                return static_cast<uint16_t>((frame + 1 < count ? offsets[frame + 1] : size) - offsets[frame]);
+            }
+        };
+
+        /**
+         * Get the size of buffer needed by encodeInto() for a package
+         * @param package package to send
+         * @return size in bytes of all frames
+         * @throw runtime_exception if package exceed HEAD_MAX_CHUNK
+         */
+        [[maybe_unused]] size_t getEncodedSize(const Package &package);
+
+        /**
+         * Get the size of buffer needed by tryEncodeInto() for a package with checksum of a link
+         * @tparam C checksum policy: Crc16Checksum, ModbusChecksum, CcittChecksum, Crc32Checksum, NoChecksum or
+         * Crc32cChecksum
+         * @param package package to send
+         * @return size in bytes of all frames
+         * @throw runtime_exception if package exceed HEAD_MAX_CHUNK
+         */
+        template<typename C>
+        [[maybe_unused]] size_t getEncodedSize(const Package &package);
+
+        /**
+         * Get the size of buffer needed by tryEncodeInto() for a package with checksum agreed by a link at runtime
+         * @param package package to send
+         * @param checksum of link
+         * @return size in bytes of all frames
+         * @throw runtime_exception if package exceed HEAD_MAX_CHUNK
+         */
+        [[maybe_unused]] size_t getEncodedSize(const Package &package, ChecksumType checksum);
+
+        /**
+         * Encode a package in a buffer owned by caller, all frames are written back to back and
+         * no allocation is done
+         * @param package package to send
+         * @param additionalFags additional flags to decorate package
+         * @param out buffer where write frames
+         * @param size of out, at least getEncodedSize()
+         * @return offsets of frames written in out
+         * @throw runtime_exception if something goes wrong
+         */
+        [[maybe_unused]] EncodedFrames encodeInto(const Package &package, Flags additionalFags, uint8_t *out, size_t size);
+
+        /**
+         * Encode a package in a buffer owned by caller, all frames are written back to back and
+         * no allocation is done
+         * @param package package to send
+         * @param out buffer where write frames
+         * @param size of out, at least getEncodedSize()
+         * @return offsets of frames written in out
+         * @throw runtime_exception if something goes wrong
+         */
+        [[maybe_unused]] inline EncodedFrames encodeInto(const Package &package, uint8_t *out, size_t size)
+        {
+            return encodeInto(package, NOT_SET, out, size);
+        }
+
+        /**
+         * Encode a package in a buffer owned by caller, never throw
+         * @param package package to send
+         * @param additionalFags additional flags to decorate package
+         * @param out buffer where write frames
+         * @param size of out, at least getEncodedSize()
+         * @return offsets of frames written in out or error
+         */
+        [[maybe_unused]] Result<EncodedFrames> tryEncodeInto(const Package &package, Flags additionalFags, uint8_t *out, size_t size) noexcept;
+
+        /**
+         * Encode a package in a buffer owned by caller with checksum of a link, never throw
+         * @tparam C checksum policy: Crc16Checksum, ModbusChecksum, CcittChecksum, Crc32Checksum, NoChecksum or
+         * Crc32cChecksum
+         * @param package package to send
+         * @param additionalFags additional flags to decorate package
+         * @param out buffer where write frames
+         * @param size of out, at least getEncodedSize<C>()
+         * @return offsets of frames written in out or error
+         */
+        template<typename C>
+        [[maybe_unused]] Result<EncodedFrames> tryEncodeInto(const Package &package, Flags additionalFags, uint8_t *out, size_t size) noexcept;
+
+        /**
+         * Encode a package in a buffer owned by caller with checksum agreed by a link at runtime, never throw
+         * @param package package to send
+         * @param additionalFags additional flags to decorate package
+         * @param out buffer where write frames
+         * @param size of out, at least getEncodedSize() with checksum
+         * @param checksum of link
+         * @return offsets of frames written in out or error
+         */
+        [[maybe_unused]] Result<EncodedFrames> tryEncodeInto(const Package &package, Flags additionalFags, uint8_t *out, size_t size,
+                                                             ChecksumType checksum) noexcept;
+
+        /**
+         * @brief All frames of a package back to back in one allocation with their offsets
+         * @note it can be moved but not copied
+         */
+        class EncodedMessage final
+        {
+        public:
+
+            /**
+             * @brief Iterator on frames of message as views
+             */
+            class Iterator final
+            {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = BytesView;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const BytesView *;
+                using reference = BytesView;
+
+                inline Iterator(const EncodedMessage *message, uint8_t frame) noexcept : message(message), frame(frame)
+                {
+                }
+
+                [[nodiscard]] inline BytesView operator*() const noexcept
+                {
+                    return (*message)[frame];
+                }
+
+                inline Iterator &operator++() noexcept
+                {
+                    frame++;
+                    return *this;
+                }
+
+                inline Iterator operator++(int) noexcept
+                {
+                    auto ret = *this;
+                    frame++;
+                    return ret;
+                }
+
+                [[nodiscard]] inline bool operator==(const Iterator &other) const noexcept
+                {
+                    return message == other.message && frame == other.frame;
+                }
+
+                [[nodiscard]] inline bool operator!=(const Iterator &other) const noexcept
+                {
+                    return !(*this == other);
+                }
+
+            private:
+                const EncodedMessage *message;
+                uint8_t frame;
+            };
+
+            EncodedMessage() = default;
+
+            /**
+             * @brief Take frames written in a buffer
+             * @param data buffer from allocateBuffer(), deleter with its size
+             * @param frames offsets of frames in data
+             */
+            inline EncodedMessage(std::unique_ptr<uint8_t[], BufferDeleter> &&data, const EncodedFrames &frames) noexcept
+                    : data(std::move(data)), frames(frames)
+            {
+            }
+
+            inline EncodedMessage(EncodedMessage &&other) noexcept : data(std::move(other.data)), frames(other.frames)
+            {
+                other.frames = {};
+            }
+
+            inline EncodedMessage &operator=(EncodedMessage &&other) noexcept
+            {
+                if (this != &other)
+                {
+                    data = std::move(other.data);
+                    frames = other.frames;
+                    other.frames = {};
+                }
+                return *this;
+            }
+
+            /**
+             * @brief Get a frame
+             * @param frame index of frame, less than getCount()
+             * @return view of frame, valid until self is alive
+             */
+            [[nodiscard]] inline BytesView operator[](uint8_t frame) const noexcept
+            {
+                return {&data[frames.offsets[frame]], frames.getFrameSize(frame)};
+            }
+
+            [[nodiscard]] inline Iterator begin() const noexcept
+            {
+                return {this, 0};
+            }
+
+            [[nodiscard]] inline Iterator end() const noexcept
+            {
+                return {this, frames.count};
+            }
+
+            /**
+             * @brief Get number of frames
+             * @return frames
+             */
+            [[nodiscard]] inline uint8_t getCount() const noexcept
+            {
+                return frames.count;
+            }
+
+            /**
+             * @brief Get all frames back to back, to send them with one write
+             * @return view of all frames
+             */
+            [[nodiscard]] inline BytesView getBytes() const noexcept
+            {
+                return {data.get(), frames.size};
+            }
+
+            /**
+             * @brief Get offsets of frames
+             * @return offsets
+             */
+            [[nodiscard]] inline const EncodedFrames &getFrames() const noexcept
+            {
+                return frames;
+            }
+
+        private:
+            /**
+             * @brief all frames
+             */
+            std::unique_ptr<uint8_t[], BufferDeleter> data;
+
+            /**
+             * @brief offsets of frames in data
+             */
+            EncodedFrames frames;
+        };
+
+        /**
+         * Encode a package in one buffer sized exactly for all its frames
+         * @param package package to send
+         * @param additionalFags additional flags to decorate package
+         * @return frames of package
+         * @throw runtime_exception if something goes wrong
+         */
+        [[maybe_unused]] EncodedMessage encodeMessage(const Package &package, Flags additionalFags = NOT_SET);
+
+        /**
+         * Encode a package in one buffer sized exactly for all its frames, never throw
+         * @param package package to send
+         * @param additionalFags additional flags to decorate package
+         * @return frames of package or error
+         */
+        [[maybe_unused]] Result<EncodedMessage> tryEncodeMessage(const Package &package, Flags additionalFags = NOT_SET) noexcept;
+
+        /**
+         * Encode a package in one buffer sized exactly for all its frames with checksum agreed by a link at
+         * runtime, never throw
+         * @param package package to send
+         * @param additionalFags additional flags to decorate package
+         * @param checksum of link
+         * @return frames of package or error
+         */
+        [[maybe_unused]] Result<EncodedMessage> tryEncodeMessage(const Package &package, Flags additionalFags, ChecksumType checksum) noexcept;
+
+        /**
+         * @brief Lazy encoder of a package, it generate one frame at a time so transmission can start at once
+         * with memory bounded to one frame
+         * @note package must live until all frames are generated, bytes before the tail of package longer than
+         * one chunk are serialized in a buffer at start
+         */
+        class StreamEncoder final
+        {
+        public:
+
+            /**
+             * @brief Construct an encoder
+             * @param checksum of link, both peers must agree on it
+             */
+            explicit StreamEncoder(ChecksumType checksum = ChecksumType::CRC16) noexcept : checksum(checksum)
+            {
+            }
+
+            /**
+             * @brief Start to encode a package, previous package is discarded
+             * @param package package to send
+             * @param additionalFags additional flags to decorate package
+             * @return error if something goes wrong
+             */
+            [[nodiscard]] ErrorCode start(const Package &package, Flags additionalFags = NOT_SET) noexcept;
+
+            /**
+             * @brief Generate next frame, FIN close package of more chunks
+             * @return frame or empty view when all frames are generated, frame is valid until the next call
+             */
+            [[nodiscard]] BytesView next() noexcept;
+
+            /**
+             * @brief Check if there are frames to generate
+             * @return true if next() return a frame
+             */
+            [[nodiscard]] inline bool hasNext() const noexcept
+            {
+                return package && frame < count;
+            }
+
+            /**
+             * @brief Get number of frames of package
+             * @return frames with FIN
+             */
+            [[nodiscard]] inline uint8_t getCount() const noexcept
+            {
+                return count;
+            }
+
+            /**
+             * @brief Discard package
+             */
+            void reset() noexcept;
+
+        private:
+
+            /**
+             * @brief frame generated
+             */
+            uint8_t buffer[HEAD_HEADER_SIZE + HEAD_MAX_PAYLOAD_SIZE + HEAD_MAX_CHECKSUM_SIZE] = {};
+
+            /**
+             * @brief package to encode
+             */
+            const Package *package = nullptr;
+
+            /**
+             * @brief last bytes of package serialized, framed from package memory
+             */
+            BytesView tail;
+
+            /**
+             * @brief bytes of package serialized before tail longer than first chunk
+             */
+            std::unique_ptr<uint8_t[], BufferDeleter> prefix;
+
+            /**
+             * @brief length of package serialized
+             */
+            size_t length = 0;
+
+            /**
+             * @brief length of bytes before tail
+             */
+            size_t headLength = 0;
+
+            /**
+             * @brief flags of package
+             */
+            uint8_t flags = NOT_SET;
+
+            /**
+             * @brief chunks of package, not include FIN
+             */
+            uint8_t chunks = 0;
+
+            /**
+             * @brief frames of package with FIN
+             */
+            uint8_t count = 0;
+
+            /**
+             * @brief next frame to generate
+             */
+            uint8_t frame = 0;
+
+            /**
+             * @brief checksum of link
+             */
+            ChecksumType checksum = ChecksumType::CRC16;
+        };
+
+#ifdef HGARDENPI_PROTOCOL_SCATTER
+        /**
+         * @brief Frames of a package as iovec segments ready for writev() or sendmsg(), headers and crc16 are
+         * owned by self, payload segments point to package memory
+         * @note self referenced, it can't be copied, package must live until segments are sent
+         * @note only crc16, links with other checksums use StreamEncoder or tryEncodeInto()
+         */
+        struct ScatterFrames final
+        {
+            /**
+             * @brief Header of every frame
+             */
+            uint8_t headers[HEAD_MAX_FRAMES][HEAD_HEADER_SIZE] = {};
+
+            /**
+             * @brief crc16 of every frame
+             */
+            uint8_t crcs[HEAD_MAX_FRAMES][HEAD_CRC_SIZE] = {};
+
+            /**
+             * @brief Bytes of package serialized before its tail, all bytes for packages without tail
+             */
+            uint8_t prefix[(HEAD_MAX_CHUNK + 1) * HEAD_MAX_PAYLOAD_SIZE];
+
+            /**
+             * @brief Segments of all frames: header, payload from prefix and tail, crc16
+             */
+            iovec iov[HEAD_MAX_FRAMES * 4] = {};
+
+            /**
+             * @brief Number of segments of all frames
+             */
+            int iovcnt = 0;
+
+            /**
+             * @brief Index of first segment of every frame
+             */
+            uint8_t frames[HEAD_MAX_FRAMES] = {};
+
+            /**
+             * @brief Number of frames
+             */
+            uint8_t count = 0;
+
+            /**
+             * @brief Total bytes of all frames
+             */
+            size_t size = 0;
+
+            ScatterFrames() = default;
+            ScatterFrames(const ScatterFrames &) = delete;
+            ScatterFrames &operator=(const ScatterFrames &) = delete;
+
+            /**
+             * @brief Get segments of a frame, to send frame by frame
+             * @param frame index of frame, less than count
+             * @return first segment of frame
+             */
+            [[nodiscard]] inline const iovec *getFrameIov(uint8_t frame) const noexcept
+            {
+                return &iov[frames[frame]];
+            }
+
+            /**
+             * @brief Get number of segments of a frame
+             * @param frame index of frame, less than count
+             * @return number of segments
+             */
+            [[nodiscard]] inline int getFrameIovcnt(uint8_t frame) const noexcept
+            {
+                return (frame + 1 < count ? frames[frame + 1] : iovcnt) - frames[frame];
+            }
+        };
+
+        /**
+         * Encode a package in iovec segments without copy its payload, a message of more chunks can be sent with
+         * one writev()
+         * @param package package to send, it must live until segments are sent
+         * @param additionalFags additional flags to decorate package
+         * @param ret segments of frames
+         * @throw runtime_exception if something goes wrong
+         */
+        [[maybe_unused]] void encodeScatter(const Package &package, Flags additionalFags, ScatterFrames &ret);
+
+        /**
+         * Encode a package in iovec segments without copy its payload, never throw
+         * @param package package to send, it must live until segments are sent
+         * @param additionalFags additional flags to decorate package
+         * @param ret segments of frames
+         * @return error if something goes wrong
+         */
+        [[maybe_unused]] [[nodiscard]] ErrorCode tryEncodeScatter(const Package &package, Flags additionalFags, ScatterFrames &ret) noexcept;
+#endif
+
+        /**
+        * Decode a buffer contain a Happy GardenPI Head, size of buffer is unknown so reads are not bounded
+        * @param data buffer, it must contain at least the whole frame declared by its header
         * @return Head instance
         * @throw runtime_exception if something goes wrong
+        * @note prefer decode(const uint8_t *, size_t) when size of buffer is known
         */
         [[maybe_unused]] Head::Ptr decode(const uint8_t *data);
 
+        /**
+        * Decode a buffer contain a Happy GardenPI Head, reads are bounded to size
+        * @param data buffer
+        * @param size of buffer
+        * @return Head instance
+        * @throw runtime_exception if something goes wrong or buffer is shorter than frame
+        * @note Head keeps crc16, frames of links with other checksums are viewed by tryView() with ChecksumType
+        */
+        [[maybe_unused]] Head::Ptr decode(const uint8_t *data, size_t size);
+
+        /**
+        * Decode a buffer contain a Happy GardenPI Head, never throw
+        * @param data buffer
+        * @param size of buffer
+        * @return Head instance or error, eg. ErrorCode::CRC_NOT_MATCH on a noisy line
+        * @note only frames with crc16, as decode()
+        */
+        [[maybe_unused]] Result<Head::Ptr> tryDecode(const uint8_t *data, size_t size) noexcept;
+
+        /**
+        * Decode a buffer contain a Happy GardenPI Head in a memory resource, reads are bounded to size
+        * @param data buffer
+        * @param size of buffer
+        * @param resource where allocate Head, its control block and payload, nullptr for pools
+        * @return Head instance
+        * @throw runtime_exception if something goes wrong or buffer is shorter than frame
+        */
+        [[maybe_unused]] Head::Ptr decode(const uint8_t *data, size_t size, std::pmr::memory_resource *resource);
+
+        /**
+        * Decode a buffer contain a Happy GardenPI Head in a memory resource, never throw
+        * @param data buffer
+        * @param size of buffer
+        * @param resource where allocate Head, its control block and payload, nullptr for pools
+        * @return Head instance or error
+        */
+        [[maybe_unused]] Result<Head::Ptr> tryDecode(const uint8_t *data, size_t size, std::pmr::memory_resource *resource) noexcept;
+
+        /**
+        * Check a buffer contain a Happy GardenPI Head and view it in place, no allocation and copy are done
+        * @param data buffer
+        * @param size of buffer
+        * @return view of Head, valid until data is alive
+        * @throw runtime_exception if something goes wrong or buffer is shorter than frame
+        */
+        [[maybe_unused]] HeadView view(const uint8_t *data, size_t size);
+
+        /**
+        * Check a buffer contain a Happy GardenPI Head and view it in place, never throw
+        * @param data buffer
+        * @param size of buffer
+        * @return view of Head or error, valid until data is alive
+        */
+        [[maybe_unused]] Result<HeadView> tryView(const uint8_t *data, size_t size) noexcept;
+
+        /**
+        * Check a buffer contain a Happy GardenPI Head with checksum of a link and view it in place, never throw
+        * @tparam C checksum policy: Crc16Checksum, ModbusChecksum, CcittChecksum, Crc32Checksum, NoChecksum or
+        * Crc32cChecksum
+        * @param data buffer
+        * @param size of buffer
+        * @return view of Head or error, valid until data is alive, crc16 is set only for checksum of 16 bits
+        */
+        template<typename C>
+        [[maybe_unused]] Result<HeadView> tryView(const uint8_t *data, size_t size) noexcept;
+
+        /**
+        * Check a buffer contain a Happy GardenPI Head with checksum agreed by a link at runtime and view it in
+        * place, never throw
+        * @param data buffer
+        * @param size of buffer
+        * @param checksum of link
+        * @return view of Head or error, valid until data is alive, crc16 is set only for checksum of 16 bits
+        */
+        [[maybe_unused]] Result<HeadView> tryView(const uint8_t *data, size_t size, ChecksumType checksum) noexcept;
+
+        /**
+        * Check version, flags and length of a Happy GardenPI Head in place without check crc16, for route a
+        * frame by flags and id before forward it, never throw
+        * @param data buffer
+        * @param size of buffer
+        * @return view of Head with crc16 received or error, valid until data is alive
+        * @note constant time, crc16 is checked by tryView()
+        */
+        [[maybe_unused]] Result<HeadView> tryPeek(const uint8_t *data, size_t size) noexcept;
+
+        /**
+        * Check version, flags and length of a Happy GardenPI Head with checksum of a link in place without check
+        * checksum, never throw
+        * @tparam C checksum policy: Crc16Checksum, ModbusChecksum, CcittChecksum, Crc32Checksum, NoChecksum or
+        * Crc32cChecksum
+        * @param data buffer
+        * @param size of buffer
+        * @return view of Head or error, valid until data is alive, crc16 is set only for checksum of 16 bits
+        */
+        template<typename C>
+        [[maybe_unused]] Result<HeadView> tryPeek(const uint8_t *data, size_t size) noexcept;
+
+        /**
+        * Check all frames back to back in a receive buffer and view them in place in one pass, never throw
+        * @param data receive buffer
+        * @param size of buffer
+        * @param frames views filled, valid until data is alive
+        * @param capacity max views in frames
+        * @param count number of views filled
+        * @param consumed bytes of frames viewed, a last frame shorter than its length is left after them
+        * @return error of frame at consumed, frames before it are valid
+        */
+        [[maybe_unused]] [[nodiscard]] ErrorCode tryViewBatch(const uint8_t *data, size_t size, HeadView *frames, size_t capacity,
+                                                             size_t &count, size_t &consumed) noexcept;
+
+        /**
+        * Check all frames back to back in a receive buffer with checksum of a link and view them in place in one
+        * pass, never throw
+        * @tparam C checksum policy: Crc16Checksum, ModbusChecksum, CcittChecksum, Crc32Checksum, NoChecksum or
+        * Crc32cChecksum
+        * @param data receive buffer
+        * @param size of buffer
+        * @param frames views filled, valid until data is alive
+        * @param capacity max views in frames
+        * @param count number of views filled
+        * @param consumed bytes of frames viewed, a last frame shorter than its length is left after them
+        * @return error of frame at consumed, frames before it are valid
+        */
+        template<typename C>
+        [[maybe_unused]] [[nodiscard]] ErrorCode tryViewBatch(const uint8_t *data, size_t size, HeadView *frames, size_t capacity,
+                                                             size_t &count, size_t &consumed) noexcept;
+
+        /**
+        * Check all frames back to back in a receive buffer with checksum agreed by a link at runtime and view them
+        * in place in one pass, never throw
+        * @param data receive buffer
+        * @param size of buffer
+        * @param frames views filled, valid until data is alive
+        * @param capacity max views in frames
+        * @param count number of views filled
+        * @param consumed bytes of frames viewed, a last frame shorter than its length is left after them
+        * @param checksum of link
+        * @return error of frame at consumed, frames before it are valid
+        */
+        [[maybe_unused]] [[nodiscard]] ErrorCode tryViewBatch(const uint8_t *data, size_t size, HeadView *frames, size_t capacity,
+                                                             size_t &count, size_t &consumed, ChecksumType checksum) noexcept;
+
+        /**
+        * Check a buffer contain a Happy GardenPI Head and view it in place
+        * @param data buffer
+        * @return view of Head, valid until data is alive
+        * @throw runtime_exception if something goes wrong or buffer is shorter than frame
+        */
+        [[maybe_unused]] inline HeadView view(const Buffer &data)
+        {
+            return view(data.first.get(), data.second);
+        }
+
         /**
         * Decode a buffer contain a Happy GardenPI Head
         * @param data buffer
@@ -73,7 +771,7 @@ namespace hgardenpi::protocol
         */
         [[maybe_unused]] inline Head::Ptr decode(const Buffer &data)
         {
-            return decode(data.first.get());
+            return decode(data.first.get(), data.second);
         }
 
         /**
@@ -88,7 +786,7 @@ namespace hgardenpi::protocol
             {
                 throw runtime_error("buffers empty");
             }
-            return decode(buffers[0].first.get());
+            return decode(buffers[0]);
         }
 
 
@@ -96,9 +794,19 @@ namespace hgardenpi::protocol
          * @brief Update id to buffer to identificate package
          * @param buffer will be modified
          * @param id id to assign
+         * @note crc16 is patched in constant time with crc16Patch(), a frame with crc16 not valid stay not valid
          */
         [[maybe_unused]] void updateIdToBufferEncoded(Buffer &buffer, uint8_t id);
 
+        /**
+         * @brief Update id to buffer with checksum agreed by a link at runtime
+         * @param buffer will be modified
+         * @param id id to assign
+         * @param checksum of link
+         * @note crc16 is patched as updateIdToBufferEncoded(Buffer &, uint8_t), other checksums are calculated again
+         */
+        [[maybe_unused]] void updateIdToBufferEncoded(Buffer &buffer, uint8_t id, ChecksumType checksum);
+
         /**
          * @brief Update id to buffer to identificate packages
          * @param buffers will be modified
@@ -112,6 +820,19 @@ namespace hgardenpi::protocol
             }
         }
 
+        /**
+         * @brief Update id to buffer to identificate packages
+         * @param buffers will be modified
+         * @param id id to assign
+         */
+        [[maybe_unused]] inline void updateIdToBufferEncoded(PmrBuffers &buffers, uint8_t id)
+        {
+            for (auto &&it: buffers)
+            {
+                updateIdToBufferEncoded(it, id);
+            }
+        }
+
         /**
          * Get lib version
          * @param major release reference
@@ -127,6 +848,58 @@ namespace hgardenpi::protocol
          */
         [[maybe_unused]] pair <Flags, Package::Ptr> composeDecodedChunks(const Heads &heads);
 
+        /**
+         * Compose a decoded package, never throw
+         * @param heads of package ptr
+         * @return a pair with type of package and pointer of them or error
+         */
+        [[maybe_unused]] Result<pair<Flags, Package::Ptr>> tryComposeDecodedChunks(const Heads &heads) noexcept;
+
+        /**
+         * Compose a decoded package in a memory resource
+         * @param heads of package ptr
+         * @param resource where allocate package, its fields and control block, nullptr for pools
+         * @return a pair with type of package and pointer of them
+         * @throw runtime_exception if something goes wrong
+         */
+        [[maybe_unused]] pair<Flags, Package::Ptr> composeDecodedChunks(const Heads &heads, std::pmr::memory_resource *resource);
+
+        /**
+         * Compose a decoded package in a memory resource, never throw
+         * @param heads of package ptr
+         * @param resource where allocate package, its fields and control block, nullptr for pools
+         * @return a pair with type of package and pointer of them or error
+         */
+        [[maybe_unused]] Result<pair<Flags, Package::Ptr>> tryComposeDecodedChunks(const Heads &heads, std::pmr::memory_resource *resource) noexcept;
+
+        /**
+         * Compose a decoded package in a memory resource
+         * @param heads of package ptr allocated in a memory resource
+         * @param resource where allocate package, its fields and control block, nullptr for pools
+         * @return a pair with type of package and pointer of them
+         * @throw runtime_exception if something goes wrong
+         */
+        [[maybe_unused]] pair<Flags, Package::Ptr> composeDecodedChunks(const PmrHeads &heads, std::pmr::memory_resource *resource);
+
+        /**
+         * Compose a decoded package in a memory resource, never throw
+         * @param heads of package ptr allocated in a memory resource
+         * @param resource where allocate package, its fields and control block, nullptr for pools
+         * @return a pair with type of package and pointer of them or error
+         */
+        [[maybe_unused]] Result<pair<Flags, Package::Ptr>> tryComposeDecodedChunks(const PmrHeads &heads, std::pmr::memory_resource *resource) noexcept;
+
+        /**
+         * Compose a package from payloads of its chunks, never throw
+         * @param flags of first chunk
+         * @param chunks payloads of chunks in order, FIN excluded
+         * @param count number of chunks
+         * @param resource where allocate package, its fields and control block, nullptr for pools
+         * @return a pair with type of package and pointer of them or error
+         */
+        [[maybe_unused]] Result<pair<Flags, Package::Ptr>> tryComposeChunks(uint8_t flags, const BytesView *chunks, uint8_t count,
+                                                                             std::pmr::memory_resource *resource = nullptr) noexcept;
+
         /**
          * Check if the data transmission is ended
          * @param head package
@@ -0,0 +1,259 @@
+// MIT License
+//
+// Copyright (c) 2021. Happy GardenPI
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+#include <hgardenpi-protocol/constants.hpp>
+#include <hgardenpi-protocol/head.hpp>
+#include <hgardenpi-protocol/result.hpp>
+#include <hgardenpi-protocol/packages/package.hpp>
+
+namespace hgardenpi::protocol
+{
+    inline namespace v2
+    {
+        using std::pair;
+
+        /**
+         * @brief Reassembler of chunked packages received interleaved from more sources, partial packages are
+         * tracked by source and Head::id and evicted by a timer wheel when stale
+         * @note memory is allocated once in constructor, every frame costs O(1)
+         */
+        class Reassembler final
+        {
+        public:
+
+            /**
+             * @brief Statistics of reassembled packages
+             */
+            struct Statistics
+            {
+                /**
+                 * @brief packages emitted
+                 */
+                size_t packages = 0;
+
+                /**
+                 * @brief chunks received more times
+                 */
+                size_t duplicates = 0;
+
+                /**
+                 * @brief partial packages evicted because stale
+                 */
+                size_t evicted = 0;
+
+                /**
+                 * @brief frames dropped because no free slot or incompatible chunks
+                 */
+                size_t dropped = 0;
+            };
+
+            /**
+             * @brief Construct a reassembler
+             * @param maxPackages max partial packages tracked at the same time, memory budget is
+             * maxPackages * getSlotSize()
+             * @param timeout ticks after last chunk received a partial package is evicted, unit is the same
+             * passed to advance() (eg. milliseconds or seconds)
+             * @throw runtime_exception if there is no memory
+             */
+            Reassembler(uint16_t maxPackages, uint32_t timeout);
+
+            Reassembler(const Reassembler &) = delete;
+            Reassembler &operator=(const Reassembler &) = delete;
+
+            ~Reassembler() noexcept;
+
+            /**
+             * @brief Push a frame, chunks are placed in arrival order
+             * @param source of frame, eg. address of device
+             * @param frame received
+             * @return package if complete, {NOT_SET, nullptr} if waiting more chunks, or error
+             */
+            [[nodiscard]] inline Result<pair<Flags, Package::Ptr>> push(uint32_t source, const HeadView &frame) noexcept
+            {
+                return push(source, frame, NO_CHUNK);
+            }
+
+            /**
+             * @brief Push a frame at its chunk index, known by caller transport, duplicated chunks are discarded
+             * @param source of frame, eg. address of device
+             * @param frame received
+             * @param chunk index of chunk in package, FIN frames ignore it
+             * @return package if complete, {NOT_SET, nullptr} if waiting more chunks, or error
+             */
+            [[nodiscard]] Result<pair<Flags, Package::Ptr>> push(uint32_t source, const HeadView &frame, uint8_t chunk) noexcept;
+
+            /**
+             * @brief Advance time and evict stale partial packages
+             * @param now current tick, monotonic and wrapping
+             * @return number of evicted partial packages
+             */
+            size_t advance(uint32_t now) noexcept;
+
+            /**
+             * @brief Get number of partial packages tracked
+             * @return partial packages
+             */
+            [[nodiscard]] inline uint16_t getPending() const noexcept
+            {
+                return pending;
+            }
+
+            /**
+             * @brief Get statistics of reassembler
+             * @return statistics
+             */
+            [[nodiscard]] inline const Statistics &getStatistics() const noexcept
+            {
+                return statistics;
+            }
+
+            /**
+             * @brief Get memory used by one partial package
+             * @return size in bytes
+             */
+            [[nodiscard]] static size_t getSlotSize() noexcept;
+
+        private:
+
+            /**
+             * @brief chunk index not passed, placed in arrival order
+             */
+            static constexpr const uint8_t NO_CHUNK = 0xFF;
+
+            /**
+             * @brief end of list of slots
+             */
+            static constexpr const uint16_t NO_SLOT = 0xFFFF;
+
+            /**
+             * @brief max buckets of timer wheel, longer timeout do more laps
+             */
+            static constexpr const uint32_t WHEEL_MAX_SIZE = 1024;
+
+            struct Slot;
+
+            /**
+             * @brief partial packages
+             */
+            Slot *slots = nullptr;
+
+            /**
+             * @brief open addressing table of slot index + 1 by source and id, 0 is empty
+             */
+            uint16_t *table = nullptr;
+
+            /**
+             * @brief size of table, power of 2
+             */
+            uint32_t tableSize = 0;
+
+            /**
+             * @brief first slot of every wheel bucket
+             */
+            uint16_t *wheel = nullptr;
+
+            /**
+             * @brief size of wheel, power of 2 bigger than timeout
+             */
+            uint32_t wheelSize = 0;
+
+            /**
+             * @brief ticks before eviction
+             */
+            uint32_t timeout = 0;
+
+            /**
+             * @brief last tick passed to advance()
+             */
+            uint32_t now = 0;
+
+            /**
+             * @brief first free slot
+             */
+            uint16_t freeSlot = NO_SLOT;
+
+            /**
+             * @brief partial packages tracked
+             */
+            uint16_t pending = 0;
+
+            /**
+             * @brief statistics of reassembler
+             */
+            Statistics statistics;
+
+            /**
+             * @brief Get position in table of a key
+             * @param key source and id
+             * @return first position to probe
+             */
+            [[nodiscard]] uint32_t hash(uint64_t key) const noexcept;
+
+            /**
+             * @brief Find the slot of a partial package
+             * @param key source and id
+             * @return slot or NO_SLOT
+             */
+            [[nodiscard]] uint16_t find(uint64_t key) const noexcept;
+
+            /**
+             * @brief Take a free slot for a new partial package
+             * @param key source and id
+             * @return slot or NO_SLOT if memory budget is exhausted
+             */
+            [[nodiscard]] uint16_t acquire(uint64_t key) noexcept;
+
+            /**
+             * @brief Give back a slot to free list
+             * @param slot to release
+             */
+            void release(uint16_t slot) noexcept;
+
+            /**
+             * @brief Add slot to timer wheel at now + timeout
+             * @param slot to schedule
+             */
+            void schedule(uint16_t slot) noexcept;
+
+            /**
+             * @brief Remove slot from timer wheel
+             * @param slot to unschedule
+             */
+            void unschedule(uint16_t slot) noexcept;
+
+            /**
+             * @brief Compose package of a complete slot and release it
+             * @param slot complete
+             * @return package or error
+             */
+            [[nodiscard]] Result<pair<Flags, Package::Ptr>> compose(uint16_t slot) noexcept;
+        };
+
+    }
+}
@@ -0,0 +1,196 @@
+// MIT License
+//
+// Copyright (c) 2021. Happy GardenPI
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+
+namespace hgardenpi::protocol
+{
+    inline namespace v2
+    {
+
+        /**
+         * @brief Error returned by non throwing API
+         */
+        enum class ErrorCode : uint8_t
+        {
+            /**
+             * @brief no error
+             */
+            OK = 0,
+            /**
+             * @brief package pointer is null
+             */
+            NULL_PACKAGE,
+            /**
+             * @brief package is not a known child of Package
+             */
+            NOT_A_PACKAGE,
+            /**
+             * @brief package not serializable, eg. a field exceed its max size
+             */
+            NOT_SERIALIZABLE,
+            /**
+             * @brief payload exceed HEAD_MAX_CHUNK chunks
+             */
+            DATA_TOO_BIG,
+            /**
+             * @brief caller buffer too small for frames
+             */
+            BUFFER_TOO_SMALL,
+            /**
+             * @brief received buffer shorter than frame
+             */
+            BUFFER_TOO_SHORT,
+            /**
+             * @brief protocol version not supported
+             */
+            WRONG_VERSION,
+            /**
+             * @brief flags out of range or more packages set
+             */
+            FLAGS_OUT_OF_RANGE,
+            /**
+             * @brief crc16 of frame not match
+             */
+            CRC_NOT_MATCH,
+            /**
+             * @brief allocation failed
+             */
+            NO_MEMORY,
+            /**
+             * @brief no head to compose
+             */
+            NO_HEAD,
+            /**
+             * @brief chunked package without FIN
+             */
+            PACKAGE_INCOMPLETE,
+            /**
+             * @brief chunk of a different package
+             */
+            INCOMPATIBLE_CHUNK,
+            /**
+             * @brief bytes of chunks not match length of package
+             */
+            PAYLOAD_MALFORMED,
+        };
+
+        /**
+         * @brief Get a description of error, the same of the exception thrown by throwing API
+         * @param error code
+         * @return static string
+         */
+        [[nodiscard]] const char *getErrorMessage(ErrorCode error) noexcept;
+
+        /**
+         * @brief Value or error returned by non throwing API
+         * @tparam T type of value, default constructible
+         */
+        template<typename T>
+        class Result final
+        {
+            T value{};
+            ErrorCode error = ErrorCode::OK;
+
+        public:
+            inline Result(T &&value) noexcept(std::is_nothrow_move_constructible_v<T>) : value(std::move(value))
+            {
+            }
+
+            inline Result(const T &value) noexcept(std::is_nothrow_copy_constructible_v<T>) : value(value)
+            {
+            }
+
+            inline Result(ErrorCode error) noexcept : error(error)
+            {
+            }
+
+            /**
+             * @brief Check if there is a value
+             * @return true if no error
+             */
+            [[nodiscard]] inline bool hasValue() const noexcept
+            {
+                return error == ErrorCode::OK;
+            }
+
+            inline explicit operator bool() const noexcept
+            {
+                return error == ErrorCode::OK;
+            }
+
+            /**
+             * @brief Get error
+             * @return ErrorCode::OK if there is a value
+             */
+            [[nodiscard]] inline ErrorCode getError() const noexcept
+            {
+                return error;
+            }
+
+            /**
+             * @brief Get value
+             * @return value, default constructed if there is an error
+             */
+            [[nodiscard]] inline T &getValue() & noexcept
+            {
+                return value;
+            }
+
+            [[nodiscard]] inline const T &getValue() const & noexcept
+            {
+                return value;
+            }
+
+            [[nodiscard]] inline T &&getValue() && noexcept
+            {
+                return std::move(value);
+            }
+
+            inline T &operator*() & noexcept
+            {
+                return value;
+            }
+
+            inline const T &operator*() const & noexcept
+            {
+                return value;
+            }
+
+            inline T *operator->() noexcept
+            {
+                return &value;
+            }
+
+            inline const T *operator->() const noexcept
+            {
+                return &value;
+            }
+        };
+
+    }
+}
@@ -0,0 +1,178 @@
+// MIT License
+//
+// Copyright (c) 2021. Happy GardenPI
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+#include <hgardenpi-protocol/constants.hpp>
+#include <hgardenpi-protocol/checksum.hpp>
+
+namespace hgardenpi::protocol
+{
+    inline namespace v2
+    {
+        using std::pair;
+
+        /**
+         * @brief Incremental decoder of a byte stream (serial, TCP...), it's fed with arbitrary slices of bytes
+         * and return complete frames with checksum of link checked
+         * @note at most one partial frame is buffered, after a corruption the decoder resynchronize to the next
+         * valid head
+         * @note acknowledges of Transport, ACK without package and 1 byte of payload, are frames too
+         */
+        class StreamDecoder final
+        {
+        public:
+
+            /**
+             * @brief Statistics of decoded stream
+             */
+            struct Statistics
+            {
+                /**
+                 * @brief frames emitted
+                 */
+                size_t frames = 0;
+
+                /**
+                 * @brief frames discarded because checksum not match
+                 */
+                size_t crcErrors = 0;
+
+                /**
+                 * @brief bytes discarded while resynchronize
+                 */
+                size_t droppedBytes = 0;
+            };
+
+            /**
+             * @brief Construct a decoder
+             * @param checksum of link, both peers must agree on it
+             */
+            explicit StreamDecoder(ChecksumType checksum = ChecksumType::CRC16) noexcept;
+
+            /**
+             * @brief Feed decoder with a slice of bytes
+             * @param data slice of stream
+             * @param size of slice
+             * @param onFrame callable as onFrame(const uint8_t *frame, uint16_t size) for every complete frame,
+             * frame is valid only inside the call
+             * @return number of frames emitted
+             */
+            template<typename F>
+            size_t feed(const uint8_t *data, size_t size, F &&onFrame)
+            {
+                size_t ret = 0;
+                for (auto frame = next(data, size); frame.first; frame = next(data, size))
+                {
+                    onFrame(frame.first, frame.second);
+                    ret++;
+                }
+                return ret;
+            }
+
+            /**
+             * @brief Consume bytes until a frame is complete
+             * @param data slice of stream, it will be moved after consumed bytes
+             * @param size of slice, it will be decreased of consumed bytes
+             * @return frame and its size, or {nullptr, 0} when all bytes are consumed without complete a frame;
+             * frame is valid until the next call
+             */
+            [[nodiscard]] pair<const uint8_t *, uint16_t> next(const uint8_t *&data, size_t &size) noexcept;
+
+            /**
+             * @brief Discard partial frame buffered
+             */
+            void reset() noexcept;
+
+            /**
+             * @brief Get number of bytes buffered of partial frame
+             * @return bytes buffered
+             */
+            [[nodiscard]] inline size_t getBuffered() const noexcept
+            {
+                return length - emitted;
+            }
+
+            /**
+             * @brief Get statistics of decoded stream
+             * @return statistics
+             */
+            [[nodiscard]] inline const Statistics &getStatistics() const noexcept
+            {
+                return statistics;
+            }
+
+            /**
+             * @brief Get checksum of link
+             * @return checksum checked on frames
+             */
+            [[nodiscard]] inline ChecksumType getChecksum() const noexcept
+            {
+                return checksum;
+            }
+
+        private:
+
+            /**
+             * @brief buffer of partial frame
+             */
+            uint8_t buffer[HEAD_HEADER_SIZE + HEAD_MAX_PAYLOAD_SIZE + HEAD_MAX_CHECKSUM_SIZE] = {};
+
+            /**
+             * @brief bytes in buffer
+             */
+            size_t length = 0;
+
+            /**
+             * @brief size of frame returned from buffer, to discard at the next call
+             */
+            size_t emitted = 0;
+
+            /**
+             * @brief statistics of stream
+             */
+            Statistics statistics;
+
+            /**
+             * @brief checksum of link
+             */
+            ChecksumType checksum = ChecksumType::CRC16;
+
+            /**
+             * @brief size of checksum of link
+             */
+            uint8_t checksumSize = HEAD_CRC_SIZE;
+
+            /**
+             * @brief Remove bytes from the begin of buffer
+             * @param bytes to remove
+             */
+            void shift(size_t bytes) noexcept;
+        };
+
+    }
+}
@@ -0,0 +1,334 @@
+// MIT License
+//
+// Copyright (c) 2021. Happy GardenPI
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <utility>
+
+#include <hgardenpi-protocol/constants.hpp>
+#include <hgardenpi-protocol/checksum.hpp>
+#include <hgardenpi-protocol/head.hpp>
+#include <hgardenpi-protocol/result.hpp>
+#include <hgardenpi-protocol/packages/package.hpp>
+
+namespace hgardenpi::protocol
+{
+    inline namespace v2
+    {
+        using std::pair;
+
+        /**
+         * @brief default frames sent and not acknowledged
+         */
+        constexpr const inline uint8_t TRANSPORT_DEFAULT_WINDOW = 16;
+
+        /**
+         * @brief max frames sent and not acknowledged, half of Head::id space for selective repeat
+         */
+        constexpr const inline uint8_t TRANSPORT_MAX_WINDOW = 128;
+
+        /**
+         * @brief Reliable and ordered transport of packages with a sliding window of frames and selective repeat,
+         * every frame has its sequence number in Head::id and it is acknowledged one by one
+         * @note acknowledge is a frame with only ACK flag, Head::id of frame acknowledged and one byte of
+         * payload with Head::id of next frame expected in order, all frames before it are acknowledged too
+         * @note only frames not acknowledged before retransmission timeout are sent again, timeout is adapted
+         * to round trip time of acknowledges not sent again (Jacobson/Karels and Karn algorithms)
+         * @note one peer for transport, ticks are monotonic and wrapping, unit is chosen by caller
+         * (eg. milliseconds), memory of window is allocated once in constructor
+         */
+        class Transport final
+        {
+        public:
+
+            /**
+             * @brief Statistics of transport
+             */
+            struct Statistics
+            {
+                /**
+                 * @brief frames sent the first time
+                 */
+                size_t sent = 0;
+
+                /**
+                 * @brief frames sent again after timeout
+                 */
+                size_t retransmitted = 0;
+
+                /**
+                 * @brief frames acknowledged by peer
+                 */
+                size_t acknowledged = 0;
+
+                /**
+                 * @brief frames received more times
+                 */
+                size_t duplicates = 0;
+
+                /**
+                 * @brief frames received out of window
+                 */
+                size_t dropped = 0;
+            };
+
+            /**
+             * @brief Construct a transport
+             * @param window frames sent and not acknowledged, rounded up to power of 2 and bounded to
+             * TRANSPORT_MAX_WINDOW, peer must have the same
+             * @param timeout ticks of retransmission timeout before the first round trip time is measured
+             * @param maxTimeout max ticks of retransmission timeout, also with exponential backoff
+             * @param checksum of frames and acknowledges, peer must have the same
+             * @throw runtime_exception if there is no memory
+             */
+            explicit Transport(uint8_t window = TRANSPORT_DEFAULT_WINDOW, uint32_t timeout = 1000, uint32_t maxTimeout = 60000,
+                               ChecksumType checksum = ChecksumType::CRC16);
+
+            Transport(const Transport &) = delete;
+            Transport &operator=(const Transport &) = delete;
+
+            ~Transport() noexcept;
+
+            /**
+             * @brief Encode a package and queue its frames to send
+             * @param package to send
+             * @param additionalFags flags added to package flag
+             * @return error if package can't be encoded
+             */
+            [[nodiscard]] ErrorCode send(const Package &package, Flags additionalFags = NOT_SET) noexcept;
+
+            /**
+             * @brief Generate next frame to write to peer: acknowledges first, then frames with timeout expired,
+             * then frames queued if window is not full
+             * @param now current tick
+             * @return frame or empty view if there is nothing to send, frame is valid until the next call
+             */
+            [[nodiscard]] BytesView poll(uint32_t now) noexcept;
+
+            /**
+             * @brief Receive a frame of peer, acknowledges move window and frames are buffered until in order
+             * @param data frame
+             * @param size of buffer
+             * @param now current tick
+             * @return error if frame is not valid
+             */
+            [[nodiscard]] ErrorCode receive(const uint8_t *data, size_t size, uint32_t now) noexcept;
+
+            /**
+             * @brief Take next package received in order
+             * @return package, {NOT_SET, nullptr} if waiting more frames, or error if frames of package can't be
+             * composed
+             */
+            [[nodiscard]] Result<pair<Flags, Package::Ptr>> pop() noexcept;
+
+            /**
+             * @brief Check if all frames are sent and acknowledged
+             * @return true if there is nothing to send
+             */
+            [[nodiscard]] inline bool isIdle() const noexcept
+            {
+                return queue.empty() && sendBase == nextId;
+            }
+
+            /**
+             * @brief Get current retransmission timeout
+             * @return ticks before a frame not acknowledged is sent again
+             */
+            [[nodiscard]] inline uint32_t getTimeout() const noexcept
+            {
+                return timeout;
+            }
+
+            /**
+             * @brief Get statistics of transport
+             * @return statistics
+             */
+            [[nodiscard]] inline const Statistics &getStatistics() const noexcept
+            {
+                return statistics;
+            }
+
+            /**
+             * @brief Get checksum of link
+             * @return checksum of frames and acknowledges
+             */
+            [[nodiscard]] inline ChecksumType getChecksum() const noexcept
+            {
+                return checksum;
+            }
+
+        private:
+
+            struct SendSlot;
+
+            struct ReceiveSlot;
+
+            /**
+             * @brief frames encoded waiting window
+             */
+            std::deque<Buffer> queue;
+
+            /**
+             * @brief frames sent and not acknowledged, indexed by Head::id & mask
+             */
+            SendSlot *sendSlots = nullptr;
+
+            /**
+             * @brief frames received not taken by pop(), indexed by Head::id & mask
+             */
+            ReceiveSlot *receiveSlots = nullptr;
+
+            /**
+             * @brief payloads of chunks of package taken by pop()
+             */
+            uint8_t *chunks = nullptr;
+
+            /**
+             * @brief views of chunks of package taken by pop()
+             */
+            BytesView views[HEAD_MAX_CHUNK + 1] = {};
+
+            /**
+             * @brief acknowledge generated
+             */
+            uint8_t ack[HEAD_HEADER_SIZE + 1 + HEAD_MAX_CHECKSUM_SIZE] = {};
+
+            /**
+             * @brief Head::id of frames received out of order to acknowledge
+             */
+            uint8_t acks[TRANSPORT_MAX_WINDOW] = {};
+
+            /**
+             * @brief retransmission timeout
+             */
+            uint32_t timeout = 0;
+
+            /**
+             * @brief max retransmission timeout
+             */
+            uint32_t maxTimeout = 0;
+
+            /**
+             * @brief smoothed round trip time, scaled by 8
+             */
+            uint32_t rtt = 0;
+
+            /**
+             * @brief round trip time variation, scaled by 4
+             */
+            uint32_t rttVariation = 0;
+
+            /**
+             * @brief first tick a frame not acknowledged expires
+             */
+            uint32_t deadline = 0;
+
+            /**
+             * @brief statistics of transport
+             */
+            Statistics statistics;
+
+            /**
+             * @brief checksum of link
+             */
+            ChecksumType checksum = ChecksumType::CRC16;
+
+            /**
+             * @brief frames sent and not acknowledged
+             */
+            uint8_t window = 0;
+
+            /**
+             * @brief window - 1
+             */
+            uint8_t mask = 0;
+
+            /**
+             * @brief Head::id of first frame not acknowledged
+             */
+            uint8_t sendBase = 0;
+
+            /**
+             * @brief Head::id of next frame sent the first time
+             */
+            uint8_t nextId = 0;
+
+            /**
+             * @brief Head::id of next frame expected in order
+             */
+            uint8_t receiveBase = 0;
+
+            /**
+             * @brief Head::id of next frame taken by pop()
+             */
+            uint8_t delivered = 0;
+
+            /**
+             * @brief first acknowledge in acks
+             */
+            uint8_t ackFirst = 0;
+
+            /**
+             * @brief acknowledges in acks
+             */
+            uint8_t ackCount = 0;
+
+            /**
+             * @brief chunks of package taken by pop()
+             */
+            uint8_t chunkCount = 0;
+
+            /**
+             * @brief flags of first chunk of package taken by pop()
+             */
+            uint8_t chunkFlags = NOT_SET;
+
+            /**
+             * @brief acknowledge of frames received in order to send
+             */
+            bool ackPending = false;
+
+            /**
+             * @brief a round trip time is measured
+             */
+            bool measured = false;
+
+            /**
+             * @brief Update retransmission timeout with a round trip time
+             * @param sample ticks from send to acknowledge of a frame not sent again
+             */
+            void measure(uint32_t sample) noexcept;
+
+            /**
+             * @brief Process an acknowledge of peer
+             * @param frame acknowledge
+             * @param now current tick
+             */
+            void acknowledge(const HeadView &frame, uint32_t now) noexcept;
+        };
+
+    }
+}
@@ -0,0 +1,140 @@
+// MIT License
+//
+// Copyright (c) 2021. Happy GardenPI
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace hgardenpi::protocol
+{
+    inline namespace v2
+    {
+
+        /**
+         * @brief Calculate CRC16 of frames, same result of libcrc crc_16(), the fastest implementation supported
+         * by cpu is selected at first call
+         * @param data bytes
+         * @param size number of bytes
+         * @param crc value of previous bytes, to calculate crc16 of data split in more buffers
+         * @return crc16
+         */
+        [[nodiscard]] uint16_t crc16(const uint8_t *data, size_t size, uint16_t crc = 0) noexcept;
+
+        /**
+         * @brief Calculate CRC16 with slicing-by-8 tables generated at compile time, portable implementation
+         * @param data bytes
+         * @param size number of bytes
+         * @param crc value of previous bytes, to calculate crc16 of data split in more buffers
+         * @return crc16
+         */
+        [[nodiscard]] uint16_t crc16Table(const uint8_t *data, size_t size, uint16_t crc = 0) noexcept;
+
+        /**
+         * @brief Calculate CRC-CCITT with slicing-by-8 tables generated at compile time, same result of libcrc
+         * crc_ccitt_ffff()
+         * @param data bytes
+         * @param size number of bytes
+         * @param crc value of previous bytes, to calculate crc of data split in more buffers
+         * @return crc
+         */
+        [[nodiscard]] uint16_t crcCcitt(const uint8_t *data, size_t size, uint16_t crc = 0xFFFF) noexcept;
+
+        /**
+         * @brief Calculate CRC32 (IEEE 802.3) with slicing-by-8 tables generated at compile time
+         * @param data bytes
+         * @param size number of bytes
+         * @param crc value of previous bytes, to calculate crc32 of data split in more buffers
+         * @return crc32
+         */
+        [[nodiscard]] uint32_t crc32(const uint8_t *data, size_t size, uint32_t crc = 0) noexcept;
+
+        /**
+         * @brief Calculate CRC32C (Castagnoli polynomial), the fastest implementation supported by cpu is selected
+         * at first call
+         * @param data bytes
+         * @param size number of bytes
+         * @param crc value of previous bytes, to calculate crc32c of data split in more buffers
+         * @return crc32c
+         */
+        [[nodiscard]] uint32_t crc32c(const uint8_t *data, size_t size, uint32_t crc = 0) noexcept;
+
+        /**
+         * @brief Calculate CRC32C with slicing-by-8 tables generated at compile time, portable implementation
+         * @param data bytes
+         * @param size number of bytes
+         * @param crc value of previous bytes, to calculate crc32c of data split in more buffers
+         * @return crc32c
+         */
+        [[nodiscard]] uint32_t crc32cTable(const uint8_t *data, size_t size, uint32_t crc = 0) noexcept;
+
+        /**
+         * @brief Calculate CRC32C with crc32 instructions, SSE4.2 on x86-64 and CRC extension on ARMv8
+         * @param data bytes
+         * @param size number of bytes
+         * @param crc value of previous bytes, to calculate crc32c of data split in more buffers
+         * @return crc32c
+         * @note call only if crc32cHardwareSupported() otherwise the result of crc32cTable() is returned
+         */
+        [[nodiscard]] uint32_t crc32cHardware(const uint8_t *data, size_t size, uint32_t crc = 0) noexcept;
+
+        /**
+         * @brief Check if cpu support crc32 instructions used by crc32cHardware()
+         * @return true if supported
+         */
+        [[nodiscard]] bool crc32cHardwareSupported() noexcept;
+
+        /**
+         * @brief max bytes after a byte changed patched by crc16Patch() in constant time
+         */
+        constexpr const inline uint16_t CRC16_PATCH_MAX_DISTANCE = 256;
+
+        /**
+         * @brief Update crc16 after a byte is changed without calculate it again, crc16 is linear so the old crc16
+         * is corrected with the crc16 of the change followed by zero bytes, read from a table for distance
+         * @param crc crc16 of bytes before change
+         * @param delta old byte xor new byte
+         * @param distance number of bytes after the changed byte, constant time up to CRC16_PATCH_MAX_DISTANCE
+         * @return crc16 of bytes after change
+         */
+        [[nodiscard]] uint16_t crc16Patch(uint16_t crc, uint8_t delta, size_t distance) noexcept;
+
+        /**
+         * @brief Calculate CRC16 folding 128 bits blocks with carry-less multiply, PCLMULQDQ on x86-64 and
+         * PMULL on ARMv8
+         * @param data bytes
+         * @param size number of bytes
+         * @param crc value of previous bytes, to calculate crc16 of data split in more buffers
+         * @return crc16
+         * @note call only if crc16ClmulSupported() otherwise the result of crc16Table() is returned
+         */
+        [[nodiscard]] uint16_t crc16Clmul(const uint8_t *data, size_t size, uint16_t crc = 0) noexcept;
+
+        /**
+         * @brief Check if cpu support carry-less multiply used by crc16Clmul()
+         * @return true if supported
+         */
+        [[nodiscard]] bool crc16ClmulSupported() noexcept;
+
+    }
+}
@@ -0,0 +1,319 @@
+// MIT License
+//
+// Copyright (c) 2021. Happy GardenPI
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <hgardenpi-protocol/bulktransfer.hpp>
+
+#include <cstring>
+using namespace std;
+
+namespace hgardenpi::protocol
+{
+    inline namespace v2
+    {
+
+        /**
+         * @brief Fill header and checksum of a frame of session, payload must be already in place
+         * @param frame to fill
+         * @param flags of frame
+         * @param id of session
+         * @param length of payload
+         * @param checksum of link
+         * @return frame size
+         */
+        static uint16_t fillFrame(uint8_t *frame, uint8_t flags, uint8_t id, uint8_t length, ChecksumType checksum) noexcept
+        {
+            frame[0] = flags;
+            frame[1] = id;
+            frame[2] = length;
+
+            //checksum of version and flags + id + length + payload
+            return HEAD_HEADER_SIZE + length + fillChecksum(checksum, frame, HEAD_HEADER_SIZE + length);
+        }
+
+        /**
+         * @brief Write an offset little endian whatever the byte order of host
+         * @param buffer where write BULK_OFFSET_SIZE bytes
+         * @param offset to write
+         */
+        static inline void writeOffset(uint8_t *buffer, uint32_t offset) noexcept
+        {
+            for (uint8_t i = 0; i < BULK_OFFSET_SIZE; i++)
+            {
+                buffer[i] = static_cast<uint8_t>(offset >> (i * 8));
+            }
+        }
+
+        /**
+         * @brief Read an offset little endian whatever the byte order of host
+         * @param buffer with BULK_OFFSET_SIZE bytes
+         * @return offset
+         */
+        static inline uint32_t readOffset(const uint8_t *buffer) noexcept
+        {
+            uint32_t ret = 0;
+            for (uint8_t i = 0; i < BULK_OFFSET_SIZE; i++)
+            {
+                ret |= static_cast<uint32_t>(buffer[i]) << (i * 8);
+            }
+            return ret;
+        }
+
+        /**
+         * @brief Check if a tick is reached, ticks are wrapping
+         * @param now current tick
+         * @param tick to check
+         * @return true if now is tick or after it
+         */
+        static inline bool isReached(uint32_t now, uint32_t tick) noexcept
+        {
+            return static_cast<int32_t>(now - tick) >= 0;
+        }
+
+        BulkSender::BulkSender(uint8_t id, uint16_t window, uint32_t timeout, ChecksumType checksum) noexcept
+                : timeout(timeout ? timeout : 1), window(window ? window : 1), id(id), checksum(checksum)
+        {
+        }
+
+        ErrorCode BulkSender::start(const uint8_t *data, uint32_t size, uint32_t offset) noexcept
+        {
+            if (!data || offset > size)
+            {
+                return ErrorCode::PAYLOAD_MALFORMED;
+            }
+
+            this->data = data;
+            this->size = size;
+            sent = offset;
+            acknowledged = offset;
+            finished = false;
+            complete = false;
+            progress = true;
+
+            return ErrorCode::OK;
+        }
+
+        BytesView BulkSender::poll(uint32_t now) noexcept
+        {
+            if (!data || complete)
+            {
+                return {};
+            }
+
+            //timer restart at every progress of receiver, or when nothing is in flight
+            if (progress || (sent == acknowledged && !finished))
+            {
+                progress = false;
+                deadline = now + timeout;
+            }
+            else if (isReached(now, deadline))
+            {
+                //no acknowledge in time, frames or acknowledge are lost
+                rewind();
+                deadline = now + timeout;
+            }
+
+            return next();
+        }
+
+        BytesView BulkSender::next() noexcept
+        {
+            if (!data || complete)
+            {
+                return {};
+            }
+
+            if (sent < size)
+            {
+                //frames not acknowledged fill the window
+                if ((sent - acknowledged + BULK_MAX_DATA - 1) / BULK_MAX_DATA >= window)
+                {
+                    return {};
+                }
+
+                size_t length = BULK_MAX_DATA;
+                writeOffset(&buffer[HEAD_HEADER_SIZE], sent);
+                if (size - sent >= BULK_MAX_DATA)
+                {
+                    //constant length of full frames is copied with vector moves, bounded lengths as slow rep movs
+                    memcpy(&buffer[HEAD_HEADER_SIZE + BULK_OFFSET_SIZE], &data[sent], BULK_MAX_DATA);
+                }
+                else
+                {
+                    length = size - sent;
+                    memcpy(&buffer[HEAD_HEADER_SIZE + BULK_OFFSET_SIZE], &data[sent], length);
+                }
+                sent += length;
+
+                return {buffer, fillFrame(buffer, BLK, id, static_cast<uint8_t>(BULK_OFFSET_SIZE + length), checksum)};
+            }
+
+            if (!finished)
+            {
+                //close transfer with total size and no data
+                finished = true;
+                writeOffset(&buffer[HEAD_HEADER_SIZE], size);
+
+                return {buffer, fillFrame(buffer, BLK, id, BULK_OFFSET_SIZE, checksum)};
+            }
+
+            return {};
+        }
+
+        ErrorCode BulkSender::acknowledge(const HeadView &frame) noexcept
+        {
+            if (frame.id != id || frame.flags != (BLK | ACK))
+            {
+                return ErrorCode::INCOMPATIBLE_CHUNK;
+            }
+            if (frame.length != BULK_OFFSET_SIZE + 1)
+            {
+                return ErrorCode::PAYLOAD_MALFORMED;
+            }
+
+            uint32_t offset = readOffset(frame.payload.data);
+            if (offset > size)
+            {
+                return ErrorCode::PAYLOAD_MALFORMED;
+            }
+
+            const uint8_t status = frame.payload[BULK_OFFSET_SIZE];
+            if (status == BULK_ACK_COMPLETE)
+            {
+                if (offset != size)
+                {
+                    return ErrorCode::PAYLOAD_MALFORMED;
+                }
+                acknowledged = size;
+                complete = true;
+                return ErrorCode::OK;
+            }
+
+            if (offset > acknowledged)
+            {
+                acknowledged = offset;
+                progress = true;
+            }
+
+            //receiver miss a frame or it has more bytes than sent, eg. after resume
+            if (status == BULK_ACK_RESEND || acknowledged > sent)
+            {
+                rewind();
+            }
+
+            return ErrorCode::OK;
+        }
+
+        void BulkSender::rewind() noexcept
+        {
+            sent = acknowledged;
+            finished = false;
+        }
+
+        BulkReceiver::BulkReceiver(uint8_t id, uint16_t window, uint32_t offset, ChecksumType checksum) noexcept
+                : offset(offset), threshold(window > 1 ? window / 2 : 1), id(id), checksum(checksum)
+        {
+        }
+
+        Result<BytesView> BulkReceiver::receive(const HeadView &frame) noexcept
+        {
+            if (frame.id != id || frame.flags != BLK)
+            {
+                return ErrorCode::INCOMPATIBLE_CHUNK;
+            }
+            if (frame.length < BULK_OFFSET_SIZE)
+            {
+                return ErrorCode::PAYLOAD_MALFORMED;
+            }
+
+            uint32_t at = readOffset(frame.payload.data);
+
+            //frame without data close transfer
+            if (frame.length == BULK_OFFSET_SIZE)
+            {
+                if (at < offset)
+                {
+                    return ErrorCode::PAYLOAD_MALFORMED;
+                }
+
+                //all data received or ask the missing ones
+                complete = at == offset;
+                resend = !complete;
+                pending = true;
+                return BytesView();
+            }
+
+            BytesView ret = {&frame.payload.data[BULK_OFFSET_SIZE], static_cast<size_t>(frame.length - BULK_OFFSET_SIZE)};
+            if (at == offset)
+            {
+                if (ret.size > UINT32_MAX - offset)
+                {
+                    return ErrorCode::PAYLOAD_MALFORMED;
+                }
+
+                offset += ret.size;
+                gap = false;
+                if (++received >= threshold)
+                {
+                    pending = true;
+                }
+                return ret;
+            }
+
+            if (at > offset)
+            {
+                //ask once to send again from first byte missed, next frames of window are discarded
+                if (!gap)
+                {
+                    gap = true;
+                    resend = true;
+                    pending = true;
+                }
+                return BytesView();
+            }
+
+            //duplicated, acknowledge could be lost
+            pending = true;
+            return BytesView();
+        }
+
+        BytesView BulkReceiver::acknowledge() noexcept
+        {
+            pending = false;
+            received = 0;
+
+            writeOffset(&buffer[HEAD_HEADER_SIZE], offset);
+            if (complete)
+            {
+                buffer[HEAD_HEADER_SIZE + BULK_OFFSET_SIZE] = BULK_ACK_COMPLETE;
+            }
+            else
+            {
+                buffer[HEAD_HEADER_SIZE + BULK_OFFSET_SIZE] = resend ? BULK_ACK_RESEND : BULK_ACK_RECEIVED;
+            }
+            resend = false;
+
+            return {buffer, fillFrame(buffer, BLK | ACK, id, BULK_OFFSET_SIZE + 1, checksum)};
+        }
+
+    }
+}
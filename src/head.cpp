@@ -34,28 +34,95 @@
 #include <hgardenpi-protocol/packages/error.hpp>
 #include <hgardenpi-protocol/utilities/stringutils.hpp>
 
+#include <array>
+using namespace std;
+
 namespace hgardenpi::protocol
 {
     inline namespace v2
     {
 
+        /**
+         * @brief Function to deserialize a package type
+         */
+        typedef Package *(*Deserializer)(const HeadView &head, uint8_t chunkOfPackage, std::pmr::memory_resource *resource);
+
+        template<typename T>
+        static Package *deserializePackage(const HeadView &head, uint8_t chunkOfPackage, std::pmr::memory_resource *resource)
+        {
+            return T::deserialize(head, chunkOfPackage, resource);
+        }
+
+        /**
+         * @brief Generate the table of deserializers indexed by flags byte, CKN and ACK not change the package
+         * type and combinations of more packages are not valid
+         * @return jump table
+         */
+        static constexpr array<Deserializer, 256> generateDeserializers() noexcept
+        {
+            array<Deserializer, 256> ret{};
+            for (uint16_t flags = 0; flags < ret.size(); flags++)
+            {
+                switch (flags & HEAD_PACKAGE_MASK)
+                {
+                    case Aggregation::FLAG:
+                        ret[flags] = &deserializePackage<Aggregation>;
+                        break;
+                    case Error::FLAG:
+                        ret[flags] = &deserializePackage<Error>;
+                        break;
+                    case Data::FLAG:
+                        ret[flags] = &deserializePackage<Data>;
+                        break;
+                    case Finish::FLAG:
+                        ret[flags] = &deserializePackage<Finish>;
+                        break;
+                    case Station::FLAG:
+                        ret[flags] = &deserializePackage<Station>;
+                        break;
+                    case Synchro::FLAG:
+                        ret[flags] = &deserializePackage<Synchro>;
+                        break;
+                    default:
+                        ret[flags] = nullptr;
+                        break;
+                }
+            }
+            return ret;
+        }
+
+        /**
+         * @brief Deserializers indexed by flags byte
+         */
+        static constexpr const array<Deserializer, 256> DESERIALIZERS = generateDeserializers();
+
         [[nodiscard]] Package *Head::deserialize(uint8_t chunkOfPackage) const
         {
-            Package * ret = nullptr;
+            return deserialize(chunkOfPackage, nullptr);
+        }
+
+        [[nodiscard]] Package *Head::deserialize(uint8_t chunkOfPackage, std::pmr::memory_resource *resource) const
+        {
+            return deserialize(HeadView{
+                    .version = version,
+                    .flags = flags,
+                    .id = id,
+                    .length = length,
+                    .payload = {payload, length},
+                    .crc16 = crc16
+            }, chunkOfPackage, resource);
+        }
+
+        [[nodiscard]] Package *Head::deserialize(const HeadView &head, uint8_t chunkOfPackage)
+        {
+            return deserialize(head, chunkOfPackage, nullptr);
+        }
+
+        [[nodiscard]] Package *Head::deserialize(const HeadView &head, uint8_t chunkOfPackage, std::pmr::memory_resource *resource)
+        {
             //check which child package was packaged
-            if ((flags & AGG) == AGG) //is Flags::AGG package
-                ret = Aggregation::deserialize(payload, length, chunkOfPackage);
-            else if ((flags & ERR) == ERR) //is Flags::ERR package
-                ret = Error::deserialize(payload, length, chunkOfPackage);
-            else if ((flags & DAT) == DAT) //is Flags::DAT package
-                ret = Data::deserialize(payload, length, chunkOfPackage);
-            else if ((flags & FIN) == FIN) //is Flags::FIN package
-                ret = Finish::deserialize(payload, length, chunkOfPackage);
-            else if ((flags & STA) == STA) //is Flags::STA package
-                ret = Station::deserialize(payload, length, chunkOfPackage);
-            else if ((flags & SYN) == SYN) //is Flags::SYN package
-                ret = Synchro::deserialize(payload, length, chunkOfPackage);
-            return ret;
+            auto deserializer = DESERIALIZERS[head.flags];
+            return deserializer ? deserializer(head, chunkOfPackage, resource) : nullptr;
         }
 
         string Head::getHexPayload() const noexcept
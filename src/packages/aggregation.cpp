@@ -73,165 +73,125 @@ namespace hgardenpi::protocol
             HGARDENPI_PROTOCOL_SETTER(end, endLen)
         }
 
-        Buffer Aggregation::serialize() const
+        size_t Aggregation::getSerializedSize() const noexcept
         {
-            uint8_t *buf = nullptr;
             size_t size = 0;
 
-            //calculate size fo allocate buffer
             size += sizeof(uint8_t); //id
             size += sizeof(uint8_t); //descriptionSize
-            if (description && descriptionLen > static_cast<uint8_t>(numeric_limits<uint8_t>::max()))
-            {
-                size += static_cast<int>(numeric_limits<uint8_t>::max());
-            } else
-            {
-                size += descriptionLen;
-            }
+            size += descriptionLen; //description
             size += sizeof(bool); //manual
             size += sizeof(Schedule); //schedule
             size += sizeof(uint8_t); //startSize
-            if (start && startLen > static_cast<uint8_t>(numeric_limits<uint8_t>::max()))
-            {
-                size += static_cast<int>(numeric_limits<uint8_t>::max());
-            } else
-            {
-                size += startLen;
-            }
-            size += sizeof(endLen); //endSize
-            if (end && endLen > static_cast<uint8_t>(numeric_limits<uint8_t>::max()))
-            {
-                size += static_cast<int>(numeric_limits<uint8_t>::max());
-            } else
-            {
-                size += endLen;
-            }
+            size += startLen; //start
+            size += sizeof(uint8_t); //endSize
+            size += endLen; //end
             size += sizeof(bool); //sequential
             size += sizeof(uint16_t); //weight
-            size += sizeof(Status); //status
 
-            //alloc buffer
-            buf = new(nothrow) uint8_t[size];
-            if (!buf)
+            return size;
+        }
+
+        bool Aggregation::serializeInto(uint8_t *buf, size_t bufSize) const noexcept
+        {
+            if (!buf || bufSize < getSerializedSize())
             {
-                throw runtime_error("no memory for serialize");
+                return false;
             }
-            memset(buf, 0, size);
-
 
-            size = 0;
+            size_t size = 0;
             memcpy(buf + size, &id, sizeof(uint8_t));
             size += sizeof(uint8_t);
             memcpy(buf + size, &descriptionLen, sizeof(uint8_t));
             size += sizeof(uint8_t);
-            if (descriptionLen)
-            {
-                if (description && descriptionLen > static_cast<uint8_t>(numeric_limits<uint8_t>::max()))
-                {
-                    memcpy(buf + size, description, static_cast<uint8_t>(numeric_limits<uint8_t>::max()));
-                    size += static_cast<uint8_t>(numeric_limits<uint8_t>::max());
-                } else
-                {
-                    memcpy(buf + size, description, descriptionLen);
-                    size += descriptionLen * sizeof(uint8_t);
-                }
-            }
+            description.copyTo(buf + size, descriptionLen);
+            size += descriptionLen * sizeof(uint8_t);
             memcpy(buf + size, &manual, sizeof(bool));
             size += sizeof(bool);
             memcpy(buf + size, &schedule, sizeof(schedule));
             size += sizeof(schedule);
             memcpy(buf + size, &startLen, sizeof(uint8_t));
             size += sizeof(uint8_t);
-            if (startLen)
-            {
-                if (start && startLen > static_cast<uint8_t>(numeric_limits<uint8_t>::max()))
-                {
-                    memcpy(buf + size, start, static_cast<uint8_t>(numeric_limits<uint8_t>::max()));
-                    size += static_cast<uint8_t>(numeric_limits<uint8_t>::max());
-                } else
-                {
-                    memcpy(buf + size, start, startLen);
-                    size += startLen * sizeof(uint8_t);
-                }
-            }
+            start.copyTo(buf + size, startLen);
+            size += startLen * sizeof(uint8_t);
             memcpy(buf + size, &endLen, sizeof(uint8_t));
             size += sizeof(uint8_t);
-            if (endLen)
-            {
-                if (end && endLen > static_cast<uint8_t>(numeric_limits<uint8_t>::max()))
-                {
-                    memcpy(buf + size, end, static_cast<uint8_t>(numeric_limits<uint8_t>::max()));
-                    size += static_cast<uint8_t>(numeric_limits<uint8_t>::max());
-                } else
-                {
-                    memcpy(buf + size, end, endLen);
-                    size += endLen * sizeof(uint8_t);
-                }
-            }
+            end.copyTo(buf + size, endLen);
+            size += endLen * sizeof(uint8_t);
             memcpy(buf + size, &sequential, sizeof(bool));
             size += sizeof(bool);
             memcpy(buf + size, &weight, sizeof(uint16_t));
-            size += sizeof(uint16_t);
-            memcpy(buf + size, &status, sizeof(status));
 
-            return {shared_ptr<uint8_t []>(buf), size};
+            return true;
         }
 
-        Aggregation * Aggregation::deserialize(const uint8_t *buffer, uint8_t len, uint8_t)
+        Aggregation * Aggregation::deserialize(const uint8_t *buffer, uint8_t len, uint8_t chunkOfPackage, std::pmr::memory_resource *resource)
         {
             if (!buffer)
             {
                 return nullptr;
             }
-            size_t size = 0;
 
-            //cout << stringHexToString(buffer, len) << endl;
+            auto *ret = create<Aggregation>(resource);
+            if (!deserializeInto(*ret, buffer, len, chunkOfPackage))
+            {
+                destroy(ret);
+                return nullptr;
+            }
+
+            return ret;
+        }
 
-            auto *ret = new Aggregation;
-            if (!ret)
+        bool Aggregation::deserializeInto(Aggregation &existing, const uint8_t *buffer, uint8_t length, uint8_t)
+        {
+            if (!buffer)
             {
-                throw runtime_error("no memory for aggregation");
+                return false;
             }
-            ret->id = buffer[size];
-            size += sizeof(uint8_t); //id
-            ret->descriptionLen = buffer[size];
-            size += sizeof(uint8_t); //descriptionSize
-            if (ret->descriptionLen > 0)
+
+            //check embedded lengths before touch existing, a malformed payload leaves it unchanged
+            size_t descriptionOffset = sizeof(uint8_t); //id
+            if (!fieldInBounds(descriptionOffset, sizeof(uint8_t), length))
             {
-                ret->description = new char[ret->descriptionLen];
-                memset(ret->description, 0, ret->descriptionLen);
-                memcpy(ret->description, buffer + size, ret->descriptionLen);
-                size += ret->descriptionLen * sizeof(uint8_t); //description
+                return false;
             }
-            ret->manual = buffer[size];
-            size += sizeof(bool); //manual
-            memcpy(&ret->schedule, buffer + size, sizeof(schedule));
-            size += sizeof(Schedule); //Schedule
-            ret->startLen = buffer[size];
-            size += sizeof(uint8_t); //startSize
-            if (ret->startLen > 0)
+            size_t startOffset = descriptionOffset + sizeof(uint8_t) + buffer[descriptionOffset] + sizeof(bool) + sizeof(Schedule);
+            if (!fieldInBounds(startOffset, sizeof(uint8_t), length))
             {
-                ret->start = new char[ret->startLen];
-                memset(ret->start, 0, ret->startLen);
-                memcpy(ret->start, buffer + size, ret->startLen);
-                size += ret->startLen * sizeof(uint8_t); //start
+                return false;
             }
-            ret->endLen = buffer[size];
-            size += sizeof(uint8_t); //endSize
-            if (ret->endLen > 0)
+            size_t endOffset = startOffset + sizeof(uint8_t) + buffer[startOffset];
+            if (!fieldInBounds(endOffset, sizeof(uint8_t), length))
+            {
+                return false;
+            }
+            //sequential and weight, status is not serialized
+            if (!fieldInBounds(endOffset + sizeof(uint8_t) + buffer[endOffset], sizeof(bool) + sizeof(uint16_t), length))
             {
-                ret->end = new char[ret->endLen];
-                memset(ret->end, 0, ret->endLen);
-                memcpy(ret->end, buffer + size, ret->endLen);
-                size += ret->endLen * sizeof(uint8_t); //end
+                return false;
             }
-            ret->sequential = buffer[size];
-            size += sizeof(uint8_t); //sequential
-            ret->weight = buffer[size];
-            size += sizeof(uint8_t); //weight
-            memcpy(&ret->status, buffer + size, sizeof(Status));
 
-            return ret;
+            size_t size = 0;
+
+            existing.id = buffer[size];
+            size += sizeof(uint8_t); //id
+            existing.copyField(existing.description, existing.descriptionLen, buffer + size + sizeof(uint8_t), buffer[size]);
+            size += sizeof(uint8_t) + existing.descriptionLen; //descriptionSize and description
+            existing.manual = buffer[size];
+            size += sizeof(bool); //manual
+            memcpy(&existing.schedule, buffer + size, sizeof(schedule));
+            size += sizeof(Schedule); //Schedule
+            existing.copyField(existing.start, existing.startLen, buffer + size + sizeof(uint8_t), buffer[size]);
+            size += sizeof(uint8_t) + existing.startLen; //startSize and start
+            existing.copyField(existing.end, existing.endLen, buffer + size + sizeof(uint8_t), buffer[size]);
+            size += sizeof(uint8_t) + existing.endLen; //endSize and end
+            existing.sequential = buffer[size];
+            size += sizeof(bool); //sequential
+            memcpy(&existing.weight, buffer + size, sizeof(uint16_t));
+            //status is not serialized, a received package is not active
+            existing.status = Status::UNACTIVE;
+
+            return true;
         }
     }
 }
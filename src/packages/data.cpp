@@ -41,78 +41,189 @@ namespace hgardenpi::protocol
     inline namespace v2
     {
 
-        Buffer Data::serialize() const
+        Data::Data(const Data &other) : Package(other)
         {
-            Buffer ret;
+            *this = other;
+        }
 
-            ret.second = length + sizeof(length);
+        Data &Data::operator=(const Data &other)
+        {
+            if (this != &other)
+            {
+                Package::operator=(other);
+                setPayload(reinterpret_cast<const uint8_t *>(other.payload), other.payload ? other.length : static_cast<uint16_t>(0));
+                //length without payload, eg. decoded from a single frame
+                length = other.length;
+                copyField(chunk, chunkLength, reinterpret_cast<const uint8_t *>(other.chunk), other.chunkLength);
+            }
+            return *this;
+        }
 
-            //alloc memory
-            ret.first = shared_ptr<uint8_t []>(new(nothrow) uint8_t[ret.second]);
-            if (!ret.first)
+        size_t Data::getSerializedSize() const noexcept
+        {
+            return sizeof(length) + length;
+        }
+
+        bool Data::serializeInto(uint8_t *buffer, size_t size) const noexcept
+        {
+            if (!buffer || size < getSerializedSize())
             {
-                throw runtime_error("no memory for data");
+                return false;
             }
 
-            if (length > 0)
+            //copy data length
+            memcpy(buffer, &length, sizeof(length));
+
+            //copy data field to payload, without payload eg. decoded from a single frame bytes are written as 0
+            if (length > 0 && payload)
+            {
+                memcpy(buffer + sizeof(length), &payload[0], length);
+            }
+            else
             {
-                //copy error length
-                memcpy(ret.first.get(), &length, sizeof(length));
+                memset(buffer + sizeof(length), 0, length);
+            }
+
+            return true;
+        }
 
-                //copy error field to payload
-                memcpy(ret.first.get() + sizeof(length), &payload[0], length);
+        bool Data::serializeHeadInto(uint8_t *buffer, size_t size) const noexcept
+        {
+            if (getSerializedTail().size != length)
+            {
+                return serializeInto(buffer, size);
             }
 
-            //return Buffer
-            return ret;
+            if (!buffer || size < sizeof(length))
+            {
+                return false;
+            }
+
+            //only data length, payload is the tail
+            memcpy(buffer, &length, sizeof(length));
+
+            return true;
         }
 
-        Data * Data::deserialize(const uint8_t *buffer, uint8_t length, uint8_t chunkOfPackage)
+        Data * Data::deserialize(const uint8_t *buffer, uint8_t length, uint8_t chunkOfPackage, std::pmr::memory_resource *resource)
         {
             if (!buffer)
             {
                 return nullptr;
             }
-            auto cer = new (nothrow) Data;
-            if (!cer)
+
+            auto cer = create<Data>(resource);
+            if (!deserializeInto(*cer, buffer, length, chunkOfPackage))
+            {
+                destroy(cer);
+                return nullptr;
+            }
+
+            return cer;
+        }
+
+        bool Data::deserializeInto(Data &existing, const uint8_t *buffer, uint8_t length, uint8_t chunkOfPackage)
+        {
+            if (!buffer)
             {
-                throw runtime_error("no memory for cer");
+                return false;
             }
 
             if (chunkOfPackage == 0)
             {
+                if (length < sizeof(uint16_t))
+                {
+                    return false;
+                }
+
+                //payload of previous package has length of it
+                existing.resetPayload();
+
                 //set length of payload
-                memset(&cer->length, 0, sizeof(uint16_t));
-                memcpy(&cer->length, buffer, sizeof(uint16_t));
+                memcpy(&existing.length, buffer, sizeof(uint16_t));
 
-                cer->chunkLength = length - sizeof(uint16_t);
-                cer->chunk = new char[cer->chunkLength];
-                memset(cer->chunk, 0, cer->chunkLength);
-                memcpy(cer->chunk, &buffer[sizeof(uint16_t)], cer->chunkLength);
+                existing.copyField(existing.chunk, existing.chunkLength, &buffer[sizeof(uint16_t)], static_cast<uint8_t>(length - sizeof(uint16_t)));
             }
             else
             {
-                cer->chunkLength = length;
-                cer->chunk = new char[cer->chunkLength];
-                memset(cer->chunk, 0, cer->chunkLength);
-                memcpy(cer->chunk, buffer, cer->chunkLength);
+                existing.copyField(existing.chunk, existing.chunkLength, buffer, length);
             }
-            return cer;
+            return true;
         }
 
         string Data::getPayload() const noexcept
         {
-            HGARDENPI_PROTOCOL_GETTER(payload, length)
+            return payload ? string(payload, length) : string();
         }
 
         void Data::setPayload(const string &payload) noexcept
         {
-            HGARDENPI_PROTOCOL_SETTER(payload, length)
+            setPayload(reinterpret_cast<const uint8_t *>(payload.data()), static_cast<uint16_t>(payload.size()));
+        }
+
+        void Data::setPayload(const uint8_t *data, uint16_t size)
+        {
+            //adopted buffer is not allocated by allocateField()
+            if (payloadAdopted)
+            {
+                resetPayload();
+                length = 0;
+            }
+            copyField(payload, length, data, size);
+        }
+
+        void Data::adoptPayload(unique_ptr<uint8_t[]> &&data, uint16_t size) noexcept
+        {
+            resetPayload();
+            payloadAdopted = data != nullptr;
+            payload = reinterpret_cast<char *>(data.release());
+            length = payload ? size : 0;
+        }
+
+        unique_ptr<uint8_t[]> Data::releasePayload(uint16_t &size)
+        {
+            size = payload ? length : 0;
+            if (!payload)
+            {
+                return nullptr;
+            }
+
+            unique_ptr<uint8_t[]> ret;
+            if (payloadAdopted || !resource)
+            {
+                //allocated with new[], ownership is given as is
+                ret.reset(reinterpret_cast<uint8_t *>(payload));
+                payload = nullptr;
+                payloadAdopted = false;
+            }
+            else
+            {
+                ret.reset(new uint8_t[length]);
+                memcpy(ret.get(), payload, length);
+                resetPayload();
+            }
+            length = 0;
+
+            return ret;
+        }
+
+        void Data::resetPayload() noexcept
+        {
+            if (payloadAdopted)
+            {
+                delete[] reinterpret_cast<uint8_t *>(payload);
+                payload = nullptr;
+                payloadAdopted = false;
+            }
+            else
+            {
+                deallocateField(payload, length);
+            }
         }
 
         string Data::getChunk() const noexcept
         {
-            HGARDENPI_PROTOCOL_GETTER(chunk, chunkLength)
+            return chunk ? string(chunk, chunkLength) : string();
         }
 
     }
@@ -43,64 +43,106 @@ namespace hgardenpi::protocol
     inline namespace v2
     {
 
-        Buffer Error::serialize() const
+        Error::Error(const Error &other) : Package(other)
         {
-            Buffer ret;
+            *this = other;
+        }
+
+        Error &Error::operator=(const Error &other)
+        {
+            if (this != &other)
+            {
+                Package::operator=(other);
+                length = other.length;
+                msg = other.msg;
+                copyField(chunk, chunkLength, reinterpret_cast<const uint8_t *>(other.chunk), other.chunkLength);
+            }
+            return *this;
+        }
 
-            ret.second = length + sizeof(length);
+        size_t Error::getSerializedSize() const noexcept
+        {
+            return sizeof(length) + length;
+        }
 
-            //alloc memory
-            ret.first = shared_ptr<uint8_t []>(new(nothrow) uint8_t[ret.second]);
-            if (!ret.first)
+        bool Error::serializeInto(uint8_t *buffer, size_t size) const noexcept
+        {
+            if (!buffer || size < getSerializedSize())
             {
-                throw runtime_error("no memory for data");
+                return false;
             }
 
-            if (length > 0)
+            //copy error length
+            memcpy(buffer, &length, sizeof(length));
+
+            //copy error field to payload
+            msg.copyTo(buffer + sizeof(length), length);
+
+            return true;
+        }
+
+        bool Error::serializeHeadInto(uint8_t *buffer, size_t size) const noexcept
+        {
+            if (getSerializedTail().size != length)
             {
-                //copy error length
-                memcpy(ret.first.get(), &length, sizeof(length));
+                return serializeInto(buffer, size);
+            }
 
-                //copy error field to payload
-                memcpy(ret.first.get() + sizeof(length), &msg[0], length);
+            if (!buffer || size < sizeof(length))
+            {
+                return false;
             }
 
-            //return Buffer
-            return ret;
+            //only error length, message is the tail
+            memcpy(buffer, &length, sizeof(length));
+
+            return true;
         }
 
-        Error * Error::deserialize(const uint8_t *buffer, uint8_t length , uint8_t chunkOfPackage)
+        Error * Error::deserialize(const uint8_t *buffer, uint8_t length , uint8_t chunkOfPackage, std::pmr::memory_resource *resource)
         {
             if (!buffer)
             {
                 return nullptr;
             }
-            auto err = new(nothrow) Error;
-            if (!err)
+
+            auto err = create<Error>(resource);
+            if (!deserializeInto(*err, buffer, length, chunkOfPackage))
+            {
+                destroy(err);
+                return nullptr;
+            }
+
+            return err;
+        }
+
+        bool Error::deserializeInto(Error &existing, const uint8_t *buffer, uint8_t length, uint8_t chunkOfPackage)
+        {
+            if (!buffer)
             {
-                throw runtime_error("no memory for err");
+                return false;
             }
 
             if (chunkOfPackage == 0)
             {
-                //set length of error and payload
-                memset(&err->length, 0, sizeof(uint16_t));
-                memcpy(&err->length, buffer, sizeof(uint16_t));
+                if (length < sizeof(uint16_t))
+                {
+                    return false;
+                }
+
+                //msg of previous package not match new length
+                existing.msg.clear();
 
-                err->chunkLength = length - sizeof(uint16_t);
-                err->chunk = new char[err->chunkLength];
-                memset(err->chunk, 0, err->chunkLength);
-                memcpy(err->chunk, &buffer[sizeof(uint16_t)], err->chunkLength);
+                //set length of msg
+                memcpy(&existing.length, buffer, sizeof(uint16_t));
 
+                existing.copyField(existing.chunk, existing.chunkLength, &buffer[sizeof(uint16_t)], static_cast<uint8_t>(length - sizeof(uint16_t)));
             }
             else
             {
-                err->chunkLength = length;
-                err->chunk = new char[err->chunkLength];
-                memset(err->chunk, 0, err->chunkLength);
-                memcpy(err->chunk, buffer, err->chunkLength);
+                existing.copyField(existing.chunk, existing.chunkLength, buffer, length);
             }
-            return err;
+            return true;
         }
 
         string Error::getMsg() const noexcept
@@ -0,0 +1,172 @@
+// MIT License
+//
+// Copyright (c) 2021. Happy GardenPI
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "hgardenpi-protocol/packages/package.hpp"
+
+#include <stdexcept>
+#include <new>
+using namespace std;
+
+#include "hgardenpi-protocol/pool.hpp"
+#include "hgardenpi-protocol/packages/aggregation.hpp"
+#include "hgardenpi-protocol/packages/data.hpp"
+#include "hgardenpi-protocol/packages/error.hpp"
+#include "hgardenpi-protocol/packages/finish.hpp"
+#include "hgardenpi-protocol/packages/station.hpp"
+#include "hgardenpi-protocol/packages/synchro.hpp"
+
+namespace hgardenpi::protocol
+{
+    inline namespace v2
+    {
+
+        void *Package::operator new(size_t size)
+        {
+            if (auto ptr = poolAllocate(size))
+            {
+                return ptr;
+            }
+            throw bad_alloc();
+        }
+
+        void *Package::operator new(size_t size, const nothrow_t &) noexcept
+        {
+            return poolAllocate(size);
+        }
+
+        void Package::operator delete(void *ptr, size_t size) noexcept
+        {
+            poolDeallocate(ptr, size);
+        }
+
+        /**
+         * @brief Get size of a package type
+         * @param flag of package
+         * @return sizeof of package type
+         */
+        static size_t getPackageSize(Flags flag) noexcept
+        {
+            switch (flag)
+            {
+                case Aggregation::FLAG:
+                    return sizeof(Aggregation);
+                case Data::FLAG:
+                    return sizeof(Data);
+                case Error::FLAG:
+                    return sizeof(Error);
+                case Finish::FLAG:
+                    return sizeof(Finish);
+                case Station::FLAG:
+                    return sizeof(Station);
+                case Synchro::FLAG:
+                    return sizeof(Synchro);
+                default:
+                    return sizeof(Package);
+            }
+        }
+
+        void Package::destroy(Package *package) noexcept
+        {
+            if (!package)
+            {
+                return;
+            }
+
+            auto resource = package->resource;
+            if (!resource)
+            {
+                delete package;
+                return;
+            }
+
+            //size must be taken before destroy dynamic type
+            auto size = getPackageSize(package->getFlag());
+            package->~Package();
+            resource->deallocate(package, size);
+        }
+
+        char *Package::allocateField(size_t size) const
+        {
+            if (resource)
+            {
+                return static_cast<char *>(resource->allocate(size, alignof(char)));
+            }
+            //as uint8_t so it can be released to caller as unique_ptr<uint8_t[]>
+            return reinterpret_cast<char *>(new uint8_t[size]);
+        }
+
+        void Package::deallocateField(char *&field, size_t size) const noexcept
+        {
+            if (!field)
+            {
+                return;
+            }
+            if (resource)
+            {
+                resource->deallocate(field, size, alignof(char));
+            }
+            else
+            {
+                delete[] reinterpret_cast<uint8_t *>(field);
+            }
+            field = nullptr;
+        }
+
+        void Package::reuseField(char *&field, size_t fieldSize, size_t size) const
+        {
+            if (field && (size == fieldSize || (!resource && size < fieldSize)))
+            {
+                return;
+            }
+            deallocateField(field, fieldSize);
+            field = allocateField(size);
+        }
+
+        Buffer Package::serialize() const
+        {
+            Buffer ret;
+
+            ret.second = getSerializedSize();
+            if (ret.second == 0)
+            {
+                return {nullptr, 0};
+            }
+
+            //alloc memory
+            ret.first = shared_ptr<uint8_t []>(new(nothrow) uint8_t[ret.second]);
+            if (!ret.first)
+            {
+                throw runtime_error("no memory for serialize");
+            }
+
+            if (!serializeInto(ret.first.get(), ret.second))
+            {
+                throw runtime_error("package not serializable");
+            }
+
+            //return Buffer
+            return ret;
+        }
+
+    }
+}
@@ -63,84 +63,45 @@ namespace hgardenpi::protocol
             HGARDENPI_PROTOCOL_SETTER(description, descriptionLen)
         }
 
-        Buffer Station::serialize() const
+        size_t Station::getSerializedSize() const noexcept
         {
-
-            uint8_t *buf = nullptr;
             size_t size = 0;
 
-            //calculate size fo allocate buffer
             size += sizeof(uint8_t); //id
             size += sizeof(uint8_t); //nameLen
-            if (name && nameLen > static_cast<uint8_t>(numeric_limits<uint8_t>::max()))
-            {
-                size += static_cast<int>(numeric_limits<uint8_t>::max());
-            } else
-            {
-                size += nameLen;
-            }
-            size += sizeof(bool); //name
+            size += nameLen; //name
             size += sizeof(uint8_t); //descriptionLen
-            if (description && descriptionLen > static_cast<uint8_t>(numeric_limits<uint8_t>::max()))
-            {
-                size += static_cast<int>(numeric_limits<uint8_t>::max());
-            } else
-            {
-                size += descriptionLen;
-            }
-            size += sizeof(bool); //description
-
+            size += descriptionLen; //description
             size += sizeof(uint8_t); //relayNumber
             size += sizeof(uint32_t); //wateringTime
-
-            size += sizeof(bool); //wateringTimeLeft
-            size += sizeof(uint32_t); //weight
+            size += sizeof(uint32_t); //wateringTimeLeft
             size += sizeof(uint16_t); //weight
-            size += sizeof(Status); //status
 
-            //alloc buffer
-            buf = new(nothrow) uint8_t[size];
-            if (!buf)
+            return size;
+        }
+
+        bool Station::serializeInto(uint8_t *buf, size_t bufSize) const noexcept
+        {
+            if (!buf || bufSize < getSerializedSize())
             {
-                throw runtime_error("no memory for serialize");
+                return false;
             }
-            memset(buf, 0, size);
 
-            size = 0;
+            size_t size = 0;
             memcpy(buf + size, &id, sizeof(uint8_t));
             size += sizeof(uint8_t);
 
             memcpy(buf + size, &nameLen, sizeof(uint8_t));
             size += sizeof(uint8_t);
 
-            if (name)
-            {
-                if (name && nameLen > static_cast<uint8_t>(numeric_limits<uint8_t>::max()))
-                {
-                    memcpy(buf + size, name, static_cast<uint8_t>(numeric_limits<uint8_t>::max()));
-                    size += static_cast<uint8_t>(numeric_limits<uint8_t>::max());
-                } else
-                {
-                    memcpy(buf + size, name, nameLen);
-                    size += nameLen * sizeof(uint8_t);
-                }
-            }
+            name.copyTo(buf + size, nameLen);
+            size += nameLen * sizeof(uint8_t);
 
             memcpy(buf + size, &descriptionLen, sizeof(uint8_t));
             size += sizeof(uint8_t);
 
-            if (descriptionLen)
-            {
-                if (description && descriptionLen > static_cast<uint8_t>(numeric_limits<uint8_t>::max()))
-                {
-                    memcpy(buf + size, description, static_cast<uint8_t>(numeric_limits<uint8_t>::max()));
-                    size += static_cast<uint8_t>(numeric_limits<uint8_t>::max());
-                } else
-                {
-                    memcpy(buf + size, description, descriptionLen);
-                    size += descriptionLen * sizeof(uint8_t);
-                }
-            }
+            description.copyTo(buf + size, descriptionLen);
+            size += descriptionLen * sizeof(uint8_t);
 
             memcpy(buf + size, &relayNumber, sizeof(uint8_t));
             size += sizeof(uint8_t);
@@ -152,16 +113,71 @@ namespace hgardenpi::protocol
             size += sizeof(uint32_t);
 
             memcpy(buf + size, &weight, sizeof(uint16_t));
-            size += sizeof(uint16_t);
 
-            memcpy(buf + size, &status, sizeof(status));
+            return true;
+        }
 
-            return {shared_ptr<uint8_t []>(buf), size};
+        Station *Station::deserialize(const uint8_t *buffer, uint8_t length, uint8_t chunkOfPackage, std::pmr::memory_resource *resource)
+        {
+            if (!buffer)
+            {
+                return nullptr;
+            }
+
+            auto ret = create<Station>(resource);
+            if (!deserializeInto(*ret, buffer, length, chunkOfPackage))
+            {
+                destroy(ret);
+                return nullptr;
+            }
+
+            return ret;
         }
 
-        Station *Station::deserialize(const uint8_t *buffer, uint8_t, uint8_t)
+        bool Station::deserializeInto(Station &existing, const uint8_t *buffer, uint8_t length, uint8_t)
         {
-            return nullptr;
+            if (!buffer)
+            {
+                return false;
+            }
+
+            //check embedded lengths before touch existing, a malformed payload leaves it unchanged
+            size_t nameOffset = sizeof(uint8_t); //id
+            if (!fieldInBounds(nameOffset, sizeof(uint8_t), length))
+            {
+                return false;
+            }
+            size_t descriptionOffset = nameOffset + sizeof(uint8_t) + buffer[nameOffset];
+            if (!fieldInBounds(descriptionOffset, sizeof(uint8_t), length))
+            {
+                return false;
+            }
+            //relayNumber, wateringTime, wateringTimeLeft and weight, status is not serialized
+            if (!fieldInBounds(descriptionOffset + sizeof(uint8_t) + buffer[descriptionOffset],
+                               sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint16_t), length))
+            {
+                return false;
+            }
+
+            size_t size = 0;
+
+            existing.id = buffer[size];
+            size += sizeof(uint8_t); //id
+            existing.copyField(existing.name, existing.nameLen, buffer + size + sizeof(uint8_t), buffer[size]);
+            size += sizeof(uint8_t) + existing.nameLen; //nameLen and name
+            existing.copyField(existing.description, existing.descriptionLen, buffer + size + sizeof(uint8_t), buffer[size]);
+            size += sizeof(uint8_t) + existing.descriptionLen; //descriptionLen and description
+            existing.relayNumber = buffer[size];
+            size += sizeof(uint8_t); //relayNumber
+            memcpy(&existing.wateringTime, buffer + size, sizeof(uint32_t));
+            size += sizeof(uint32_t); //wateringTime
+            memcpy(&existing.wateringTimeLeft, buffer + size, sizeof(uint32_t));
+            size += sizeof(uint32_t); //wateringTimeLeft
+            memcpy(&existing.weight, buffer + size, sizeof(uint16_t));
+            //status is not serialized, a received package is not active
+            existing.status = Status::UNACTIVE;
+
+            return true;
         }
     }
 }
\ No newline at end of file
@@ -52,62 +52,72 @@ namespace hgardenpi::protocol
             HGARDENPI_PROTOCOL_SETTER(serial, length)
         }
 
-        Synchro *Synchro::deserialize(const uint8_t *buffer, uint8_t len, uint8_t)
+        Synchro *Synchro::deserialize(const uint8_t *buffer, uint8_t len, uint8_t chunkOfPackage, std::pmr::memory_resource *resource)
         {
             if (!buffer)
             {
                 return nullptr;
             }
-            auto syn = new(nothrow) Synchro;
-            if (!syn)
-            {
-                throw runtime_error("no memory for sin");
-            }
-
-            //set length of payload
-            memset(&syn->length, 0, sizeof(syn->length));
-            memcpy(&syn->length, buffer, sizeof(syn->length));
 
-            syn->serial = new(nothrow) char[syn->length];
-            if (!syn->serial)
+            auto syn = create<Synchro>(resource);
+            if (!deserializeInto(*syn, buffer, len, chunkOfPackage))
             {
-                throw runtime_error("no memory for serial");
+                destroy(syn);
+                return nullptr;
             }
-            memset(syn->serial, 0, syn->length);
-            memcpy(syn->serial, buffer + sizeof(syn->length), syn->length);
 
             return syn;
         }
 
-        Buffer Synchro::serialize() const
+        bool Synchro::deserializeInto(Synchro &existing, const uint8_t *buffer, uint8_t len, uint8_t)
         {
-            Buffer ret;
+            if (!buffer || len < sizeof(uint16_t))
+            {
+                return false;
+            }
 
-            if (length > HEAD_MAX_SERIAL_SIZE)
+            //set length of payload
+            uint16_t length = 0;
+            memcpy(&length, buffer, sizeof(length));
+            if (!fieldInBounds(sizeof(length), length, len))
             {
-                throw runtime_error("serial too long max 128 chars");
+                return false;
             }
 
-            ret.second = length + sizeof(length);
+            existing.copyField(existing.serial, existing.length, buffer + sizeof(length), length);
 
-            //alloc memory
-            ret.first = shared_ptr<uint8_t []>(new(nothrow) uint8_t[ret.second]);
-            if (!ret.first)
+            return true;
+        }
+
+        size_t Synchro::getSerializedSize() const noexcept
+        {
+            return sizeof(length) + length;
+        }
+
+        bool Synchro::serializeInto(uint8_t *buffer, size_t size) const noexcept
+        {
+            if (!buffer || size < getSerializedSize() || length > HEAD_MAX_SERIAL_SIZE)
             {
-                throw runtime_error("no memory for data");
+                return false;
             }
 
-            if (length > 0)
-            {
-                //copy syn length
-                memcpy(ret.first.get(), &length, sizeof(length));
+            //copy syn length
+            memcpy(buffer, &length, sizeof(length));
+
+            //copy syn field to payload
+            serial.copyTo(buffer + sizeof(length), length);
+
+            return true;
+        }
 
-                //copy syn field to payload
-                memcpy(ret.first.get() + sizeof(length), &serial[0], length);
+        Buffer Synchro::serialize() const
+        {
+            if (length > HEAD_MAX_SERIAL_SIZE)
+            {
+                throw runtime_error("serial too long max 128 chars");
             }
-            
-            //return Buffer
-            return ret;
+
+            return Package::serialize();
         }
 
     }
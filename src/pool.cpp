@@ -0,0 +1,309 @@
+// MIT License
+//
+// Copyright (c) 2021. Happy GardenPI
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <hgardenpi-protocol/pool.hpp>
+
+#include <cstddef>
+#include <cstring>
+using namespace std;
+
+namespace hgardenpi::protocol
+{
+    inline namespace v2
+    {
+
+        /**
+         * @brief Round a size to alignment of max_align_t
+         * @param size bytes
+         * @return size aligned
+         */
+        static constexpr size_t alignSize(size_t size) noexcept
+        {
+            return (size + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+        }
+
+        /**
+         * @brief Head of a slab, blocks follow it
+         */
+        struct alignas(max_align_t) Pool::Slab final
+        {
+            uint8_t *begin = nullptr;
+            uint8_t *end = nullptr;
+        };
+
+        /**
+         * @brief Free block, linked in free list
+         */
+        struct Pool::Block final
+        {
+            Block *next = nullptr;
+        };
+
+        Pool::Pool(size_t blockSize, size_t blocksPerSlab) noexcept : blocksPerSlab(blocksPerSlab ? blocksPerSlab : 1)
+        {
+            statistics.blockSize = alignSize(blockSize < sizeof(Block) ? sizeof(Block) : blockSize);
+        }
+
+        Pool::~Pool() noexcept
+        {
+            for (size_t i = 0; i < statistics.slabs; i++)
+            {
+                ::operator delete(slabs[i]);
+            }
+            ::operator delete(slabs);
+        }
+
+        void *Pool::allocate() noexcept
+        {
+            lock_guard<mutex> guard(lock);
+            if (!freeBlocks && !grow())
+            {
+                return nullptr;
+            }
+
+            auto ret = freeBlocks;
+            freeBlocks = freeBlocks->next;
+
+            statistics.used++;
+            statistics.allocations++;
+            if (statistics.used > statistics.peak)
+            {
+                statistics.peak = statistics.used;
+            }
+            return ret;
+        }
+
+        void Pool::deallocate(void *ptr) noexcept
+        {
+            if (!ptr)
+            {
+                return;
+            }
+
+            lock_guard<mutex> guard(lock);
+            auto block = static_cast<Block *>(ptr);
+            block->next = freeBlocks;
+            freeBlocks = block;
+            statistics.used--;
+        }
+
+        bool Pool::deallocateOwned(void *ptr) noexcept
+        {
+            if (!ptr)
+            {
+                return true;
+            }
+
+            lock_guard<mutex> guard(lock);
+            if (!isOwned(ptr))
+            {
+                return false;
+            }
+            auto block = static_cast<Block *>(ptr);
+            block->next = freeBlocks;
+            freeBlocks = block;
+            statistics.used--;
+            return true;
+        }
+
+        bool Pool::owns(const void *ptr) const noexcept
+        {
+            lock_guard<mutex> guard(lock);
+            return isOwned(ptr);
+        }
+
+        bool Pool::isOwned(const void *ptr) const noexcept
+        {
+            auto byte = static_cast<const uint8_t *>(ptr);
+
+            //last slab starting at or before byte
+            size_t low = 0;
+            size_t high = statistics.slabs;
+            while (low < high)
+            {
+                size_t middle = low + (high - low) / 2;
+                if (slabs[middle]->begin <= byte)
+                {
+                    low = middle + 1;
+                }
+                else
+                {
+                    high = middle;
+                }
+            }
+            return low > 0 && byte < slabs[low - 1]->end;
+        }
+
+        Pool::Statistics Pool::getStatistics() const noexcept
+        {
+            lock_guard<mutex> guard(lock);
+            return statistics;
+        }
+
+        bool Pool::grow() noexcept
+        {
+            if (statistics.slabs == slabsCapacity)
+            {
+                size_t capacity = slabsCapacity ? slabsCapacity * 2 : 8;
+                auto grown = static_cast<Slab **>(::operator new(capacity * sizeof(Slab *), nothrow));
+                if (!grown)
+                {
+                    return false;
+                }
+                if (slabs)
+                {
+                    memcpy(grown, slabs, statistics.slabs * sizeof(Slab *));
+                    ::operator delete(slabs);
+                }
+                slabs = grown;
+                slabsCapacity = capacity;
+            }
+
+            auto memory = static_cast<uint8_t *>(::operator new(sizeof(Slab) + blocksPerSlab * statistics.blockSize, nothrow));
+            if (!memory)
+            {
+                return false;
+            }
+
+            auto slab = new(memory) Slab;
+            slab->begin = memory + sizeof(Slab);
+            slab->end = slab->begin + blocksPerSlab * statistics.blockSize;
+
+            //keep slabs sorted by address
+            size_t i = statistics.slabs;
+            for (; i > 0 && slabs[i - 1]->begin > slab->begin; i--)
+            {
+                slabs[i] = slabs[i - 1];
+            }
+            slabs[i] = slab;
+
+            //link blocks in address order
+            for (size_t i = blocksPerSlab; i > 0; i--)
+            {
+                auto block = new(slab->begin + (i - 1) * statistics.blockSize) Block;
+                block->next = freeBlocks;
+                freeBlocks = block;
+            }
+
+            statistics.slabs++;
+            statistics.blocks += blocksPerSlab;
+            return true;
+        }
+
+        /**
+         * @brief Size of a slab of every pool
+         */
+        constexpr const inline size_t POOL_SLAB_SIZE = 16 * 1024;
+
+        /**
+         * @brief Get the pools used by library, they are never destroyed so blocks can be given back also
+         * during static destruction
+         * @return pools in order of POOL_BLOCK_SIZES
+         */
+        static Pool *getPools() noexcept
+        {
+            static auto pools = new(nothrow) Pool[POOL_BLOCK_SIZES.size()]{
+                    {POOL_BLOCK_SIZES[0], POOL_SLAB_SIZE / alignSize(POOL_BLOCK_SIZES[0])},
+                    {POOL_BLOCK_SIZES[1], POOL_SLAB_SIZE / alignSize(POOL_BLOCK_SIZES[1])},
+                    {POOL_BLOCK_SIZES[2], POOL_SLAB_SIZE / alignSize(POOL_BLOCK_SIZES[2])},
+                    {POOL_BLOCK_SIZES[3], POOL_SLAB_SIZE / alignSize(POOL_BLOCK_SIZES[3])},
+            };
+            return pools;
+        }
+
+        /**
+         * @brief Get the pool of the smallest block that contain size
+         * @param size bytes
+         * @return pool or nullptr if size is too big
+         */
+        static inline Pool *getPool(size_t size) noexcept
+        {
+            for (size_t i = 0; i < POOL_BLOCK_SIZES.size(); i++)
+            {
+                if (size <= POOL_BLOCK_SIZES[i])
+                {
+                    auto pools = getPools();
+                    return pools ? &pools[i] : nullptr;
+                }
+            }
+            return nullptr;
+        }
+
+        void *poolAllocate(size_t size) noexcept
+        {
+            if (auto pool = getPool(size))
+            {
+                return pool->allocate();
+            }
+            return ::operator new(size, nothrow);
+        }
+
+        void poolDeallocate(void *ptr, size_t size) noexcept
+        {
+            if (auto pool = getPool(size))
+            {
+                pool->deallocate(ptr);
+                return;
+            }
+            ::operator delete(ptr);
+        }
+
+        uint8_t *allocateBuffer(size_t size) noexcept
+        {
+            if (size > 0)
+            {
+                if (auto pool = getPool(size))
+                {
+                    return static_cast<uint8_t *>(pool->allocate());
+                }
+            }
+            return new(nothrow) uint8_t[size];
+        }
+
+        void deallocateBuffer(uint8_t *buffer, size_t size) noexcept
+        {
+            if (!buffer)
+            {
+                return;
+            }
+            //buffers can be also assigned by user with new[], only the pool of size can own it
+            if (auto pool = size > 0 ? getPool(size) : nullptr; pool && pool->deallocateOwned(buffer))
+            {
+                return;
+            }
+            delete[] buffer;
+        }
+
+        array<Pool::Statistics, POOL_BLOCK_SIZES.size()> getPoolStatistics() noexcept
+        {
+            array<Pool::Statistics, POOL_BLOCK_SIZES.size()> ret;
+            auto pools = getPools();
+            for (size_t i = 0; pools && i < ret.size(); i++)
+            {
+                ret[i] = pools[i].getStatistics();
+            }
+            return ret;
+        }
+
+    }
+}
@@ -39,7 +39,7 @@ using namespace std;
 #include <cmath>
 
 #include <hgardenpi-protocol/config.h>
-#include <hgardenpi-protocol/3thparts/libcrc/checksum.h>
+#include <hgardenpi-protocol/utilities/crcutils.hpp>
 #include <hgardenpi-protocol/packages/aggregation.hpp>
 #include <hgardenpi-protocol/packages/data.hpp>
 #include <hgardenpi-protocol/packages/finish.hpp>
@@ -52,339 +52,880 @@ namespace hgardenpi::protocol
     inline namespace v2
     {
 
-        struct DataTransport
-        {
-            /**
-             * @brief common payload
-             */
-            uint8_t *payload = nullptr;
-
-            /**
-             * @brief common payload ptr
-             */
-            uint8_t *payloadPtr = nullptr;
+        /**
+         * @brief Get flag of package type
+         * @param package package to check
+         * @return flag of package or NOT_SET if class not child of Package
+         */
+        static Flags getPackageFlags(const Package *package) noexcept;
 
-            /**
-             * @brief common payload length
-             */
-            uint16_t length = 0;
+        /**
+         * @brief Get number of chunks needed by a payload
+         * @param length payload length
+         * @param chunks number of chunks, not include FIN
+         * @return ErrorCode::DATA_TOO_BIG if length exceed HEAD_MAX_CHUNK
+         */
+        static ErrorCode getChunksCount(size_t length, uint8_t &chunks) noexcept;
 
-            /**
-             * @brief flag of Head packages
-             */
-            uint8_t flags = NOT_SET;
-        };
+        /**
+         * @brief Fill header and checksum of frame, payload must be already in place
+         * @tparam C checksum policy
+         * @param frame to fill
+         * @param flags of frame
+         * @param length of payload
+         * @return frame size
+         */
+        template<typename C = Crc16Checksum>
+        static uint16_t fillFrame(uint8_t *frame, uint8_t flags, uint8_t length) noexcept;
 
+        /**
+         * @brief Fill header and checksum agreed by a link at runtime of frame, payload must be already in place
+         * @param frame to fill
+         * @param flags of frame
+         * @param length of payload
+         * @param checksum of link
+         * @return frame size
+         */
+        static inline uint16_t fillFrame(uint8_t *frame, uint8_t flags, uint8_t length, ChecksumType checksum) noexcept;
 
         /**
-         * @brief initialize Head::Ptr with data
-         * @brief data Data container
-         * @return a new instance of Head::Ptr semi filled
+         * @brief Get size of all frames of a package
+         * @tparam C checksum policy
+         * @param length of package serialized
+         * @param chunks number of chunks, not include FIN
+         * @return size in bytes
          */
-        static Head::Ptr newHead(DataTransport &data);
+        template<typename C = Crc16Checksum>
+        static inline size_t getFramesSize(size_t length, uint8_t chunks) noexcept;
 
         /**
-          * Convert a head::Ptr to buffer ready to send
-           * @param head head to send
-          * @return uint8_t allocated buffer ready to send, to deallocate
-          * @throw runtime_exception if something goes wrong
-          */
-        //static tuple<uint8_t *, size_t> encodeHeadToBuffer(const Head::Ptr &head);
+         * @brief Fill header of frame
+         * @param header to fill
+         * @param flags of frame
+         * @param length of payload
+         */
+        static inline void fillHeader(uint8_t *header, uint8_t flags, uint8_t length) noexcept;
 
         /**
-         * Add data to base Head whit SYN information
-         * @param ret vector of Head already converted before this passage
-         * @param data to encode
-         * @param t pointer to structure
+         * @brief Fill crc16 of frame little endian
+         * @param crc to fill
+         * @param crc16Calc crc16 of header and payload
          */
-        template<typename T>
-        static Heads encodeDataToHeads(Heads &ret, DataTransport &data, const T *t);
+        static inline void fillCrc(uint8_t *crc, uint16_t crc16Calc) noexcept;
 
         /**
-         * Encode package and split it in more Head if needed
-         * @param package package to send, it will be deleted automatically
+         * @brief Get flags and number of chunks of a package
+         * @param package package to send
          * @param additionalFags additional flags to decorate package
-         * @return a vector of Head to send
-         * @throw runtime_exception if something goes wrong
+         * @param flags of package with additionalFags
+         * @param length of package serialized
+         * @param chunks number of chunks, not include FIN
+         * @return error if something goes wrong
          */
-        Heads encodeStart(Package *package, Flags additionalFags);
+        static ErrorCode getFramesLayout(const Package &package, Flags additionalFags, uint8_t &flags, size_t &length, uint8_t &chunks) noexcept;
 
         /**
-         * Add data to base Head whit SYN information
-         * @param data to encode
-         * @param t pointer to structure
+         * @brief Write all frames of a package, every byte of payload is copied once from package to its frame
+         * @tparam C checksum policy
+         * @param package package to send
+         * @param flags of package
+         * @param length of package serialized
+         * @param chunks number of chunks, not include FIN
+         * @param getFrame called with index and size of every frame, return where write it
+         * @return error if package can't be serialized
+         */
+        template<typename C = Crc16Checksum, typename F>
+        static ErrorCode writeFrames(const Package &package, uint8_t flags, size_t length, uint8_t chunks, F &&getFrame);
+
+        /**
+         * @brief Return value of a Result or throw its error
+         * @param result to unwrap
+         * @return value
+         * @throw runtime_exception with message of error
          */
         template<typename T>
-        static inline Heads encodeRecursive(DataTransport &data, const T *t)
+        static inline T unwrap(Result<T> &&result)
         {
-            Heads ret;
-            return encodeDataToHeads(ret, data, t);
+            if (!result)
+            {
+                throw runtime_error(getErrorMessage(result.getError()));
+            }
+            return move(result).getValue();
         }
 
         //enter point
         Buffers encode(Package *package, Flags additionalFags)
         {
-            Buffers ret;
-            for (auto &&head: encodeStart(package, additionalFags))
-            {
-                if (!head)
-                {
-                    throw runtime_error("head nullptr");
-                }
+            return unwrap(tryEncode(package, additionalFags));
+        }
 
-                auto buf = new(nothrow) uint8_t[5 + head->length];
+        /**
+         * @brief Allocate a buffer for a frame
+         * @param size of frame
+         * @param resource where allocate buffer and its control block, nullptr for pools
+         * @return buffer
+         * @throw bad_alloc if there is no memory
+         */
+        static Buffer allocateFrame(uint16_t size, std::pmr::memory_resource *resource)
+        {
+            if (!resource)
+            {
+                auto buf = allocateBuffer(size);
                 if (!buf)
                 {
-                    throw runtime_error("no memory for ret");
+                    throw bad_alloc();
                 }
-                memset(buf, 0, 5 + head->length);
+                return {shared_ptr<uint8_t[]>(buf, BufferDeleter{size}, PoolAllocator<uint8_t>()), size};
+            }
+
+            auto buf = static_cast<uint8_t *>(resource->allocate(size, alignof(uint8_t)));
+            return {shared_ptr<uint8_t[]>(buf, MemoryResourceDeleter{resource, size}, std::pmr::polymorphic_allocator<uint8_t>(resource)), size};
+        }
+
+        /**
+         * @brief Encode a package in a vector of buffers
+         * @param package package to send
+         * @param additionalFags additional flags to decorate package
+         * @param ret empty vector of buffers to fill
+         * @param resource where allocate buffers, nullptr for pools
+         * @return vector of buffers or error
+         */
+        template<typename C = Crc16Checksum, typename T>
+        static Result<T> encodeBuffers(const Package *package, Flags additionalFags, T &&ret, std::pmr::memory_resource *resource) noexcept
+        {
+            //check if package is null
+            if (package == nullptr)
+            {
+                return ErrorCode::NULL_PACKAGE;
+            }
 
-                buf[0] = (head->version << 0x07) | head->flags;
-                buf[1] = head->id;
-                buf[2] = head->length;
+            uint8_t flags = NOT_SET;
+            size_t length = 0;
+            uint8_t chunks = 0;
+            if (auto error = getFramesLayout(*package, additionalFags, flags, length, chunks); error != ErrorCode::OK)
+            {
+                return error;
+            }
 
-                uint8_t *ptrPayload = head->payload;
-                for (uint8_t i = 0; i < head->length; i++)
+            try
+            {
+                ret.reserve(chunks > 1 ? chunks + 1 : chunks);
+
+                //every frame is written directly in its buffer
+                auto error = writeFrames<C>(*package, flags, length, chunks, [&ret, resource](uint8_t, uint16_t frameSize)
+                {
+                    ret.push_back(allocateFrame(frameSize, resource));
+                    return ret.back().first.get();
+                });
+                if (error != ErrorCode::OK)
                 {
-                    buf[3 + i] = *ptrPayload;
-                    ptrPayload++;
+                    return error;
                 }
+                return move(ret);
+            }
+            catch (const bad_alloc &)
+            {
+                return ErrorCode::NO_MEMORY;
+            }
+        }
+
+        Result<Buffers> tryEncode(const Package *package, Flags additionalFags) noexcept
+        {
+            return encodeBuffers(package, additionalFags, Buffers(), nullptr);
+        }
 
-                //calculate size of crc16 and alloc it
-                size_t dataLessCrc16Length =
-                        sizeof(uint8_t) + //version and flags
-                        sizeof(uint8_t) + //id
-                        sizeof(uint8_t) + //length
-                        (sizeof(uint8_t) * head->length); //payload
-                head->crc16 = crc_16(&buf[0], dataLessCrc16Length);
+        Result<Buffers> tryEncode(const Package *package, Flags additionalFags, ChecksumType checksum) noexcept
+        {
+            return withChecksum(checksum, [&](auto policy)
+            {
+                return encodeBuffers<decltype(policy)>(package, additionalFags, Buffers(), nullptr);
+            });
+        }
+
+        PmrBuffers encode(const Package *package, Flags additionalFags, std::pmr::memory_resource *resource)
+        {
+            return unwrap(tryEncode(package, additionalFags, resource));
+        }
+
+        Result<PmrBuffers> tryEncode(const Package *package, Flags additionalFags, std::pmr::memory_resource *resource) noexcept
+        {
+            //without resource buffers are taken from pools
+            return encodeBuffers(package, additionalFags, PmrBuffers(resource ? resource : std::pmr::get_default_resource()), resource);
+        }
+
+        static Flags getPackageFlags(const Package *package) noexcept
+        {
+            return package ? package->getFlag() : NOT_SET;
+        }
 
-                //fill buffer with crc16
-                buf[3 + head->length] = static_cast<uint8_t>((head->crc16 & 0x00FF));
-                buf[4 + head->length] = static_cast<uint8_t>((head->crc16 & 0xFF00) >> 0x08);
+        static ErrorCode getChunksCount(size_t length, uint8_t &chunks) noexcept
+        {
+            if (length < HEAD_MAX_PAYLOAD_SIZE)
+            {
+                chunks = 1;
+                return ErrorCode::OK;
+            }
 
-                ret.emplace_back(buf, 5 + head->length);
+            //full chunks plus the last one, it can be empty
+            size_t ret = length / HEAD_MAX_PAYLOAD_SIZE;
+            if (ret > HEAD_MAX_CHUNK)
+            {
+                return ErrorCode::DATA_TOO_BIG;
             }
+            chunks = ret + 1;
+            return ErrorCode::OK;
+        }
 
-            return ret;
+        template<typename C>
+        static inline size_t getFramesSize(size_t length, uint8_t chunks) noexcept
+        {
+            //one more empty frame for FIN
+            uint8_t frames = chunks > 1 ? chunks + 1 : chunks;
+
+            return length + frames * (HEAD_HEADER_SIZE + C::SIZE);
         }
 
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wshadow"
-        Heads encodeStart(Package *package, Flags additionalFags)
+        static inline void fillHeader(uint8_t *header, uint8_t flags, uint8_t length) noexcept
         {
-            //check if package is null
-            if (package == nullptr)
+            header[0] = flags;
+            header[1] = 0;
+            header[2] = length;
+        }
+
+        static inline void fillCrc(uint8_t *crc, uint16_t crc16Calc) noexcept
+        {
+            crc[0] = static_cast<uint8_t>((crc16Calc & 0x00FF));
+            crc[1] = static_cast<uint8_t>((crc16Calc & 0xFF00) >> 0x08);
+        }
+
+        template<typename C>
+        static uint16_t fillFrame(uint8_t *frame, uint8_t flags, uint8_t length) noexcept
+        {
+            fillHeader(frame, flags, length);
+
+            //calculate checksum of version and flags + id + length + payload
+            uint32_t checksum = C::calculate(frame, HEAD_HEADER_SIZE + length);
+
+            //fill buffer with checksum little endian
+            for (uint8_t i = 0; i < C::SIZE; i++)
             {
-                throw runtime_error("package null");
-            }
-
-            Heads ret;
-            DataTransport data;
-
-            //check which child package was packaged
-            if (auto ptr = dynamic_cast<Aggregation *>(package); ptr) //is Flags::AGG package
-                //update flags
-                data.flags = AGG | additionalFags;
-            else if (auto ptr = dynamic_cast<Error *>(package); ptr) //is Flags::ERR package
-                //update flags
-                data.flags = ERR | additionalFags;
-            else if (auto ptr = dynamic_cast<Data *>(package); ptr) //is Flags::DAT package
-                //update flags
-                data.flags = DAT | additionalFags;
-            else if (dynamic_cast<Finish *>(package)) //is Flags::FIN package
-                //add package flag
-                data.flags = FIN | additionalFags;
-            else if (auto ptr = dynamic_cast<Station *>(package); ptr) //is Flags::STA package
-                //update flags
-                data.flags = STA | additionalFags;
-            else if (auto ptr = dynamic_cast<Synchro *>(package); ptr) //is Flags::SYN package
-                //add package flag
-                data.flags = SYN | additionalFags;
-            else
-                throw runtime_error("class not child of Package");
+                frame[HEAD_HEADER_SIZE + length + i] = static_cast<uint8_t>(checksum >> (i * 8));
+            }
+
+            return HEAD_HEADER_SIZE + length + C::SIZE;
+        }
+
+        static inline uint16_t fillFrame(uint8_t *frame, uint8_t flags, uint8_t length, ChecksumType checksum) noexcept
+        {
+            fillHeader(frame, flags, length);
 
-            auto &&[buf, size] = package->serialize();
+            return HEAD_HEADER_SIZE + length + fillChecksum(checksum, frame, HEAD_HEADER_SIZE + length);
+        }
 
-            //alloc memory
-            data.payload = buf.get();
+        size_t getEncodedSize(const Package &package)
+        {
+            return getEncodedSize<Crc16Checksum>(package);
+        }
 
-            //set length of package
-            data.length = size;
+        size_t getEncodedSize(const Package &package, ChecksumType checksum)
+        {
+            return withChecksum(checksum, [&package](auto policy)
+            {
+                return getEncodedSize<decltype(policy)>(package);
+            });
+        }
 
-            ret = move(encodeRecursive(data, package));
+        template<typename C>
+        size_t getEncodedSize(const Package &package)
+        {
+            size_t length = package.getSerializedSize();
+            uint8_t chunks = 0;
+            if (auto error = getChunksCount(length, chunks); error != ErrorCode::OK)
+            {
+                throw runtime_error(getErrorMessage(error));
+            }
 
-            return ret;
+            return getFramesSize<C>(length, chunks);
         }
 
-        template<typename T>
-        [[maybe_unused]] static vector<Head::Ptr> encodeDataToHeads(vector<Head::Ptr> &ret, DataTransport &data, const T *t)
+        EncodedFrames encodeInto(const Package &package, Flags additionalFags, uint8_t *out, size_t size)
+        {
+            return unwrap(tryEncodeInto(package, additionalFags, out, size));
+        }
+
+        static ErrorCode getFramesLayout(const Package &package, Flags additionalFags, uint8_t &flags, size_t &length, uint8_t &chunks) noexcept
         {
-            static_assert(is_base_of<Package, T>::value, "T is non subclass of Package");
+            flags = getPackageFlags(&package);
+            if (flags == NOT_SET)
+            {
+                return ErrorCode::NOT_A_PACKAGE;
+            }
+            flags |= additionalFags;
 
-            //verify length dimension
-            if (data.length < HEAD_MAX_PAYLOAD_SIZE)
+            length = package.getSerializedSize();
+            return getChunksCount(length, chunks);
+        }
+
+        template<typename C, typename F>
+        static ErrorCode writeFrames(const Package &package, uint8_t flags, size_t length, uint8_t chunks, F &&getFrame)
+        {
+            //tail is copied from package memory straight to its frames, bytes before it are serialized
+            auto tail = package.getSerializedTail();
+            size_t headLength = length - tail.size;
+            uint8_t chunkFlags = chunks > 1 ? flags | CKN : flags;
+
+            //bytes before tail longer than first chunk, only packages without tail
+            uint8_t scratch[(HEAD_MAX_CHUNK + 1) * HEAD_MAX_PAYLOAD_SIZE];
+
+            for (uint8_t i = 0; i < chunks; i++)
             {
-                //move pointer to filled payload if it's first head, il ret > 0 it means we are in recursion loop
-                if (ret.empty())
+                size_t begin = i * HEAD_MAX_PAYLOAD_SIZE;
+                //not uint8_t, bounded lengths make compiler inline memcpy as slow rep movs
+                size_t chunkLength = i == chunks - 1 ? length - begin : HEAD_MAX_PAYLOAD_SIZE;
+                size_t end = begin + chunkLength;
+
+                uint8_t *frame = getFrame(i, HEAD_HEADER_SIZE + chunkLength + C::SIZE);
+                uint8_t *payload = &frame[HEAD_HEADER_SIZE];
+
+                if (i == 0)
+                {
+                    if (headLength <= chunkLength)
+                    {
+                        if (!package.serializeHeadInto(payload, headLength))
+                        {
+                            return ErrorCode::NOT_SERIALIZABLE;
+                        }
+                    }
+                    else
+                    {
+                        if (!package.serializeHeadInto(scratch, headLength))
+                        {
+                            return ErrorCode::NOT_SERIALIZABLE;
+                        }
+                        memcpy(payload, scratch, chunkLength);
+                    }
+                }
+                else if (begin < headLength)
                 {
-                    data.payloadPtr = data.payload;
+                    memcpy(payload, &scratch[begin], (end < headLength ? end : headLength) - begin);
                 }
 
-                //create head
-                ret.push_back(move(newHead(data)));
-            } else if (data.length > 0)
-            {
-                //check how many heads already build
-                if (ret.size() >= HEAD_MAX_CHUNK)
+                if (end > headLength)
                 {
-                    throw runtime_error("data to big, exceed HEAD_MAX_CHUNK");
+                    size_t from = begin > headLength ? begin : headLength;
+                    memcpy(&payload[from - begin], &tail.data[from - headLength], end - from);
                 }
 
-                //create data for elaborate in newHead
-                DataTransport dataLocal;
-                dataLocal.payload = data.payload;
-                dataLocal.payloadPtr = dataLocal.payload;
-                dataLocal.length = HEAD_MAX_PAYLOAD_SIZE;
-                dataLocal.flags = data.flags | CKN;
+                fillFrame<C>(frame, chunkFlags, static_cast<uint8_t>(chunkLength));
+            }
+
+            if (chunks > 1)
+            {
+                //close chunks with FIN
+                fillFrame<C>(getFrame(chunks, HEAD_HEADER_SIZE + C::SIZE), FIN | CKN | (flags & ACK), 0);
+            }
+
+            return ErrorCode::OK;
+        }
+
+        Result<EncodedFrames> tryEncodeInto(const Package &package, Flags additionalFags, uint8_t *out, size_t size) noexcept
+        {
+            return tryEncodeInto<Crc16Checksum>(package, additionalFags, out, size);
+        }
+
+        Result<EncodedFrames> tryEncodeInto(const Package &package, Flags additionalFags, uint8_t *out, size_t size, ChecksumType checksum) noexcept
+        {
+            return withChecksum(checksum, [&](auto policy)
+            {
+                return tryEncodeInto<decltype(policy)>(package, additionalFags, out, size);
+            });
+        }
+
+        template<typename C>
+        Result<EncodedFrames> tryEncodeInto(const Package &package, Flags additionalFags, uint8_t *out, size_t size) noexcept
+        {
+            EncodedFrames ret;
+
+            uint8_t flags = NOT_SET;
+            size_t length = 0;
+            uint8_t chunks = 0;
+            if (auto error = getFramesLayout(package, additionalFags, flags, length, chunks); error != ErrorCode::OK)
+            {
+                return error;
+            }
+
+            size_t encodedSize = getFramesSize<C>(length, chunks);
+            if (!out || size < encodedSize)
+            {
+                return ErrorCode::BUFFER_TOO_SMALL;
+            }
+
+            //frames back to back in buffer of caller
+            auto error = writeFrames<C>(package, flags, length, chunks, [&ret, out](uint8_t i, uint16_t frameSize) noexcept
+            {
+                ret.offsets[i] = ret.size;
+                ret.size += frameSize;
+                ret.count = i + 1;
+                return &out[ret.offsets[i]];
+            });
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+
+            return ret;
+        }
+
+        EncodedMessage encodeMessage(const Package &package, Flags additionalFags)
+        {
+            return unwrap(tryEncodeMessage(package, additionalFags));
+        }
+
+        Result<EncodedMessage> tryEncodeMessage(const Package &package, Flags additionalFags) noexcept
+        {
+            return tryEncodeMessage(package, additionalFags, ChecksumType::CRC16);
+        }
+
+        Result<EncodedMessage> tryEncodeMessage(const Package &package, Flags additionalFags, ChecksumType checksum) noexcept
+        {
+            uint8_t flags = NOT_SET;
+            size_t length = 0;
+            uint8_t chunks = 0;
+            if (auto error = getFramesLayout(package, additionalFags, flags, length, chunks); error != ErrorCode::OK)
+            {
+                return error;
+            }
+
+            //one allocation sized exactly for all frames
+            size_t size = withChecksum(checksum, [length, chunks](auto policy)
+            {
+                return getFramesSize<decltype(policy)>(length, chunks);
+            });
+            unique_ptr<uint8_t[], BufferDeleter> data(allocateBuffer(size), BufferDeleter{size});
+            if (!data)
+            {
+                return ErrorCode::NO_MEMORY;
+            }
 
-                //create head
-                ret.push_back(move(newHead(dataLocal)));
+            auto &&frames = tryEncodeInto(package, additionalFags, data.get(), size, checksum);
+            if (!frames)
+            {
+                return frames.getError();
+            }
 
-                //update data for next package
-                dataLocal.payloadPtr += HEAD_MAX_PAYLOAD_SIZE;
+            return EncodedMessage(move(data), *frames);
+        }
 
-                //update size for next package
-                dataLocal.length = data.length - HEAD_MAX_PAYLOAD_SIZE;
+        ErrorCode StreamEncoder::start(const Package &package, Flags additionalFags) noexcept
+        {
+            reset();
 
-                //create one more head, in recursive mode
-                encodeDataToHeads(ret, dataLocal, t);
+            if (auto error = getFramesLayout(package, additionalFags, flags, length, chunks); error != ErrorCode::OK)
+            {
+                return error;
             }
 
-            //check if vector it's a stack of Head control or not then add FIN if not exist
-            if (ret.size() > 1 && !(ret.back()->flags & FIN))
+            tail = package.getSerializedTail();
+            headLength = length - tail.size;
+
+            //bytes before tail are written in first frame when they fit in it, otherwise kept until sent
+            if (headLength <= HEAD_MAX_PAYLOAD_SIZE)
             {
-                auto fin = new(nothrow) Finish;
-                if (!fin)
+                if (!package.serializeHeadInto(&buffer[HEAD_HEADER_SIZE], headLength))
                 {
-                    throw runtime_error("no memory for fin");
+                    return ErrorCode::NOT_SERIALIZABLE;
                 }
-
-                uint8_t flags = NOT_SET;
-                if ((data.flags & ACK) == ACK)
+            }
+            else
+            {
+                prefix = unique_ptr<uint8_t[], BufferDeleter>(allocateBuffer(headLength), BufferDeleter{headLength});
+                if (!prefix)
                 {
-                    flags |= ACK;
+                    return ErrorCode::NO_MEMORY;
                 }
-                if ((data.flags & CKN) == CKN)
+                if (!package.serializeHeadInto(prefix.get(), headLength))
                 {
-                    flags |= CKN;
+                    prefix.reset();
+                    return ErrorCode::NOT_SERIALIZABLE;
                 }
-                auto &&enc = encodeStart(fin, static_cast<Flags>(flags));
+            }
+
+            this->package = &package;
+            count = chunks > 1 ? chunks + 1 : chunks;
+            return ErrorCode::OK;
+        }
+
+        BytesView StreamEncoder::next() noexcept
+        {
+            if (!hasNext())
+            {
+                return {};
+            }
+
+            //close chunks with FIN
+            if (frame == chunks)
+            {
+                frame++;
+                return {buffer, fillFrame(buffer, FIN | CKN | (flags & ACK), 0, checksum)};
+            }
+
+            size_t begin = frame * HEAD_MAX_PAYLOAD_SIZE;
+            size_t chunkLength = frame == chunks - 1 ? length - begin : HEAD_MAX_PAYLOAD_SIZE;
+            size_t end = begin + chunkLength;
+            uint8_t *payload = &buffer[HEAD_HEADER_SIZE];
+
+            //without prefix bytes before tail are already in first frame
+            if (prefix && begin < headLength)
+            {
+                memcpy(payload, &prefix[begin], (end < headLength ? end : headLength) - begin);
+            }
+            if (end > headLength)
+            {
+                size_t from = begin > headLength ? begin : headLength;
+                memcpy(&payload[from - begin], &tail.data[from - headLength], end - from);
+            }
 
-                if (!enc.empty())
+            frame++;
+            return {buffer, fillFrame(buffer, chunks > 1 ? flags | CKN : flags, static_cast<uint8_t>(chunkLength), checksum)};
+        }
+
+        void StreamEncoder::reset() noexcept
+        {
+            package = nullptr;
+            tail = {};
+            prefix.reset();
+            length = 0;
+            headLength = 0;
+            flags = NOT_SET;
+            chunks = 0;
+            count = 0;
+            frame = 0;
+        }
+
+#ifdef HGARDENPI_PROTOCOL_SCATTER
+        void encodeScatter(const Package &package, Flags additionalFags, ScatterFrames &ret)
+        {
+            if (auto error = tryEncodeScatter(package, additionalFags, ret); error != ErrorCode::OK)
+            {
+                throw runtime_error(getErrorMessage(error));
+            }
+        }
+
+        /**
+         * @brief Add a segment to frames
+         * @param ret segments of frames
+         * @param data of segment
+         * @param size of segment
+         */
+        static inline void addSegment(ScatterFrames &ret, const uint8_t *data, size_t size) noexcept
+        {
+            ret.iov[ret.iovcnt].iov_base = const_cast<uint8_t *>(data);
+            ret.iov[ret.iovcnt].iov_len = size;
+            ret.iovcnt++;
+            ret.size += size;
+        }
+
+        ErrorCode tryEncodeScatter(const Package &package, Flags additionalFags, ScatterFrames &ret) noexcept
+        {
+            ret.iovcnt = 0;
+            ret.count = 0;
+            ret.size = 0;
+
+            uint8_t flags = NOT_SET;
+            size_t length = 0;
+            uint8_t chunks = 0;
+            if (auto error = getFramesLayout(package, additionalFags, flags, length, chunks); error != ErrorCode::OK)
+            {
+                return error;
+            }
+
+            //only bytes before tail are serialized, tail is referenced in place
+            auto tail = package.getSerializedTail();
+            size_t headLength = length - tail.size;
+            if (!package.serializeHeadInto(ret.prefix, headLength))
+            {
+                return ErrorCode::NOT_SERIALIZABLE;
+            }
+            uint8_t chunkFlags = chunks > 1 ? flags | CKN : flags;
+
+            for (uint8_t i = 0; i < chunks; i++)
+            {
+                size_t begin = i * HEAD_MAX_PAYLOAD_SIZE;
+                size_t chunkLength = i == chunks - 1 ? length - begin : HEAD_MAX_PAYLOAD_SIZE;
+                size_t end = begin + chunkLength;
+
+                ret.frames[i] = ret.iovcnt;
+                fillHeader(ret.headers[i], chunkFlags, static_cast<uint8_t>(chunkLength));
+                addSegment(ret, ret.headers[i], HEAD_HEADER_SIZE);
+                uint16_t crc = crc16(ret.headers[i], HEAD_HEADER_SIZE);
+
+                //crc16 go on segment by segment
+                if (begin < headLength)
+                {
+                    size_t prefixLength = (end < headLength ? end : headLength) - begin;
+                    addSegment(ret, &ret.prefix[begin], prefixLength);
+                    crc = crc16(&ret.prefix[begin], prefixLength, crc);
+                }
+                if (end > headLength)
                 {
-                    ret.push_back(enc[0]);
+                    size_t from = begin > headLength ? begin : headLength;
+                    addSegment(ret, &tail.data[from - headLength], end - from);
+                    crc = crc16(&tail.data[from - headLength], end - from, crc);
                 }
 
-                delete fin;
+                fillCrc(ret.crcs[i], crc);
+                addSegment(ret, ret.crcs[i], HEAD_CRC_SIZE);
             }
+            ret.count = chunks;
 
-            return ret;
-        }
+            if (chunks > 1)
+            {
+                //close chunks with FIN
+                ret.frames[chunks] = ret.iovcnt;
+                fillHeader(ret.headers[chunks], FIN | CKN | (flags & ACK), 0);
+                fillCrc(ret.crcs[chunks], crc16(ret.headers[chunks], HEAD_HEADER_SIZE));
+                addSegment(ret, ret.headers[chunks], HEAD_HEADER_SIZE);
+                addSegment(ret, ret.crcs[chunks], HEAD_CRC_SIZE);
+                ret.count++;
+            }
 
+            return ErrorCode::OK;
+        }
+#endif
 
-        static Head::Ptr newHead(DataTransport &data)
+        /**
+         * @brief Check header of a frame in place and fill a view on it, checksum is read but not checked
+         * @tparam C checksum policy
+         * @param data frame
+         * @param size of buffer
+         * @param ret view of frame
+         * @return error if something goes wrong
+         */
+        template<typename C = Crc16Checksum>
+        static inline ErrorCode peekHead(const uint8_t *data, size_t size, HeadView &ret) noexcept
         {
-            if (data.length > HEAD_MAX_PAYLOAD_SIZE)
+            if (!data || size < HEAD_HEADER_SIZE + C::SIZE || size < HEAD_HEADER_SIZE + static_cast<size_t>(data[2]) + C::SIZE)
             {
-                throw runtime_error("payload length exceed");
+                return ErrorCode::BUFFER_TOO_SHORT;
             }
 
-            //alloc heap
-            //prepare return head with common information
-            Head::Ptr head(new(nothrow) Head{
-                    .version = 0,
-                    .flags = NOT_SET,
-                    .id = 0,
-                    .length = 0
-            });
-            if (head == nullptr)
+            ret.version = static_cast<uint8_t>((data[0] & 0x80) >> 0x07);
+            ret.flags = static_cast<uint8_t>(data[0] & 0x7F);
+            ret.id = static_cast<uint8_t>(data[1]);
+            ret.length = static_cast<uint8_t>(data[2]);
+
+            if (ret.version != CURRENT_PROTOCOL_ACTIVE_VERSION)
             {
-                throw runtime_error("no memory for head");
+                return ErrorCode::WRONG_VERSION;
             }
 
-            //alloc heap
-            head->length = data.length;
-            head->payload = new(nothrow) uint8_t[head->length];
-            if (!head->payload)
+            //only one package type, or only ACK
+            if (!checkFlags(ret.flags))
             {
-                throw runtime_error("no memory for ret->payload");
+                return ErrorCode::FLAGS_OUT_OF_RANGE;
             }
 
-            //set payload to 0
-            memset(head->payload, 0, head->length);
+            //point payload inside data
+            ret.payload = {&data[HEAD_HEADER_SIZE], ret.length};
+
+            //copy crc16 from data, only checksum of 16 bits
+            if constexpr (C::SIZE == HEAD_CRC_SIZE)
+            {
+                ret.crc16 = static_cast<uint16_t>((data[ret.length + 4] << 0x08) | data[ret.length + 3]);
+            }
+            else
+            {
+                ret.crc16 = 0;
+            }
+
+            return ErrorCode::OK;
+        }
+
+        /**
+         * @brief Check a frame in place and fill a view on it
+         * @tparam C checksum policy
+         * @param data frame
+         * @param size of buffer
+         * @param ret view of frame
+         * @return error if something goes wrong
+         */
+        template<typename C = Crc16Checksum>
+        static ErrorCode viewHead(const uint8_t *data, size_t size, HeadView &ret) noexcept
+        {
+            if (auto error = peekHead<C>(data, size, ret); error != ErrorCode::OK)
+            {
+                return error;
+            }
 
-            head->flags = data.flags;
+            //calculate checksum from data received
+            const uint16_t dataLessCrc16Length = ret.length + 3;
+            uint32_t checksum = C::calculate(data, dataLessCrc16Length);
 
-            //copy data payload to head
-            memcpy(head->payload, data.payloadPtr, data.length);
+            //check checksum send with that calculate
+            uint32_t received = 0;
+            for (uint8_t i = 0; i < C::SIZE; i++)
+            {
+                received |= static_cast<uint32_t>(data[dataLessCrc16Length + i]) << (i * 8);
+            }
+            if (received != checksum)
+            {
+                return ErrorCode::CRC_NOT_MATCH;
+            }
 
-            return head;
+            return ErrorCode::OK;
         }
 
-#pragma clang diagnostic pop
+        Result<HeadView> tryView(const uint8_t *data, size_t size) noexcept
+        {
+            return tryView<Crc16Checksum>(data, size);
+        }
 
-        Head::Ptr decode(const uint8_t *data)
+        Result<HeadView> tryView(const uint8_t *data, size_t size, ChecksumType checksum) noexcept
         {
-            //initialize default return value
-            Head::Ptr ret(new(nothrow) Head{
-                    .version = static_cast<uint8_t>((data[0] & 0x80) >> 0x07),
-                    .flags = static_cast<uint8_t>(data[0] & 0x7F),
-                    .id = static_cast<uint8_t>(data[1]),
-                    .length = static_cast<uint8_t>(data[2])
+            return withChecksum(checksum, [data, size](auto policy)
+            {
+                return tryView<decltype(policy)>(data, size);
             });
-            if (ret == nullptr)
+        }
+
+        template<typename C>
+        Result<HeadView> tryView(const uint8_t *data, size_t size) noexcept
+        {
+            HeadView ret;
+            if (auto error = viewHead<C>(data, size, ret); error != ErrorCode::OK)
             {
-                throw runtime_error("no memory for head");
+                return error;
             }
+            return ret;
+        }
 
-            if (ret->version != CURRENT_PROTOCOL_ACTIVE_VERSION)
+        HeadView view(const uint8_t *data, size_t size)
+        {
+            return unwrap(tryView(data, size));
+        }
+
+        Result<HeadView> tryPeek(const uint8_t *data, size_t size) noexcept
+        {
+            return tryPeek<Crc16Checksum>(data, size);
+        }
+
+        template<typename C>
+        Result<HeadView> tryPeek(const uint8_t *data, size_t size) noexcept
+        {
+            HeadView ret;
+            if (auto error = peekHead<C>(data, size, ret); error != ErrorCode::OK)
             {
-                throw runtime_error("wrong protocol version");
+                return error;
             }
+            return ret;
+        }
 
-            //check max init of value
-            if (ret->flags > 0xE0)
+        ErrorCode tryViewBatch(const uint8_t *data, size_t size, HeadView *frames, size_t capacity, size_t &count, size_t &consumed) noexcept
+        {
+            return tryViewBatch<Crc16Checksum>(data, size, frames, capacity, count, consumed);
+        }
+
+        ErrorCode tryViewBatch(const uint8_t *data, size_t size, HeadView *frames, size_t capacity, size_t &count, size_t &consumed,
+                               ChecksumType checksum) noexcept
+        {
+            return withChecksum(checksum, [&](auto policy)
             {
-                throw runtime_error("head flags out of range or more packages set");
+                return tryViewBatch<decltype(policy)>(data, size, frames, capacity, count, consumed);
+            });
+        }
+
+        template<typename C>
+        ErrorCode tryViewBatch(const uint8_t *data, size_t size, HeadView *frames, size_t capacity, size_t &count, size_t &consumed) noexcept
+        {
+            count = 0;
+            consumed = 0;
+            if (!data || !frames)
+            {
+                return ErrorCode::BUFFER_TOO_SHORT;
             }
 
-            //alloc heap
-            ret->payload = new(nothrow) uint8_t[ret->length];
-            if (!ret->payload)
+            while (count < capacity && consumed < size)
             {
-                throw runtime_error("no memory for head->payload");
+                auto error = viewHead<C>(&data[consumed], size - consumed, frames[count]);
+                if (error == ErrorCode::BUFFER_TOO_SHORT)
+                {
+                    //last frame not received all, it is left to next receive
+                    break;
+                }
+                if (error != ErrorCode::OK)
+                {
+                    return error;
+                }
+                consumed += HEAD_HEADER_SIZE + frames[count].length + C::SIZE;
+                count++;
             }
 
-            //set payload to 0
-            memset(ret->payload, 0, ret->length);
+            return ErrorCode::OK;
+        }
 
-            //copy payload from data
-            memcpy(ret->payload, &data[3], ret->length);
+        Result<Head::Ptr> tryDecode(const uint8_t *data, size_t size) noexcept
+        {
+            return tryDecode(data, size, nullptr);
+        }
 
-            //copy crc16 from data
-            ret->crc16 = static_cast<uint16_t>((data[ret->length + 4] << 0x08) | data[ret->length + 3]);
+        Result<Head::Ptr> tryDecode(const uint8_t *data, size_t size, std::pmr::memory_resource *resource) noexcept
+        {
+            HeadView view;
+            if (auto error = viewHead(data, size, view); error != ErrorCode::OK)
+            {
+                return error;
+            }
+
+            try
+            {
+                //head and control block in one block of pools or resource
+                auto ret = resource ? allocate_shared<Head>(std::pmr::polymorphic_allocator<Head>(resource)) : allocate_shared<Head>(PoolAllocator<Head>());
+                ret->version = view.version;
+                ret->flags = view.flags;
+                ret->id = view.id;
+                ret->length = view.length;
+                ret->crc16 = view.crc16;
+
+                //alloc payload
+                if (resource)
+                {
+                    ret->payload = static_cast<uint8_t *>(resource->allocate(view.length, alignof(uint8_t)));
+                    ret->resource = resource;
+                }
+                else
+                {
+                    ret->payload = allocateBuffer(view.length);
+                }
+                if (!ret->payload)
+                {
+                    return ErrorCode::NO_MEMORY;
+                }
 
-            //calculate crc16 from data received
-            const uint16_t dataLessCrc16Length = ret->length + 3;
-            uint16_t crc16 = crc_16(data, dataLessCrc16Length);
+                //copy payload from data
+                memcpy(ret->payload, view.payload.data, view.length);
 
-            //check crc16 send with that calculate
-            if (crc16 != ret->crc16)
+                return ret;
+            }
+            catch (const bad_alloc &)
             {
-                throw runtime_error("crc not match");
+                return ErrorCode::NO_MEMORY;
             }
+        }
 
-            return ret;
+        Head::Ptr decode(const uint8_t *data)
+        {
+            //size unknown, caller provides at least the whole frame declared by header, longest one fit HEAD_MAX_FRAME_SIZE
+            return decode(data, HEAD_MAX_FRAME_SIZE);
+        }
+
+        Head::Ptr decode(const uint8_t *data, size_t size)
+        {
+            return unwrap(tryDecode(data, size));
+        }
+
+        Head::Ptr decode(const uint8_t *data, size_t size, std::pmr::memory_resource *resource)
+        {
+            return unwrap(tryDecode(data, size, resource));
         }
 
         void updateIdToBufferEncoded(Buffer &buffer, uint8_t id)
@@ -394,14 +935,32 @@ namespace hgardenpi::protocol
                 throw runtime_error("wrong protocol version");
             }
 
+            //patch crc16 with the change of id, length and payload follow it
+            uint16_t crc16Calc = static_cast<uint16_t>((buffer.first[buffer.second - 1] << 0x08) | buffer.first[buffer.second - 2]);
+            crc16Calc = crc16Patch(crc16Calc, buffer.first[1] ^ id, buffer.second - HEAD_CRC_SIZE - 2);
             buffer.first[1] = id;
 
-            uint16_t crc16Calc = crc_16(buffer.first.get(), buffer.second - 2);
-
             buffer.first[buffer.second - 2] = static_cast<uint8_t>((crc16Calc & 0x00FF));
             buffer.first[buffer.second - 1] = static_cast<uint8_t>((crc16Calc & 0xFF00) >> 0x08);
         }
 
+        void updateIdToBufferEncoded(Buffer &buffer, uint8_t id, ChecksumType checksum)
+        {
+            if (checksum == ChecksumType::CRC16)
+            {
+                updateIdToBufferEncoded(buffer, id);
+                return;
+            }
+
+            if (((buffer.first[0] & 0x80) >> 0x07) != CURRENT_PROTOCOL_ACTIVE_VERSION)
+            {
+                throw runtime_error("wrong protocol version");
+            }
+
+            buffer.first[1] = id;
+            fillChecksum(checksum, buffer.first.get(), buffer.second - getChecksumSize(checksum));
+        }
+
         void getVersion(int &major, int &minor, int &patch)
         {
             major = HGARDENPI_PROTOCOL_VER_MAJOR;
@@ -413,125 +972,230 @@ namespace hgardenpi::protocol
 #pragma ide diagnostic ignored "readability-delete-null-pointer"
 #pragma clang diagnostic ignored "-Wshadow"
 
-        static inline pair<Flags, Package::Ptr> composeDecodedChunksDecode(const Head::Ptr &head) noexcept
-        try
+        /**
+         * @brief Reassemble payload of DAT or ERR chunks in linear time, total length is read from prefix of
+         * chunk 0 and payload is allocated once
+         * @param chunks payloads of chunks in order
+         * @param count number of chunks
+         * @param length of package read from chunk 0
+         * @param reserve return storage of payload for length bytes, owned by package also on error
+         * @return error if chunks not match length
+         * @throw bad_alloc if there is no memory
+         */
+        template<typename R>
+        static ErrorCode reassembleChunks(const BytesView *chunks, uint8_t count, uint16_t &length, R &&reserve)
         {
-            auto des = head->deserialize();
-            pair<Flags, Package::Ptr> ret;
-            if (auto ptr = dynamic_cast<Aggregation *>(des); ptr) //is Flags::AGG package
+            //first chunk begin with length of whole payload
+            if (count == 0 || chunks[0].size < sizeof(uint16_t))
             {
-                ret = {AGG, shared_ptr<Aggregation>(ptr)};
+                return ErrorCode::PAYLOAD_MALFORMED;
             }
-            else if (auto ptr = dynamic_cast<Error *>(des); ptr) //is Flags::ERR package
+            memcpy(&length, chunks[0].data, sizeof(uint16_t));
+
+            char *payload = reserve(length);
+
+            size_t offset = 0;
+            for (uint8_t i = 0; i < count; i++)
             {
-                ptr->setMsg(ptr->getChunk());
-                ret = {ERR, shared_ptr<Error>(ptr)};
+                const uint8_t *chunk = chunks[i].data;
+                size_t chunkLength = chunks[i].size;
+                if (i == 0)
+                {
+                    chunk += sizeof(uint16_t);
+                    chunkLength -= sizeof(uint16_t);
+                }
+
+                if (offset + chunkLength > length)
+                {
+                    return ErrorCode::PAYLOAD_MALFORMED;
+                }
+                if (chunkLength > 0)
+                {
+                    memcpy(&payload[offset], chunk, chunkLength);
+                    offset += chunkLength;
+                }
             }
-            else if (auto ptr = dynamic_cast<Data *>(des); ptr) //is Flags::DAT package
+
+            return offset == length ? ErrorCode::OK : ErrorCode::PACKAGE_INCOMPLETE;
+        }
+
+        [[maybe_unused]] pair<Flags, Package::Ptr> composeDecodedChunks(const Heads &heads)
+        {
+            return unwrap(tryComposeDecodedChunks(heads));
+        }
+
+        /**
+         * @brief Compose a decoded package from a container of heads
+         * @param heads of package ptr
+         * @param resource where allocate package, nullptr for pools
+         * @return a pair with type of package and pointer of them or error
+         */
+        template<typename T>
+        static Result<pair<Flags, Package::Ptr>> composeHeads(const T &heads, std::pmr::memory_resource *resource) noexcept
+        {
+            if (heads.empty())
             {
-                ptr->setPayload(ptr->getChunk());
-                ret = {DAT, shared_ptr<Data>(ptr)};
+                return ErrorCode::NO_HEAD;
             }
-            else if (auto ptr = dynamic_cast<Finish *>(des); ptr) //is Flags::FIN package
+            else if (heads.size() == 1 && !endCommunication(heads[0]))
             {
-                ret = {FIN, shared_ptr<Finish>(ptr)};
+                return ErrorCode::PACKAGE_INCOMPLETE;
             }
-            else if (auto ptr = dynamic_cast<Station *>(des); ptr) //is Flags::STA package
+            else if (!heads[0])
             {
-                ret = {STA, shared_ptr<Station>(ptr)};
+                return ErrorCode::INCOMPATIBLE_CHUNK;
             }
-            else if (auto ptr = dynamic_cast<Synchro *>(des); ptr) //is Flags::SYN package
+
+            //payloads of chunks until FIN
+            const uint8_t flags = heads[0]->flags;
+            BytesView chunks[HEAD_MAX_FRAMES];
+            uint8_t count = 0;
+            for (auto &&head : heads)
             {
-                ret = {SYN, shared_ptr<Synchro>(ptr)};
+                if (!head)
+                {
+                    return ErrorCode::INCOMPATIBLE_CHUNK;
+                }
+                if ((head->flags & HEAD_PACKAGE_MASK) == FIN && count > 0)
+                {
+                    break;
+                }
+                if ((head->flags & HEAD_PACKAGE_MASK) != (flags & HEAD_PACKAGE_MASK))
+                {
+                    return ErrorCode::INCOMPATIBLE_CHUNK;
+                }
+                if (count == HEAD_MAX_FRAMES)
+                {
+                    return ErrorCode::DATA_TOO_BIG;
+                }
+                chunks[count++] = head->getPayloadView();
             }
-            else ret = {NOT_SET, nullptr};
 
-            return ret;
+            return tryComposeChunks(flags, chunks, count, resource);
         }
-        catch (...)
+
+        Result<pair<Flags, Package::Ptr>> tryComposeDecodedChunks(const Heads &heads) noexcept
         {
-            return {ERR, nullptr};
+            return composeHeads(heads, nullptr);
         }
 
-        [[maybe_unused]] pair<Flags, Package::Ptr> composeDecodedChunks(const Heads &heads)
+        pair<Flags, Package::Ptr> composeDecodedChunks(const Heads &heads, std::pmr::memory_resource *resource)
         {
-            if (heads.empty())
+            return unwrap(tryComposeDecodedChunks(heads, resource));
+        }
+
+        Result<pair<Flags, Package::Ptr>> tryComposeDecodedChunks(const Heads &heads, std::pmr::memory_resource *resource) noexcept
+        {
+            return composeHeads(heads, resource);
+        }
+
+        pair<Flags, Package::Ptr> composeDecodedChunks(const PmrHeads &heads, std::pmr::memory_resource *resource)
+        {
+            return unwrap(tryComposeDecodedChunks(heads, resource));
+        }
+
+        Result<pair<Flags, Package::Ptr>> tryComposeDecodedChunks(const PmrHeads &heads, std::pmr::memory_resource *resource) noexcept
+        {
+            return composeHeads(heads, resource);
+        }
+
+        /**
+         * @brief Allocate a package and its control block together
+         * @param resource where allocate package and its fields, nullptr for pools
+         * @return new package
+         * @throw bad_alloc if there is no memory
+         */
+        template<typename T>
+        static inline shared_ptr<T> allocatePackage(std::pmr::memory_resource *resource)
+        {
+            if (!resource)
             {
-                throw runtime_error("no head in vector");
+                return allocate_shared<T>(PoolAllocator<T>());
             }
-            else if (heads.size() == 1)
+            auto ret = allocate_shared<T>(std::pmr::polymorphic_allocator<T>(resource));
+            ret->resource = resource;
+            return ret;
+        }
+
+        Result<pair<Flags, Package::Ptr>> tryComposeChunks(uint8_t flags, const BytesView *chunks, uint8_t count, std::pmr::memory_resource *resource) noexcept
+        try
+        {
+            if (!chunks || count == 0)
             {
-                if(endCommunication(heads[0]))
-                {
-                    return composeDecodedChunksDecode(heads[0]);
-                }
-                else
-                    throw runtime_error("package incomplete");
+                return ErrorCode::NO_HEAD;
             }
-            else
+
+            switch (flags & HEAD_PACKAGE_MASK)
             {
-                pair<Flags, Package::Ptr> ret;
-                ret.first = NOT_SET;
-                if ((heads[0]->flags & ERR) == ERR) //is Flags::ERR package
+                case ERR:
                 {
-                    auto chunk = 0;
-                    shared_ptr ret = make_shared<Error>();
-                    for (auto &&head : heads)
+                    auto ret = allocatePackage<Error>(resource);
+                    if (auto error = reassembleChunks(chunks, count, ret->length, [&ret](uint16_t length)
                     {
-                        if ((head->flags & FIN) == FIN)
-                        {
-                            break;
-                        }
-                        if ((head->flags & ERR) == ERR)
-                        {
-                            string &&payload = ret->getMsg();
-
-                            auto retHead = dynamic_cast<Error *>(head->deserialize(chunk));
-                            payload += retHead->getChunk();
-
-                            ret->setMsg(payload);
-
-                            delete retHead;
-                        }
-                        else
-                            throw runtime_error("incompatible chunk inside heads");
-                        chunk++;
+                        return ret->msg.reserve(length, ret->resource);
+                    }); error != ErrorCode::OK)
+                    {
+                        return error;
                     }
-                    return {ERR, ret};
+                    return pair<Flags, Package::Ptr>{ERR, ret};
                 }
-                else if ((heads[0]->flags & DAT) == DAT) //is Flags::DAT package
+                case DAT:
                 {
-                    auto chunk = 0;
-                    shared_ptr ret = make_shared<Data>();
-                    auto &&last = *heads.end().base();
-                    for (auto &&head: heads)
+                    auto ret = allocatePackage<Data>(resource);
+                    if (auto error = reassembleChunks(chunks, count, ret->length, [&ret](uint16_t length)
                     {
-                        if ((head->flags & FIN) == FIN)
+                        return ret->payload = ret->allocateField(length);
+                    }); error != ErrorCode::OK)
+                    {
+                        return error;
+                    }
+                    return pair<Flags, Package::Ptr>{DAT, ret};
+                }
+                default:
+                    if (count == 1)
+                    {
+                        auto des = Head::deserialize(HeadView{
+                                .flags = flags,
+                                .length = static_cast<uint8_t>(chunks[0].size),
+                                .payload = chunks[0]
+                        }, 0, resource);
+                        if (!des)
                         {
-                            break;
+                            return pair<Flags, Package::Ptr>{NOT_SET, nullptr};
                         }
-                        if ((head->flags & DAT) == DAT)
+                        if (resource)
                         {
-                            string &&payload = ret->getPayload();
-
-                            auto retHead = dynamic_cast<Data *>(head->deserialize(chunk));
-                            payload += retHead->getChunk();
-
-                            ret->setPayload(payload);
-
-                            delete retHead;
-                        } else
-                            throw runtime_error("incompatible chunk inside heads");
-                        chunk++;
+                            return pair<Flags, Package::Ptr>{des->getFlag(), Package::Ptr(des, PackageDeleter(), std::pmr::polymorphic_allocator<Package>(resource))};
+                        }
+                        return pair<Flags, Package::Ptr>{des->getFlag(), Package::Ptr(des, PackageDeleter(), PoolAllocator<Package>())};
                     }
-                    return {DAT, ret};
-                }
-
-                return ret;
+                    return pair<Flags, Package::Ptr>{NOT_SET, nullptr};
             }
         }
+        catch (...)
+        {
+            //only allocations can throw
+            return ErrorCode::NO_MEMORY;
+        }
 #pragma clang diagnostic pop
 
+        //checksum policies of links
+#define HGARDENPI_PROTOCOL_CHECKSUM(C) \
+        template size_t getEncodedSize<C>(const Package &); \
+        template Result<EncodedFrames> tryEncodeInto<C>(const Package &, Flags, uint8_t *, size_t) noexcept; \
+        template Result<HeadView> tryView<C>(const uint8_t *, size_t) noexcept; \
+        template Result<HeadView> tryPeek<C>(const uint8_t *, size_t) noexcept; \
+        template ErrorCode tryViewBatch<C>(const uint8_t *, size_t, HeadView *, size_t, size_t &, size_t &) noexcept;
+
+        HGARDENPI_PROTOCOL_CHECKSUM(Crc16Checksum)
+        HGARDENPI_PROTOCOL_CHECKSUM(ModbusChecksum)
+        HGARDENPI_PROTOCOL_CHECKSUM(CcittChecksum)
+        HGARDENPI_PROTOCOL_CHECKSUM(Crc32Checksum)
+        HGARDENPI_PROTOCOL_CHECKSUM(NoChecksum)
+        HGARDENPI_PROTOCOL_CHECKSUM(Crc32cChecksum)
+
+#undef HGARDENPI_PROTOCOL_CHECKSUM
+
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "bugprone-branch-clone"
         [[maybe_unused]] bool endCommunication(const Head::Ptr &head) noexcept
@@ -0,0 +1,400 @@
+// MIT License
+//
+// Copyright (c) 2021. Happy GardenPI
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <hgardenpi-protocol/reassembler.hpp>
+
+#include <stdexcept>
+#include <cstring>
+using namespace std;
+
+#include <hgardenpi-protocol/protocol.hpp>
+
+namespace hgardenpi::protocol
+{
+    inline namespace v2
+    {
+
+        /**
+         * @brief Partial package, payload of every chunk is stored at its index
+         */
+        struct Reassembler::Slot final
+        {
+            /**
+             * @brief source and Head::id
+             */
+            uint64_t key = 0;
+
+            /**
+             * @brief tick of eviction
+             */
+            uint32_t deadline = 0;
+
+            /**
+             * @brief bit set of chunks received
+             */
+            uint32_t received = 0;
+
+            /**
+             * @brief previous slot in wheel bucket
+             */
+            uint16_t prev = NO_SLOT;
+
+            /**
+             * @brief next slot in wheel bucket or in free list
+             */
+            uint16_t next = NO_SLOT;
+
+            /**
+             * @brief flags of first chunk received
+             */
+            uint8_t flags = NOT_SET;
+
+            /**
+             * @brief chunks received, index of next chunk in arrival order
+             */
+            uint8_t chunks = 0;
+
+            /**
+             * @brief index of last chunk, shorter than HEAD_MAX_PAYLOAD_SIZE
+             */
+            uint8_t last = NO_CHUNK;
+
+            /**
+             * @brief FIN received
+             */
+            bool finished = false;
+
+            /**
+             * @brief length of every chunk
+             */
+            uint8_t lengths[HEAD_MAX_CHUNK + 1] = {};
+
+            /**
+             * @brief payload of every chunk
+             */
+            uint8_t payload[(HEAD_MAX_CHUNK + 1) * HEAD_MAX_PAYLOAD_SIZE] = {};
+        };
+
+        Reassembler::Reassembler(uint16_t maxPackages, uint32_t timeout) : timeout(timeout ? timeout : 1)
+        {
+            if (maxPackages == 0 || maxPackages == NO_SLOT)
+            {
+                throw runtime_error("max packages out of range");
+            }
+
+            //load of table at most 50%
+            tableSize = 1;
+            while (tableSize < maxPackages * 2u)
+            {
+                tableSize <<= 1;
+            }
+            wheelSize = 1;
+            while (wheelSize <= this->timeout && wheelSize < WHEEL_MAX_SIZE)
+            {
+                wheelSize <<= 1;
+            }
+
+            slots = new(nothrow) Slot[maxPackages];
+            table = new(nothrow) uint16_t[tableSize]();
+            wheel = new(nothrow) uint16_t[wheelSize];
+            if (!slots || !table || !wheel)
+            {
+                delete[] slots;
+                delete[] table;
+                delete[] wheel;
+                throw runtime_error("no memory for reassembler");
+            }
+
+            for (uint32_t i = 0; i < wheelSize; i++)
+            {
+                wheel[i] = NO_SLOT;
+            }
+            for (uint16_t i = 0; i < maxPackages; i++)
+            {
+                slots[i].next = i + 1 < maxPackages ? i + 1 : NO_SLOT;
+            }
+            freeSlot = 0;
+        }
+
+        Reassembler::~Reassembler() noexcept
+        {
+            delete[] slots;
+            delete[] table;
+            delete[] wheel;
+        }
+
+        Result<pair<Flags, Package::Ptr>> Reassembler::push(uint32_t source, const HeadView &frame, uint8_t chunk) noexcept
+        {
+            const pair<Flags, Package::Ptr> waiting{NOT_SET, nullptr};
+
+            //package in one frame
+            if ((frame.flags & CKN) == 0)
+            {
+                auto &&ret = tryComposeChunks(frame.flags, &frame.payload, 1);
+                if (ret)
+                {
+                    statistics.packages++;
+                }
+                return ret;
+            }
+
+            const uint64_t key = (static_cast<uint64_t>(source) << 0x08) | frame.id;
+            const uint8_t type = frame.flags & HEAD_PACKAGE_MASK;
+            uint16_t slot = find(key);
+
+            //FIN can arrive before chunks
+            if (slot == NO_SLOT)
+            {
+                slot = acquire(key);
+                if (slot == NO_SLOT)
+                {
+                    statistics.dropped++;
+                    return ErrorCode::NO_MEMORY;
+                }
+            }
+
+            if (type == FIN)
+            {
+                slots[slot].finished = true;
+            }
+            else
+            {
+                auto &&s = slots[slot];
+                if (s.flags == NOT_SET)
+                {
+                    s.flags = frame.flags;
+                }
+                else if ((s.flags & HEAD_PACKAGE_MASK) != type)
+                {
+                    release(slot);
+                    statistics.dropped++;
+                    return ErrorCode::INCOMPATIBLE_CHUNK;
+                }
+
+                if (chunk == NO_CHUNK)
+                {
+                    chunk = s.chunks;
+                }
+                if (chunk > HEAD_MAX_CHUNK)
+                {
+                    release(slot);
+                    statistics.dropped++;
+                    return ErrorCode::DATA_TOO_BIG;
+                }
+                if (s.received & (1u << chunk))
+                {
+                    statistics.duplicates++;
+                    return waiting;
+                }
+
+                memcpy(&s.payload[chunk * HEAD_MAX_PAYLOAD_SIZE], frame.payload.data, frame.length);
+                s.lengths[chunk] = frame.length;
+                s.received |= 1u << chunk;
+                s.chunks++;
+                if (frame.length < HEAD_MAX_PAYLOAD_SIZE)
+                {
+                    s.last = chunk;
+                }
+
+                //postpone eviction
+                unschedule(slot);
+                schedule(slot);
+            }
+
+            auto &&s = slots[slot];
+            if (s.finished && s.last != NO_CHUNK && s.received == (1u << (s.last + 1)) - 1)
+            {
+                return compose(slot);
+            }
+            return waiting;
+        }
+
+        size_t Reassembler::advance(uint32_t now) noexcept
+        {
+            size_t ret = 0;
+
+            //every bucket is visited at most once
+            uint32_t ticks = now - this->now;
+            if (ticks > wheelSize)
+            {
+                ticks = wheelSize;
+            }
+
+            for (uint32_t tick = 1; tick <= ticks; tick++)
+            {
+                uint16_t slot = wheel[(this->now + tick) & (wheelSize - 1)];
+                while (slot != NO_SLOT)
+                {
+                    uint16_t next = slots[slot].next;
+                    //with long timeout slot can wait more laps
+                    if (static_cast<int32_t>(slots[slot].deadline - now) <= 0)
+                    {
+                        release(slot);
+                        ret++;
+                    }
+                    slot = next;
+                }
+            }
+
+            this->now = now;
+            statistics.evicted += ret;
+            return ret;
+        }
+
+        size_t Reassembler::getSlotSize() noexcept
+        {
+            return sizeof(Slot) + 2 * sizeof(uint16_t);
+        }
+
+        uint32_t Reassembler::hash(uint64_t key) const noexcept
+        {
+            return static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ull) >> 0x20) & (tableSize - 1);
+        }
+
+        uint16_t Reassembler::find(uint64_t key) const noexcept
+        {
+            for (uint32_t i = hash(key); table[i]; i = (i + 1) & (tableSize - 1))
+            {
+                if (slots[table[i] - 1].key == key)
+                {
+                    return table[i] - 1;
+                }
+            }
+            return NO_SLOT;
+        }
+
+        uint16_t Reassembler::acquire(uint64_t key) noexcept
+        {
+            uint16_t slot = freeSlot;
+            if (slot == NO_SLOT)
+            {
+                return NO_SLOT;
+            }
+            freeSlot = slots[slot].next;
+
+            auto &&s = slots[slot];
+            s.key = key;
+            s.received = 0;
+            s.prev = NO_SLOT;
+            s.next = NO_SLOT;
+            s.flags = NOT_SET;
+            s.chunks = 0;
+            s.last = NO_CHUNK;
+            s.finished = false;
+
+            uint32_t i = hash(key);
+            while (table[i])
+            {
+                i = (i + 1) & (tableSize - 1);
+            }
+            table[i] = slot + 1;
+
+            schedule(slot);
+            pending++;
+            return slot;
+        }
+
+        void Reassembler::release(uint16_t slot) noexcept
+        {
+            unschedule(slot);
+
+            uint32_t i = hash(slots[slot].key);
+            while (table[i] != slot + 1)
+            {
+                i = (i + 1) & (tableSize - 1);
+            }
+            table[i] = 0;
+
+            //shift back following entries to keep probe sequences without holes
+            for (uint32_t j = (i + 1) & (tableSize - 1); table[j]; j = (j + 1) & (tableSize - 1))
+            {
+                uint32_t k = hash(slots[table[j] - 1].key);
+                bool stay = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+                if (!stay)
+                {
+                    table[i] = table[j];
+                    table[j] = 0;
+                    i = j;
+                }
+            }
+
+            slots[slot].next = freeSlot;
+            freeSlot = slot;
+            pending--;
+        }
+
+        void Reassembler::schedule(uint16_t slot) noexcept
+        {
+            auto &&s = slots[slot];
+            s.deadline = now + timeout;
+
+            uint16_t &bucket = wheel[s.deadline & (wheelSize - 1)];
+            s.prev = NO_SLOT;
+            s.next = bucket;
+            if (bucket != NO_SLOT)
+            {
+                slots[bucket].prev = slot;
+            }
+            bucket = slot;
+        }
+
+        void Reassembler::unschedule(uint16_t slot) noexcept
+        {
+            auto &&s = slots[slot];
+            if (s.prev != NO_SLOT)
+            {
+                slots[s.prev].next = s.next;
+            }
+            else
+            {
+                wheel[s.deadline & (wheelSize - 1)] = s.next;
+            }
+            if (s.next != NO_SLOT)
+            {
+                slots[s.next].prev = s.prev;
+            }
+            s.prev = NO_SLOT;
+            s.next = NO_SLOT;
+        }
+
+        Result<pair<Flags, Package::Ptr>> Reassembler::compose(uint16_t slot) noexcept
+        {
+            auto &&s = slots[slot];
+
+            BytesView chunks[HEAD_MAX_CHUNK + 1];
+            for (uint8_t i = 0; i <= s.last; i++)
+            {
+                chunks[i] = {&s.payload[i * HEAD_MAX_PAYLOAD_SIZE], s.lengths[i]};
+            }
+
+            auto &&ret = tryComposeChunks(s.flags, chunks, s.last + 1);
+            release(slot);
+            if (ret)
+            {
+                statistics.packages++;
+            }
+            return ret;
+        }
+
+    }
+}
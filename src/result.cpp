@@ -0,0 +1,70 @@
+// MIT License
+//
+// Copyright (c) 2021. Happy GardenPI
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <hgardenpi-protocol/result.hpp>
+
+namespace hgardenpi::protocol
+{
+    inline namespace v2
+    {
+
+        const char *getErrorMessage(ErrorCode error) noexcept
+        {
+            switch (error)
+            {
+                case ErrorCode::OK:
+                    return "ok";
+                case ErrorCode::NULL_PACKAGE:
+                    return "package null";
+                case ErrorCode::NOT_A_PACKAGE:
+                    return "class not child of Package";
+                case ErrorCode::NOT_SERIALIZABLE:
+                    return "package not serializable";
+                case ErrorCode::DATA_TOO_BIG:
+                    return "data to big, exceed HEAD_MAX_CHUNK";
+                case ErrorCode::BUFFER_TOO_SMALL:
+                    return "out buffer too small";
+                case ErrorCode::BUFFER_TOO_SHORT:
+                    return "buffer too short for head";
+                case ErrorCode::WRONG_VERSION:
+                    return "wrong protocol version";
+                case ErrorCode::FLAGS_OUT_OF_RANGE:
+                    return "head flags out of range or more packages set";
+                case ErrorCode::CRC_NOT_MATCH:
+                    return "crc not match";
+                case ErrorCode::NO_MEMORY:
+                    return "no memory";
+                case ErrorCode::NO_HEAD:
+                    return "no head in vector";
+                case ErrorCode::PACKAGE_INCOMPLETE:
+                    return "package incomplete";
+                case ErrorCode::INCOMPATIBLE_CHUNK:
+                    return "incompatible chunk inside heads";
+                case ErrorCode::PAYLOAD_MALFORMED:
+                    return "payload length not match";
+            }
+            return "unknown error";
+        }
+
+    }
+}
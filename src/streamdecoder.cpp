@@ -0,0 +1,206 @@
+// MIT License
+//
+// Copyright (c) 2021. Happy GardenPI
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <hgardenpi-protocol/streamdecoder.hpp>
+
+#include <algorithm>
+#include <cstring>
+using namespace std;
+
+namespace hgardenpi::protocol
+{
+    inline namespace v2
+    {
+
+        /**
+         * @brief Check if a byte can be the first one of a frame
+         * @param data first byte of frame, version and flags
+         * @return true if version is supported and flags contain only one package or only ACK
+         */
+        static inline bool checkHead(uint8_t data) noexcept
+        {
+            if (((data & 0x80) >> 0x07) != CURRENT_PROTOCOL_ACTIVE_VERSION)
+            {
+                return false;
+            }
+            return checkFlags(data & 0x7F);
+        }
+
+        /**
+         * @brief Check length of a frame with a complete head, acknowledges carry only the next id expected
+         * @param frame with at least HEAD_HEADER_SIZE bytes
+         * @return false if frame is an acknowledge with a wrong length
+         */
+        static inline bool checkLength(const uint8_t *frame) noexcept
+        {
+            return (frame[0] & HEAD_PACKAGE_MASK) != NOT_SET || frame[2] == 1;
+        }
+
+        /**
+         * @brief Get size of frame from its head
+         * @param frame with at least HEAD_HEADER_SIZE bytes
+         * @param checksumSize size of checksum of link
+         * @return frame size
+         */
+        static inline uint16_t getFrameSize(const uint8_t *frame, uint8_t checksumSize) noexcept
+        {
+            return HEAD_HEADER_SIZE + frame[2] + checksumSize;
+        }
+
+        StreamDecoder::StreamDecoder(ChecksumType checksum) noexcept : checksum(checksum), checksumSize(getChecksumSize(checksum))
+        {
+        }
+
+        pair<const uint8_t *, uint16_t> StreamDecoder::next(const uint8_t *&data, size_t &size) noexcept
+        {
+            //discard frame returned by previous call
+            if (emitted)
+            {
+                shift(emitted);
+                emitted = 0;
+            }
+
+            while (true)
+            {
+                if (length == 0)
+                {
+                    //nothing buffered, frames are returned directly from data without copy
+                    while (size > 0 && !checkHead(data[0]))
+                    {
+                        data++;
+                        size--;
+                        statistics.droppedBytes++;
+                    }
+                    if (size == 0)
+                    {
+                        return {nullptr, 0};
+                    }
+
+                    if (size >= HEAD_HEADER_SIZE)
+                    {
+                        if (!checkLength(data))
+                        {
+                            data++;
+                            size--;
+                            statistics.droppedBytes++;
+                            continue;
+                        }
+
+                        uint16_t frameSize = getFrameSize(data, checksumSize);
+                        if (size >= frameSize)
+                        {
+                            const uint8_t *frame = data;
+                            if (checkChecksum(checksum, frame, frameSize))
+                            {
+                                data += frameSize;
+                                size -= frameSize;
+                                statistics.frames++;
+                                return {frame, frameSize};
+                            }
+
+                            //resynchronize from next byte
+                            data++;
+                            size--;
+                            statistics.crcErrors++;
+                            statistics.droppedBytes++;
+                            continue;
+                        }
+                    }
+
+                    //keep partial frame
+                    memcpy(buffer, data, size);
+                    length = size;
+                    data += size;
+                    size = 0;
+                    return {nullptr, 0};
+                }
+
+                //search head in buffered bytes
+                if (!checkHead(buffer[0]))
+                {
+                    size_t skip = 1;
+                    while (skip < length && !checkHead(buffer[skip]))
+                    {
+                        skip++;
+                    }
+                    statistics.droppedBytes += skip;
+                    shift(skip);
+                    continue;
+                }
+
+                if (length >= HEAD_HEADER_SIZE && !checkLength(buffer))
+                {
+                    statistics.droppedBytes++;
+                    shift(1);
+                    continue;
+                }
+
+                //complete head first then the rest of frame
+                uint16_t frameSize = length >= HEAD_HEADER_SIZE ? getFrameSize(buffer, checksumSize) : HEAD_HEADER_SIZE;
+                if (length < frameSize)
+                {
+                    size_t bytes = min(static_cast<size_t>(frameSize - length), size);
+                    memcpy(buffer + length, data, bytes);
+                    length += bytes;
+                    data += bytes;
+                    size -= bytes;
+                    if (length < frameSize)
+                    {
+                        return {nullptr, 0};
+                    }
+                    continue;
+                }
+
+                if (checkChecksum(checksum, buffer, frameSize))
+                {
+                    emitted = frameSize;
+                    statistics.frames++;
+                    return {buffer, frameSize};
+                }
+
+                //resynchronize from next byte buffered
+                statistics.crcErrors++;
+                statistics.droppedBytes++;
+                shift(1);
+            }
+        }
+
+        void StreamDecoder::reset() noexcept
+        {
+            length = 0;
+            emitted = 0;
+        }
+
+        void StreamDecoder::shift(size_t bytes) noexcept
+        {
+            if (bytes >= length)
+            {
+                length = 0;
+                return;
+            }
+            memmove(buffer, buffer + bytes, length - bytes);
+            length -= bytes;
+        }
+
+    }
+}
@@ -0,0 +1,431 @@
+// MIT License
+//
+// Copyright (c) 2021. Happy GardenPI
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <hgardenpi-protocol/transport.hpp>
+
+#include <stdexcept>
+#include <cstring>
+using namespace std;
+
+#include <hgardenpi-protocol/protocol.hpp>
+
+namespace hgardenpi::protocol
+{
+    inline namespace v2
+    {
+
+        /**
+         * @brief Frame sent and not acknowledged
+         */
+        struct Transport::SendSlot final
+        {
+            /**
+             * @brief frame with Head::id updated
+             */
+            Buffer frame;
+
+            /**
+             * @brief tick of last send
+             */
+            uint32_t sent = 0;
+
+            /**
+             * @brief tick of retransmission
+             */
+            uint32_t expire = 0;
+
+            /**
+             * @brief times frame is sent again
+             */
+            uint8_t retries = 0;
+
+            /**
+             * @brief acknowledged by peer
+             */
+            bool acknowledged = false;
+        };
+
+        /**
+         * @brief Frame received, only flags and payload are kept
+         */
+        struct Transport::ReceiveSlot final
+        {
+            /**
+             * @brief flags of frame
+             */
+            uint8_t flags = NOT_SET;
+
+            /**
+             * @brief length of payload
+             */
+            uint8_t length = 0;
+
+            /**
+             * @brief frame received and not taken by pop()
+             */
+            bool received = false;
+
+            /**
+             * @brief payload of frame
+             */
+            uint8_t payload[HEAD_MAX_PAYLOAD_SIZE] = {};
+        };
+
+        /**
+         * @brief Check if a tick is reached, ticks are wrapping
+         * @param now current tick
+         * @param tick to check
+         * @return true if now is tick or after it
+         */
+        static inline bool isReached(uint32_t now, uint32_t tick) noexcept
+        {
+            return static_cast<int32_t>(now - tick) >= 0;
+        }
+
+        Transport::Transport(uint8_t window, uint32_t timeout, uint32_t maxTimeout, ChecksumType checksum)
+                : timeout(timeout ? timeout : 1), maxTimeout(maxTimeout), checksum(checksum)
+        {
+            if (this->maxTimeout < this->timeout)
+            {
+                this->maxTimeout = this->timeout;
+            }
+
+            //power of 2 for index slots by Head::id
+            this->window = 1;
+            while (this->window < window && this->window < TRANSPORT_MAX_WINDOW)
+            {
+                this->window <<= 1;
+            }
+            mask = this->window - 1;
+
+            sendSlots = new(nothrow) SendSlot[this->window];
+            receiveSlots = new(nothrow) ReceiveSlot[this->window];
+            chunks = new(nothrow) uint8_t[(HEAD_MAX_CHUNK + 1) * HEAD_MAX_PAYLOAD_SIZE];
+            if (!sendSlots || !receiveSlots || !chunks)
+            {
+                delete[] sendSlots;
+                delete[] receiveSlots;
+                delete[] chunks;
+                throw runtime_error("no memory for transport");
+            }
+        }
+
+        Transport::~Transport() noexcept
+        {
+            delete[] sendSlots;
+            delete[] receiveSlots;
+            delete[] chunks;
+        }
+
+        ErrorCode Transport::send(const Package &package, Flags additionalFags) noexcept
+        {
+            auto &&frames = tryEncode(&package, additionalFags, checksum);
+            if (!frames)
+            {
+                return frames.getError();
+            }
+
+            const size_t size = queue.size();
+            try
+            {
+                for (auto &&frame : *frames)
+                {
+                    queue.push_back(move(frame));
+                }
+            }
+            catch (const bad_alloc &)
+            {
+                //never queue a package in part
+                queue.resize(size);
+                return ErrorCode::NO_MEMORY;
+            }
+
+            return ErrorCode::OK;
+        }
+
+        BytesView Transport::poll(uint32_t now) noexcept
+        {
+            //acknowledges first, they move window of peer
+            if (ackCount > 0 || ackPending)
+            {
+                uint8_t id = receiveBase - 1;
+                if (ackCount > 0)
+                {
+                    id = acks[ackFirst];
+                    ackFirst = (ackFirst + 1) % TRANSPORT_MAX_WINDOW;
+                    ackCount--;
+                }
+                //every acknowledge carry next frame expected in order
+                ackPending = false;
+
+                ack[0] = ACK;
+                ack[1] = id;
+                ack[2] = 1;
+                ack[3] = receiveBase;
+                const size_t size = HEAD_HEADER_SIZE + 1;
+
+                return {ack, size + fillChecksum(checksum, ack, size)};
+            }
+
+            const uint8_t inFlight = nextId - sendBase;
+
+            //send again first frame with timeout expired, deadline is updated with the others
+            if (inFlight > 0 && isReached(now, deadline))
+            {
+                SendSlot *expired = nullptr;
+                deadline = now + maxTimeout;
+                for (uint8_t i = 0; i < inFlight; i++)
+                {
+                    auto &&slot = sendSlots[(sendBase + i) & mask];
+                    if (slot.acknowledged)
+                    {
+                        continue;
+                    }
+                    if (!expired && isReached(now, slot.expire))
+                    {
+                        //exponential backoff
+                        if (slot.retries < 31)
+                        {
+                            slot.retries++;
+                        }
+                        uint64_t backoff = static_cast<uint64_t>(timeout) << slot.retries;
+                        slot.sent = now;
+                        slot.expire = now + (backoff < maxTimeout ? static_cast<uint32_t>(backoff) : maxTimeout);
+                        expired = &slot;
+                        statistics.retransmitted++;
+                    }
+                    if (!isReached(slot.expire, deadline))
+                    {
+                        deadline = slot.expire;
+                    }
+                }
+                if (expired)
+                {
+                    return {expired->frame.first.get(), expired->frame.second};
+                }
+            }
+
+            //send a new frame if window is not full
+            if (inFlight < window && !queue.empty())
+            {
+                auto &&slot = sendSlots[nextId & mask];
+                slot.frame = move(queue.front());
+                queue.pop_front();
+                updateIdToBufferEncoded(slot.frame, nextId, checksum);
+                slot.sent = now;
+                slot.expire = now + timeout;
+                slot.retries = 0;
+                slot.acknowledged = false;
+                if (inFlight == 0 || !isReached(slot.expire, deadline))
+                {
+                    deadline = slot.expire;
+                }
+                nextId++;
+                statistics.sent++;
+
+                return {slot.frame.first.get(), slot.frame.second};
+            }
+
+            return {};
+        }
+
+        ErrorCode Transport::receive(const uint8_t *data, size_t size, uint32_t now) noexcept
+        {
+            auto &&frame = tryView(data, size, checksum);
+            if (!frame)
+            {
+                return frame.getError();
+            }
+
+            //acknowledge has no package
+            if ((frame->flags & HEAD_PACKAGE_MASK) == NOT_SET)
+            {
+                if (frame->flags != ACK || frame->length != 1)
+                {
+                    return ErrorCode::FLAGS_OUT_OF_RANGE;
+                }
+                acknowledge(*frame, now);
+                return ErrorCode::OK;
+            }
+
+            const uint8_t id = frame->id;
+
+            //frame before next expected in order, peer lost its acknowledge
+            if (static_cast<uint8_t>(receiveBase - id - 1) < window)
+            {
+                statistics.duplicates++;
+                ackPending = true;
+                return ErrorCode::OK;
+            }
+
+            //frame after window of frames not taken by pop()
+            if (static_cast<uint8_t>(id - delivered) >= window)
+            {
+                statistics.dropped++;
+                return ErrorCode::OK;
+            }
+
+            auto &&slot = receiveSlots[id & mask];
+            if (slot.received)
+            {
+                statistics.duplicates++;
+            }
+            else
+            {
+                slot.flags = frame->flags;
+                slot.length = frame->length;
+                memcpy(slot.payload, frame->payload.data, frame->length);
+                slot.received = true;
+            }
+
+            if (id == receiveBase)
+            {
+                //frames received out of order before are in order now
+                while (static_cast<uint8_t>(receiveBase - delivered) < window && receiveSlots[receiveBase & mask].received)
+                {
+                    receiveBase++;
+                }
+                ackPending = true;
+            }
+            else if (ackCount < TRANSPORT_MAX_WINDOW)
+            {
+                acks[(ackFirst + ackCount) % TRANSPORT_MAX_WINDOW] = id;
+                ackCount++;
+            }
+
+            return ErrorCode::OK;
+        }
+
+        Result<pair<Flags, Package::Ptr>> Transport::pop() noexcept
+        {
+            const pair<Flags, Package::Ptr> waiting{NOT_SET, nullptr};
+
+            while (delivered != receiveBase)
+            {
+                auto &&slot = receiveSlots[delivered & mask];
+                slot.received = false;
+                delivered++;
+
+                //package in one frame
+                if ((slot.flags & CKN) == 0)
+                {
+                    BytesView payload{slot.payload, slot.length};
+                    return tryComposeChunks(slot.flags, &payload, 1);
+                }
+
+                //FIN close chunks
+                if ((slot.flags & HEAD_PACKAGE_MASK) == FIN)
+                {
+                    uint8_t count = chunkCount;
+                    chunkCount = 0;
+                    return tryComposeChunks(chunkFlags, views, count);
+                }
+
+                if (chunkCount > HEAD_MAX_CHUNK)
+                {
+                    chunkCount = 0;
+                    return ErrorCode::DATA_TOO_BIG;
+                }
+
+                //chunks are copied, slots are reused by next frames
+                if (chunkCount == 0)
+                {
+                    chunkFlags = slot.flags;
+                }
+                auto chunk = &chunks[chunkCount * HEAD_MAX_PAYLOAD_SIZE];
+                memcpy(chunk, slot.payload, slot.length);
+                views[chunkCount++] = {chunk, slot.length};
+            }
+
+            return waiting;
+        }
+
+        void Transport::measure(uint32_t sample) noexcept
+        {
+            if (!measured)
+            {
+                rtt = sample << 3;
+                rttVariation = sample << 1;
+                measured = true;
+            }
+            else
+            {
+                //rtt = 7/8 rtt + 1/8 sample, rttVariation = 3/4 rttVariation + 1/4 |rtt - sample|
+                int32_t delta = static_cast<int32_t>(sample - (rtt >> 3));
+                rtt += delta;
+                if (delta < 0)
+                {
+                    delta = -delta;
+                }
+                rttVariation += delta - (rttVariation >> 2);
+            }
+
+            //timeout = rtt + 4 * rttVariation, at least one tick more than rtt
+            uint64_t ret = (rtt >> 3) + static_cast<uint64_t>(rttVariation ? rttVariation : 1);
+            timeout = ret < maxTimeout ? static_cast<uint32_t>(ret) : maxTimeout;
+        }
+
+        void Transport::acknowledge(const HeadView &frame, uint32_t now) noexcept
+        {
+            const uint8_t inFlight = nextId - sendBase;
+
+            //frame acknowledged, Karn algorithm measure only frames not sent again
+            if (static_cast<uint8_t>(frame.id - sendBase) < inFlight)
+            {
+                auto &&slot = sendSlots[frame.id & mask];
+                if (!slot.acknowledged)
+                {
+                    if (slot.retries == 0)
+                    {
+                        measure(now - slot.sent);
+                    }
+                    slot.acknowledged = true;
+                    statistics.acknowledged++;
+                }
+            }
+
+            //frames before next expected by peer are acknowledged too, also if their acknowledges are lost
+            const uint8_t expected = frame.payload[0];
+            if (static_cast<uint8_t>(expected - sendBase) <= inFlight)
+            {
+                for (uint8_t id = sendBase; id != expected; id++)
+                {
+                    auto &&slot = sendSlots[id & mask];
+                    if (!slot.acknowledged)
+                    {
+                        slot.acknowledged = true;
+                        statistics.acknowledged++;
+                    }
+                }
+            }
+
+            //move window after frames acknowledged
+            while (sendBase != nextId && sendSlots[sendBase & mask].acknowledged)
+            {
+                sendSlots[sendBase & mask].frame = {};
+                sendBase++;
+            }
+        }
+
+    }
+}
@@ -0,0 +1,582 @@
+// MIT License
+//
+// Copyright (c) 2021. Happy GardenPI
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <hgardenpi-protocol/utilities/crcutils.hpp>
+
+#include <array>
+#include <cstring>
+using namespace std;
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define HGARDENPI_PROTOCOL_CRC16_CLMUL __attribute__((target("pclmul,sse2")))
+#define HGARDENPI_PROTOCOL_CRC32C __attribute__((target("sse4.2")))
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#include <arm_acle.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#if defined(__clang__)
+#define HGARDENPI_PROTOCOL_CRC16_CLMUL __attribute__((target("aes")))
+#define HGARDENPI_PROTOCOL_CRC32C __attribute__((target("crc")))
+#else
+#define HGARDENPI_PROTOCOL_CRC16_CLMUL __attribute__((target("+crypto")))
+#define HGARDENPI_PROTOCOL_CRC32C __attribute__((target("+crc")))
+#endif
+#endif
+
+#include <hgardenpi-protocol/3thparts/libcrc/checksum.h>
+
+namespace hgardenpi::protocol
+{
+    inline namespace v2
+    {
+
+        /**
+         * @brief number of bytes processed for every step of slicing-by-8
+         */
+        constexpr const inline uint8_t CRC16_SLICES = 8;
+
+        typedef array<array<uint16_t, 256>, CRC16_SLICES> Crc16Tables;
+
+        /**
+         * @brief Generate slicing-by-8 tables, table n contain crc16 of a byte followed by n zero bytes
+         * @return tables
+         */
+        static constexpr Crc16Tables generateCrc16Tables() noexcept
+        {
+            Crc16Tables ret{};
+            for (uint16_t i = 0; i < 256; i++)
+            {
+                uint16_t crc = 0;
+                uint16_t c = i;
+                for (uint8_t j = 0; j < 8; j++)
+                {
+                    crc = ((crc ^ c) & 0x0001) ? (crc >> 1) ^ CRC_POLY_16 : crc >> 1;
+                    c = c >> 1;
+                }
+                ret[0][i] = crc;
+            }
+            for (uint8_t n = 1; n < CRC16_SLICES; n++)
+            {
+                for (uint16_t i = 0; i < 256; i++)
+                {
+                    ret[n][i] = (ret[n - 1][i] >> 8) ^ ret[0][ret[n - 1][i] & 0x00FF];
+                }
+            }
+            return ret;
+        }
+
+        static constexpr const Crc16Tables CRC16_TABLES = generateCrc16Tables();
+
+        uint16_t crc16Table(const uint8_t *data, size_t size, uint16_t crc) noexcept
+        {
+            if (!data)
+            {
+                return crc;
+            }
+
+            const auto &t = CRC16_TABLES;
+            for (; size >= CRC16_SLICES; size -= CRC16_SLICES, data += CRC16_SLICES)
+            {
+                crc = t[7][(data[0] ^ crc) & 0x00FF] ^ t[6][(data[1] ^ (crc >> 8)) & 0x00FF] ^
+                      t[5][data[2]] ^ t[4][data[3]] ^ t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+            }
+            for (; size > 0; size--, data++)
+            {
+                crc = (crc >> 8) ^ t[0][(crc ^ *data) & 0x00FF];
+            }
+
+            return crc;
+        }
+
+        /**
+         * @brief Generate slicing-by-8 tables of CRC-CCITT, bits not reflected
+         * @return tables
+         */
+        static constexpr Crc16Tables generateCrcCcittTables() noexcept
+        {
+            Crc16Tables ret{};
+            for (uint16_t i = 0; i < 256; i++)
+            {
+                uint16_t crc = static_cast<uint16_t>(i << 8);
+                for (uint8_t j = 0; j < 8; j++)
+                {
+                    crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ CRC_POLY_CCITT) : static_cast<uint16_t>(crc << 1);
+                }
+                ret[0][i] = crc;
+            }
+            for (uint8_t n = 1; n < CRC16_SLICES; n++)
+            {
+                for (uint16_t i = 0; i < 256; i++)
+                {
+                    ret[n][i] = static_cast<uint16_t>((ret[n - 1][i] << 8) ^ ret[0][ret[n - 1][i] >> 8]);
+                }
+            }
+            return ret;
+        }
+
+        static constexpr const Crc16Tables CRC_CCITT_TABLES = generateCrcCcittTables();
+
+        uint16_t crcCcitt(const uint8_t *data, size_t size, uint16_t crc) noexcept
+        {
+            if (!data)
+            {
+                return crc;
+            }
+
+            const auto &t = CRC_CCITT_TABLES;
+            for (; size >= CRC16_SLICES; size -= CRC16_SLICES, data += CRC16_SLICES)
+            {
+                crc = t[7][data[0] ^ (crc >> 8)] ^ t[6][data[1] ^ (crc & 0x00FF)] ^
+                      t[5][data[2]] ^ t[4][data[3]] ^ t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+            }
+            for (; size > 0; size--, data++)
+            {
+                crc = static_cast<uint16_t>((crc << 8) ^ t[0][(crc >> 8) ^ *data]);
+            }
+
+            return crc;
+        }
+
+        typedef array<array<uint32_t, 256>, CRC16_SLICES> Crc32Tables;
+
+        /**
+         * @brief Generate slicing-by-8 tables of a CRC32 with bits reflected
+         * @tparam P polynomial reflected
+         * @return tables
+         */
+        template<uint32_t P>
+        static constexpr Crc32Tables generateCrc32Tables() noexcept
+        {
+            Crc32Tables ret{};
+            for (uint16_t i = 0; i < 256; i++)
+            {
+                uint32_t crc = i;
+                for (uint8_t j = 0; j < 8; j++)
+                {
+                    crc = (crc & 0x00000001) ? (crc >> 1) ^ P : crc >> 1;
+                }
+                ret[0][i] = crc;
+            }
+            for (uint8_t n = 1; n < CRC16_SLICES; n++)
+            {
+                for (uint16_t i = 0; i < 256; i++)
+                {
+                    ret[n][i] = (ret[n - 1][i] >> 8) ^ ret[0][ret[n - 1][i] & 0x000000FF];
+                }
+            }
+            return ret;
+        }
+
+        /**
+         * @brief Calculate a CRC32 with bits reflected, start and end inverted
+         * @param t slicing-by-8 tables
+         * @param data bytes
+         * @param size number of bytes
+         * @param crc value of previous bytes
+         * @return crc32
+         */
+        static inline uint32_t crc32Tables(const Crc32Tables &t, const uint8_t *data, size_t size, uint32_t crc) noexcept
+        {
+            if (!data)
+            {
+                return crc;
+            }
+
+            crc = ~crc;
+            for (; size >= CRC16_SLICES; size -= CRC16_SLICES, data += CRC16_SLICES)
+            {
+                uint32_t low = crc ^ (data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24));
+                crc = t[7][low & 0x000000FF] ^ t[6][(low >> 8) & 0x000000FF] ^ t[5][(low >> 16) & 0x000000FF] ^ t[4][low >> 24] ^
+                      t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+            }
+            for (; size > 0; size--, data++)
+            {
+                crc = (crc >> 8) ^ t[0][(crc ^ *data) & 0x000000FF];
+            }
+
+            return ~crc;
+        }
+
+        static constexpr const Crc32Tables CRC32_TABLES = generateCrc32Tables<CRC_POLY_32>();
+
+        uint32_t crc32(const uint8_t *data, size_t size, uint32_t crc) noexcept
+        {
+            return crc32Tables(CRC32_TABLES, data, size, crc);
+        }
+
+        /**
+         * @brief Castagnoli polynomial reflected
+         */
+        constexpr const inline uint32_t CRC32C_POLY = 0x82F63B78;
+
+        static constexpr const Crc32Tables CRC32C_TABLES = generateCrc32Tables<CRC32C_POLY>();
+
+        uint32_t crc32cTable(const uint8_t *data, size_t size, uint32_t crc) noexcept
+        {
+            return crc32Tables(CRC32C_TABLES, data, size, crc);
+        }
+
+        typedef array<array<uint16_t, 8>, CRC16_PATCH_MAX_DISTANCE + 1> Crc16PatchTable;
+
+        /**
+         * @brief Generate table of crc16Patch(), entry n, b contain crc16 of bit b followed by n zero bytes
+         * @return table
+         */
+        static constexpr Crc16PatchTable generateCrc16PatchTable() noexcept
+        {
+            Crc16PatchTable ret{};
+            for (uint8_t b = 0; b < 8; b++)
+            {
+                ret[0][b] = CRC16_TABLES[0][1u << b];
+            }
+            for (uint16_t n = 1; n <= CRC16_PATCH_MAX_DISTANCE; n++)
+            {
+                for (uint8_t b = 0; b < 8; b++)
+                {
+                    ret[n][b] = (ret[n - 1][b] >> 8) ^ CRC16_TABLES[0][ret[n - 1][b] & 0x00FF];
+                }
+            }
+            return ret;
+        }
+
+        static constexpr const Crc16PatchTable CRC16_PATCH_TABLE = generateCrc16PatchTable();
+
+        uint16_t crc16Patch(uint16_t crc, uint8_t delta, size_t distance) noexcept
+        {
+            //crc16 of change followed by zero bytes, it is linear on bits of delta
+            const auto &t = CRC16_PATCH_TABLE[distance < CRC16_PATCH_MAX_DISTANCE ? distance : CRC16_PATCH_MAX_DISTANCE];
+            uint16_t correction = 0;
+            for (uint8_t b = 0; b < 8; b++)
+            {
+                correction ^= t[b] & -static_cast<uint16_t>((delta >> b) & 0x01);
+            }
+
+            //longer distances go on with zero bytes
+            for (; distance > CRC16_PATCH_MAX_DISTANCE; distance--)
+            {
+                correction = (correction >> 8) ^ CRC16_TABLES[0][correction & 0x00FF];
+            }
+
+            return crc ^ correction;
+        }
+
+        /**
+         * @brief Calculate x^n mod P where P is CRC16 polynomial 0x8005 not reflected
+         * @param n exponent
+         * @return remainder, degree less than 16
+         */
+        static constexpr uint16_t crc16XPowMod(uint16_t n) noexcept
+        {
+            uint32_t ret = 1;
+            for (uint16_t i = 0; i < n; i++)
+            {
+                ret <<= 1;
+                if (ret & 0x10000)
+                {
+                    ret ^= 0x18005;
+                }
+            }
+            return static_cast<uint16_t>(ret);
+        }
+
+        /**
+         * @brief Generate a folding constant, x^n mod P reflected in 64 bits as the data loaded from memory
+         * @param n exponent
+         * @return folding constant
+         */
+        static constexpr uint64_t crc16FoldConstant(uint16_t n) noexcept
+        {
+            uint16_t mod = crc16XPowMod(n);
+            uint64_t ret = 0;
+            for (uint8_t i = 0; i < 16; i++)
+            {
+                if (mod & (1 << i))
+                {
+                    ret |= 1ull << (63 - i);
+                }
+            }
+            return ret;
+        }
+
+        /**
+         * @brief Size of block folded with carry-less multiply
+         */
+        constexpr const inline uint8_t CRC16_CLMUL_BLOCK = 16;
+
+        /**
+         * @brief Blocks folded in parallel
+         */
+        constexpr const inline uint8_t CRC16_CLMUL_BLOCKS = 4;
+
+        /**
+         * @brief Folding constants, a block is moved forward of n bits multiplying high degree half by
+         * x^(n + 63) and low degree half by x^(n - 1), one more x is added by the reflected product
+         */
+        constexpr const inline uint64_t CRC16_FOLD_512_HIGH = crc16FoldConstant(512 + 63);
+        constexpr const inline uint64_t CRC16_FOLD_512_LOW = crc16FoldConstant(512 - 1);
+        constexpr const inline uint64_t CRC16_FOLD_128_HIGH = crc16FoldConstant(128 + 63);
+        constexpr const inline uint64_t CRC16_FOLD_128_LOW = crc16FoldConstant(128 - 1);
+
+#if defined(__x86_64__)
+
+        HGARDENPI_PROTOCOL_CRC16_CLMUL
+        static inline __m128i crc16Fold(__m128i block, __m128i k, __m128i next) noexcept
+        {
+            return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(block, k, 0x00),
+                                               _mm_clmulepi64_si128(block, k, 0x11)), next);
+        }
+
+        HGARDENPI_PROTOCOL_CRC16_CLMUL
+        static uint16_t crc16ClmulImpl(const uint8_t *data, size_t size, uint16_t crc) noexcept
+        {
+            //low qword multiply the high degree half of block
+            const __m128i k4 = _mm_set_epi64x(static_cast<int64_t>(CRC16_FOLD_512_LOW), static_cast<int64_t>(CRC16_FOLD_512_HIGH));
+            const __m128i k1 = _mm_set_epi64x(static_cast<int64_t>(CRC16_FOLD_128_LOW), static_cast<int64_t>(CRC16_FOLD_128_HIGH));
+            auto load = [](const uint8_t *ptr) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr)); };
+
+            //previous crc is added to first bytes
+            __m128i x0 = _mm_xor_si128(load(data), _mm_cvtsi32_si128(crc));
+            __m128i x1 = load(data + CRC16_CLMUL_BLOCK);
+            __m128i x2 = load(data + CRC16_CLMUL_BLOCK * 2);
+            __m128i x3 = load(data + CRC16_CLMUL_BLOCK * 3);
+            data += CRC16_CLMUL_BLOCK * CRC16_CLMUL_BLOCKS;
+            size -= CRC16_CLMUL_BLOCK * CRC16_CLMUL_BLOCKS;
+
+            for (; size >= CRC16_CLMUL_BLOCK * CRC16_CLMUL_BLOCKS; size -= CRC16_CLMUL_BLOCK * CRC16_CLMUL_BLOCKS)
+            {
+                x0 = crc16Fold(x0, k4, load(data));
+                x1 = crc16Fold(x1, k4, load(data + CRC16_CLMUL_BLOCK));
+                x2 = crc16Fold(x2, k4, load(data + CRC16_CLMUL_BLOCK * 2));
+                x3 = crc16Fold(x3, k4, load(data + CRC16_CLMUL_BLOCK * 3));
+                data += CRC16_CLMUL_BLOCK * CRC16_CLMUL_BLOCKS;
+            }
+
+            //reduce to one block
+            x3 = crc16Fold(crc16Fold(crc16Fold(x0, k1, x1), k1, x2), k1, x3);
+            for (; size >= CRC16_CLMUL_BLOCK; size -= CRC16_CLMUL_BLOCK, data += CRC16_CLMUL_BLOCK)
+            {
+                x3 = crc16Fold(x3, k1, load(data));
+            }
+
+            //folded block has the same remainder of data folded, finish it and the tail with tables
+            uint8_t block[CRC16_CLMUL_BLOCK];
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(block), x3);
+            return crc16Table(data, size, crc16Table(block, CRC16_CLMUL_BLOCK));
+        }
+
+        static bool crc16ClmulDetect() noexcept
+        {
+            return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse2");
+        }
+
+#elif defined(__aarch64__)
+
+        HGARDENPI_PROTOCOL_CRC16_CLMUL
+        static inline uint64x2_t crc16Fold(uint64x2_t block, poly64x2_t k, uint64x2_t next) noexcept
+        {
+            poly128_t high = vmull_p64(static_cast<poly64_t>(vgetq_lane_u64(block, 0)), vgetq_lane_p64(k, 0));
+            poly128_t low = vmull_high_p64(vreinterpretq_p64_u64(block), k);
+            return veorq_u64(veorq_u64(vreinterpretq_u64_p128(high), vreinterpretq_u64_p128(low)), next);
+        }
+
+        HGARDENPI_PROTOCOL_CRC16_CLMUL
+        static uint16_t crc16ClmulImpl(const uint8_t *data, size_t size, uint16_t crc) noexcept
+        {
+            //lane 0 multiply the high degree half of block
+            const poly64x2_t k4 = vcombine_p64(vcreate_p64(CRC16_FOLD_512_HIGH), vcreate_p64(CRC16_FOLD_512_LOW));
+            const poly64x2_t k1 = vcombine_p64(vcreate_p64(CRC16_FOLD_128_HIGH), vcreate_p64(CRC16_FOLD_128_LOW));
+            auto load = [](const uint8_t *ptr) { return vreinterpretq_u64_u8(vld1q_u8(ptr)); };
+
+            //previous crc is added to first bytes
+            uint64x2_t x0 = veorq_u64(load(data), vcombine_u64(vcreate_u64(crc), vcreate_u64(0)));
+            uint64x2_t x1 = load(data + CRC16_CLMUL_BLOCK);
+            uint64x2_t x2 = load(data + CRC16_CLMUL_BLOCK * 2);
+            uint64x2_t x3 = load(data + CRC16_CLMUL_BLOCK * 3);
+            data += CRC16_CLMUL_BLOCK * CRC16_CLMUL_BLOCKS;
+            size -= CRC16_CLMUL_BLOCK * CRC16_CLMUL_BLOCKS;
+
+            for (; size >= CRC16_CLMUL_BLOCK * CRC16_CLMUL_BLOCKS; size -= CRC16_CLMUL_BLOCK * CRC16_CLMUL_BLOCKS)
+            {
+                x0 = crc16Fold(x0, k4, load(data));
+                x1 = crc16Fold(x1, k4, load(data + CRC16_CLMUL_BLOCK));
+                x2 = crc16Fold(x2, k4, load(data + CRC16_CLMUL_BLOCK * 2));
+                x3 = crc16Fold(x3, k4, load(data + CRC16_CLMUL_BLOCK * 3));
+                data += CRC16_CLMUL_BLOCK * CRC16_CLMUL_BLOCKS;
+            }
+
+            //reduce to one block
+            x3 = crc16Fold(crc16Fold(crc16Fold(x0, k1, x1), k1, x2), k1, x3);
+            for (; size >= CRC16_CLMUL_BLOCK; size -= CRC16_CLMUL_BLOCK, data += CRC16_CLMUL_BLOCK)
+            {
+                x3 = crc16Fold(x3, k1, load(data));
+            }
+
+            //folded block has the same remainder of data folded, finish it and the tail with tables
+            uint8_t block[CRC16_CLMUL_BLOCK];
+            vst1q_u8(block, vreinterpretq_u8_u64(x3));
+            return crc16Table(data, size, crc16Table(block, CRC16_CLMUL_BLOCK));
+        }
+
+        static bool crc16ClmulDetect() noexcept
+        {
+#if defined(__linux__)
+            return (getauxval(AT_HWCAP) & HWCAP_PMULL) != 0;
+#elif defined(__APPLE__)
+            return true;
+#else
+            return false;
+#endif
+        }
+
+#else
+
+        static inline uint16_t crc16ClmulImpl(const uint8_t *data, size_t size, uint16_t crc) noexcept
+        {
+            return crc16Table(data, size, crc);
+        }
+
+        static inline bool crc16ClmulDetect() noexcept
+        {
+            return false;
+        }
+
+#endif
+
+        uint16_t crc16Clmul(const uint8_t *data, size_t size, uint16_t crc) noexcept
+        {
+            //below 4 blocks tables are faster
+            if (!data || size < CRC16_CLMUL_BLOCK * CRC16_CLMUL_BLOCKS)
+            {
+                return crc16Table(data, size, crc);
+            }
+            return crc16ClmulImpl(data, size, crc);
+        }
+
+        bool crc16ClmulSupported() noexcept
+        {
+            static const bool ret = crc16ClmulDetect();
+            return ret;
+        }
+
+        uint16_t crc16(const uint8_t *data, size_t size, uint16_t crc) noexcept
+        {
+            static const auto function = crc16ClmulSupported() ? crc16Clmul : crc16Table;
+            return function(data, size, crc);
+        }
+
+#if defined(__x86_64__)
+
+        HGARDENPI_PROTOCOL_CRC32C
+        static uint32_t crc32cHardwareImpl(const uint8_t *data, size_t size, uint32_t crc) noexcept
+        {
+            uint64_t ret = ~crc;
+            for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), data += sizeof(uint64_t))
+            {
+                uint64_t word;
+                memcpy(&word, data, sizeof(uint64_t));
+                ret = _mm_crc32_u64(ret, word);
+            }
+            auto tail = static_cast<uint32_t>(ret);
+            for (; size > 0; size--, data++)
+            {
+                tail = _mm_crc32_u8(tail, *data);
+            }
+            return ~tail;
+        }
+
+        static inline bool crc32cHardwareDetect() noexcept
+        {
+            return __builtin_cpu_supports("sse4.2");
+        }
+
+#elif defined(__aarch64__)
+
+        HGARDENPI_PROTOCOL_CRC32C
+        static uint32_t crc32cHardwareImpl(const uint8_t *data, size_t size, uint32_t crc) noexcept
+        {
+            crc = ~crc;
+            for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), data += sizeof(uint64_t))
+            {
+                uint64_t word;
+                memcpy(&word, data, sizeof(uint64_t));
+                crc = __crc32cd(crc, word);
+            }
+            for (; size > 0; size--, data++)
+            {
+                crc = __crc32cb(crc, *data);
+            }
+            return ~crc;
+        }
+
+        static bool crc32cHardwareDetect() noexcept
+        {
+#if defined(__linux__)
+            return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#elif defined(__APPLE__)
+            return true;
+#else
+            return false;
+#endif
+        }
+
+#else
+
+        static inline uint32_t crc32cHardwareImpl(const uint8_t *data, size_t size, uint32_t crc) noexcept
+        {
+            return crc32cTable(data, size, crc);
+        }
+
+        static inline bool crc32cHardwareDetect() noexcept
+        {
+            return false;
+        }
+
+#endif
+
+        bool crc32cHardwareSupported() noexcept
+        {
+            static const bool ret = crc32cHardwareDetect();
+            return ret;
+        }
+
+        uint32_t crc32cHardware(const uint8_t *data, size_t size, uint32_t crc) noexcept
+        {
+            if (!data || !crc32cHardwareSupported())
+            {
+                return crc32cTable(data, size, crc);
+            }
+            return crc32cHardwareImpl(data, size, crc);
+        }
+
+        uint32_t crc32c(const uint8_t *data, size_t size, uint32_t crc) noexcept
+        {
+            static const auto function = crc32cHardwareSupported() ? crc32cHardware : crc32cTable;
+            return function(data, size, crc);
+        }
+
+    }
+}
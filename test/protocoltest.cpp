@@ -28,9 +28,17 @@
 #include <gtest/gtest.h>
 
 #include <string>
+#include <memory_resource>
+#include <new>
+#include <cstdlib>
 using namespace std;
 
 #include <hgardenpi-protocol/protocol.hpp>
+#include <hgardenpi-protocol/streamdecoder.hpp>
+#include <hgardenpi-protocol/reassembler.hpp>
+#include <hgardenpi-protocol/bulktransfer.hpp>
+#include <hgardenpi-protocol/transport.hpp>
+#include <hgardenpi-protocol/pool.hpp>
 #include <hgardenpi-protocol/packages/aggregation.hpp>
 #include <hgardenpi-protocol/packages/data.hpp>
 #include <hgardenpi-protocol/packages/finish.hpp>
@@ -39,8 +47,137 @@ using namespace std;
 #include <hgardenpi-protocol/packages/error.hpp>
 #include <hgardenpi-protocol/utilities/stringutils.hpp>
 #include <hgardenpi-protocol/utilities/numberutils.hpp>
+#include <hgardenpi-protocol/utilities/crcutils.hpp>
+#include <hgardenpi-protocol/3thparts/libcrc/checksum.h>
 using namespace hgardenpi::protocol;
 
+//count heap allocations to check the allocation free paths, every replaceable variant is replaced so
+//allocation and deallocation always pair on malloc() and free()
+static size_t allocations = 0;
+
+static void *countedAllocate(size_t size, size_t alignment) noexcept
+{
+    allocations++;
+    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+        return malloc(size ? size : 1);
+    }
+    void *ptr = nullptr;
+    return posix_memalign(&ptr, alignment, size ? size : 1) == 0 ? ptr : nullptr;
+}
+
+//free() is called through a volatile pointer, otherwise once operators are inlined the compiler pairs
+//malloc() with operator delete or operator new with free() and warns of mismatched deallocation
+static void (*volatile countedRelease)(void *) noexcept = free;
+
+void *operator new(size_t size)
+{
+    if (auto ptr = countedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__))
+    {
+        return ptr;
+    }
+    throw bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, align_val_t alignment)
+{
+    if (auto ptr = countedAllocate(size, static_cast<size_t>(alignment)))
+    {
+        return ptr;
+    }
+    throw bad_alloc();
+}
+
+void *operator new[](size_t size, align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void *operator new(size_t size, const nothrow_t &) noexcept
+{
+    return countedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new[](size_t size, const nothrow_t &) noexcept
+{
+    return countedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new(size_t size, align_val_t alignment, const nothrow_t &) noexcept
+{
+    return countedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void *operator new[](size_t size, align_val_t alignment, const nothrow_t &) noexcept
+{
+    return countedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *ptr) noexcept
+{
+    countedRelease(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    countedRelease(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    countedRelease(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    countedRelease(ptr);
+}
+
+void operator delete(void *ptr, align_val_t) noexcept
+{
+    countedRelease(ptr);
+}
+
+void operator delete[](void *ptr, align_val_t) noexcept
+{
+    countedRelease(ptr);
+}
+
+void operator delete(void *ptr, size_t, align_val_t) noexcept
+{
+    countedRelease(ptr);
+}
+
+void operator delete[](void *ptr, size_t, align_val_t) noexcept
+{
+    countedRelease(ptr);
+}
+
+void operator delete(void *ptr, const nothrow_t &) noexcept
+{
+    countedRelease(ptr);
+}
+
+void operator delete[](void *ptr, const nothrow_t &) noexcept
+{
+    countedRelease(ptr);
+}
+
+void operator delete(void *ptr, align_val_t, const nothrow_t &) noexcept
+{
+    countedRelease(ptr);
+}
+
+void operator delete[](void *ptr, align_val_t, const nothrow_t &) noexcept
+{
+    countedRelease(ptr);
+}
+
 
 TEST(ProtocolTest, encodeAGG)
 {
@@ -280,6 +417,496 @@ TEST(ProtocolTest, endCommunication)
     delete err;
 }
 
+TEST(ProtocolTest, encodeInto)
+{
+    Station sta;
+    sta.setName("Name");
+    sta.setDescription("Description");
+    sta.relayNumber = 1;
+    sta.wateringTime = 10;
+    sta.wateringTimeLeft = 2;
+    sta.weight = 30;
+
+    Aggregation agg;
+    agg.id = 23;
+    agg.setDescription("desc");
+    agg.setStart("start");
+    agg.setEnd("end");
+    agg.weight = 20;
+
+    Data dat;
+    dat.setPayload(generateRandomString(HEAD_MAX_PAYLOAD_SIZE * HEAD_MAX_CHUNK));
+
+    uint8_t out[HEAD_MAX_FRAMES * HEAD_MAX_FRAME_SIZE];
+
+    //frames must be the same of encode()
+    for (Package *package : initializer_list<Package *>{&sta, &agg, &dat})
+    {
+        auto enc = encode(package, ACK);
+        auto frames = encodeInto(*package, ACK, out, sizeof(out));
+
+        ASSERT_EQ(frames.count, enc.size());
+        EXPECT_EQ(frames.size, getEncodedSize(*package));
+        for (uint8_t i = 0; i < frames.count; i++)
+        {
+            ASSERT_EQ(frames.getFrameSize(i), enc[i].second);
+            EXPECT_EQ(memcmp(out + frames.offsets[i], enc[i].first.get(), enc[i].second), 0);
+        }
+    }
+
+    //16 full chunks, the last empty one and FIN
+    auto frames = encodeInto(dat, out, sizeof(out));
+    EXPECT_EQ(frames.count, HEAD_MAX_FRAMES);
+
+    Heads heads;
+    for (uint8_t i = 0; i < frames.count; i++)
+    {
+        heads.push_back(decode(out + frames.offsets[i]));
+    }
+    auto &&[flags, pkg] = composeDecodedChunks(heads);
+    EXPECT_EQ(flags, DAT);
+    auto ptr = std::dynamic_pointer_cast<Data>(pkg);
+    ASSERT_TRUE(ptr);
+    EXPECT_TRUE(ptr->getPayload() == dat.getPayload());
+
+    EXPECT_THROW(encodeInto(sta, out, getEncodedSize(sta) - 1), runtime_error);
+
+    //steady state without allocations
+    size_t before = allocations;
+    for (int i = 0; i < 1000; i++)
+    {
+        encodeInto(sta, ACK, out, sizeof(out));
+        encodeInto(agg, ACK, out, sizeof(out));
+        encodeInto(dat, ACK, out, sizeof(out));
+    }
+    EXPECT_EQ(allocations, before);
+}
+
+TEST(ProtocolTest, encodeMessage)
+{
+    Data data;
+    data.setPayload(generateRandomString(HEAD_MAX_PAYLOAD_SIZE * HEAD_MAX_CHUNK));
+    auto enc = encode(&data, ACK);
+
+    //one allocation for all frames
+    size_t before = allocations;
+    auto message = encodeMessage(data, ACK);
+    EXPECT_EQ(allocations - before, 1);
+    ASSERT_EQ(message.getCount(), enc.size());
+    EXPECT_EQ(message.getBytes().size, getEncodedSize(data));
+
+    uint8_t i = 0;
+    for (auto &&frame : message)
+    {
+        ASSERT_EQ(frame.size, enc[i].second);
+        EXPECT_EQ(memcmp(frame.data, enc[i].first.get(), frame.size), 0);
+        EXPECT_TRUE(tryView(frame.data, frame.size));
+        i++;
+    }
+    EXPECT_EQ(i, message.getCount());
+    EXPECT_EQ(message[1].data, message.getBytes().data + message.getFrames().offsets[1]);
+
+    //message can be moved
+    auto moved = move(message);
+    EXPECT_EQ(moved.getCount(), enc.size());
+    EXPECT_EQ(message.begin(), message.end());
+
+    auto fin = encodeMessage(Finish());
+    ASSERT_EQ(fin.getCount(), 1);
+    EXPECT_EQ(fin[0].size, HEAD_HEADER_SIZE + HEAD_CRC_SIZE);
+
+    EXPECT_EQ(tryEncodeMessage(Finish(), NOT_SET).getError(), ErrorCode::OK);
+    Data tooBig;
+    tooBig.setPayload(string(HEAD_MAX_PAYLOAD_SIZE * (HEAD_MAX_CHUNK + 1), 'd'));
+    EXPECT_EQ(tryEncodeMessage(tooBig).getError(), ErrorCode::DATA_TOO_BIG);
+}
+
+TEST(ProtocolTest, streamEncoder)
+{
+    Data data;
+    data.setPayload(generateRandomString(HEAD_MAX_PAYLOAD_SIZE * HEAD_MAX_CHUNK));
+    Aggregation agg;
+    agg.setDescription(string(HEAD_MAX_PAYLOAD_SIZE, 'a'));
+    agg.setEnd("18:00");
+
+    static StreamEncoder encoder;
+    const Package *packages[] = {&data, &agg, &data};
+    Flags flags[] = {ACK, NOT_SET, NOT_SET};
+    for (uint8_t p = 0; p < 3; p++)
+    {
+        uint8_t out[HEAD_MAX_FRAMES * HEAD_MAX_FRAME_SIZE];
+        auto frames = encodeInto(*packages[p], flags[p], out, sizeof(out));
+
+        //frames are generated one by one, without allocation if there is no prefix
+        size_t before = allocations;
+        ASSERT_EQ(encoder.start(*packages[p], flags[p]), ErrorCode::OK);
+        ASSERT_EQ(encoder.getCount(), frames.count);
+        uint8_t i = 0;
+        for (auto frame = encoder.next(); !frame.empty(); frame = encoder.next())
+        {
+            ASSERT_LT(i, frames.count);
+            ASSERT_EQ(frame.size, frames.getFrameSize(i));
+            EXPECT_EQ(memcmp(frame.data, &out[frames.offsets[i]], frame.size), 0);
+            i++;
+        }
+        EXPECT_EQ(i, frames.count);
+        EXPECT_FALSE(encoder.hasNext());
+        if (packages[p] == &data)
+        {
+            EXPECT_EQ(allocations, before);
+        }
+    }
+
+    ASSERT_EQ(encoder.start(Finish()), ErrorCode::OK);
+    EXPECT_EQ(encoder.next().size, HEAD_HEADER_SIZE + HEAD_CRC_SIZE);
+    EXPECT_TRUE(encoder.next().empty());
+
+    Data tooBig;
+    tooBig.setPayload(string(HEAD_MAX_PAYLOAD_SIZE * (HEAD_MAX_CHUNK + 1), 'd'));
+    EXPECT_EQ(encoder.start(tooBig), ErrorCode::DATA_TOO_BIG);
+    EXPECT_FALSE(encoder.hasNext());
+}
+
+#ifdef HGARDENPI_PROTOCOL_SCATTER
+TEST(ProtocolTest, encodeScatter)
+{
+    Data data;
+    data.setPayload(generateRandomString(HEAD_MAX_PAYLOAD_SIZE * 3));
+    uint8_t out[HEAD_MAX_FRAMES * HEAD_MAX_FRAME_SIZE];
+    auto frames = encodeInto(data, ACK, out, sizeof(out));
+
+    static ScatterFrames scatter;
+    size_t before = allocations;
+    ASSERT_EQ(tryEncodeScatter(data, ACK, scatter), ErrorCode::OK);
+    EXPECT_EQ(allocations, before);
+    ASSERT_EQ(scatter.count, frames.count);
+    ASSERT_EQ(scatter.size, frames.size);
+
+    //segments gathered are the same frames of encodeInto()
+    for (uint8_t i = 0; i < scatter.count; i++)
+    {
+        vector<uint8_t> frame;
+        auto iov = scatter.getFrameIov(i);
+        for (int j = 0; j < scatter.getFrameIovcnt(i); j++)
+        {
+            auto base = static_cast<const uint8_t *>(iov[j].iov_base);
+            frame.insert(frame.end(), base, base + iov[j].iov_len);
+        }
+        ASSERT_EQ(frame.size(), frames.getFrameSize(i));
+        EXPECT_EQ(memcmp(frame.data(), &out[frames.offsets[i]], frame.size()), 0);
+    }
+
+    //payload is not copied, full chunks are header, payload and crc16
+    EXPECT_EQ(scatter.getFrameIovcnt(1), 3);
+    EXPECT_EQ(scatter.getFrameIov(1)[1].iov_base, data.payload + HEAD_MAX_PAYLOAD_SIZE - sizeof(data.length));
+    EXPECT_EQ(scatter.getFrameIovcnt(scatter.count - 1), 2);
+
+    //packages without tail are serialized in prefix
+    Synchro syn;
+    syn.setSerial("serial");
+    ASSERT_EQ(tryEncodeScatter(syn, NOT_SET, scatter), ErrorCode::OK);
+    frames = encodeInto(syn, out, sizeof(out));
+    ASSERT_EQ(scatter.count, 1);
+    ASSERT_EQ(scatter.iovcnt, 3);
+    EXPECT_EQ(memcmp(scatter.iov[1].iov_base, &out[HEAD_HEADER_SIZE], scatter.iov[1].iov_len), 0);
+
+    EXPECT_EQ(tryEncodeScatter(Finish(), NOT_SET, scatter), ErrorCode::OK);
+    EXPECT_EQ(scatter.iovcnt, 2);
+}
+#endif
+
+TEST(ProtocolTest, tryDecode)
+{
+    auto data = new Data;
+    data->setPayload(string(HEAD_MAX_PAYLOAD_SIZE * 2, 'd'));
+    auto enc = encode(data);
+
+    auto &&tryEnc = tryEncode(data);
+    ASSERT_TRUE(tryEnc);
+    ASSERT_EQ(tryEnc->size(), enc.size());
+    for (size_t i = 0; i < enc.size(); i++)
+    {
+        ASSERT_EQ(tryEnc.getValue()[i].second, enc[i].second);
+        EXPECT_EQ(memcmp(tryEnc.getValue()[i].first.get(), enc[i].first.get(), enc[i].second), 0);
+    }
+    delete data;
+
+    Heads heads;
+    for (auto &&it : enc)
+    {
+        auto &&head = tryDecode(it.first.get(), it.second);
+        ASSERT_TRUE(head);
+        heads.push_back(head.getValue());
+    }
+
+    auto &&composed = tryComposeDecodedChunks(heads);
+    ASSERT_TRUE(composed);
+    EXPECT_EQ(composed->first, DAT);
+    EXPECT_EQ(reinterpret_cast<Data *>(composed->second.get())->getPayload(), string(HEAD_MAX_PAYLOAD_SIZE * 2, 'd'));
+
+    //errors returned without exceptions
+    EXPECT_EQ(tryComposeDecodedChunks({}).getError(), ErrorCode::NO_HEAD);
+    EXPECT_EQ(tryComposeDecodedChunks({heads[0]}).getError(), ErrorCode::PACKAGE_INCOMPLETE);
+    EXPECT_EQ(tryEncode(nullptr).getError(), ErrorCode::NULL_PACKAGE);
+    EXPECT_EQ(tryDecode(enc[0].first.get(), HEAD_HEADER_SIZE).getError(), ErrorCode::BUFFER_TOO_SHORT);
+    EXPECT_EQ(tryView(nullptr, 0).getError(), ErrorCode::BUFFER_TOO_SHORT);
+
+    uint8_t out[HEAD_MAX_FRAME_SIZE];
+    Finish fin;
+    EXPECT_EQ(tryEncodeInto(fin, NOT_SET, out, HEAD_HEADER_SIZE).getError(), ErrorCode::BUFFER_TOO_SMALL);
+
+    enc[0].first[HEAD_HEADER_SIZE] ^= 0xFF;
+    EXPECT_EQ(tryDecode(enc[0].first.get(), enc[0].second).getError(), ErrorCode::CRC_NOT_MATCH);
+    enc[0].first[0] |= 0x80;
+    EXPECT_EQ(tryView(enc[0].first.get(), enc[0].second).getError(), ErrorCode::WRONG_VERSION);
+
+    //throwing API keep messages
+    try
+    {
+        decode(enc[0]);
+        FAIL();
+    }
+    catch (const runtime_error &e)
+    {
+        EXPECT_STREQ(e.what(), getErrorMessage(ErrorCode::WRONG_VERSION));
+    }
+}
+
+TEST(ProtocolTest, streamDecoder)
+{
+    auto err = new Error;
+    err->setMsg(generateRandomString(600));
+    auto encErr = encode(err, ACK);
+    delete err;
+
+    auto syn = new Synchro;
+    syn->setSerial("serial123456789");
+    auto encSyn = encode(syn, ACK);
+    delete syn;
+
+    //stream with garbage, frames run together and a corrupted copy of syn
+    vector<uint8_t> stream = {0xFF, 0x80, 0x00};
+    vector<Buffer> expected;
+    for (auto &&buffer : encErr)
+    {
+        stream.insert(stream.end(), buffer.first.get(), buffer.first.get() + buffer.second);
+        expected.push_back(buffer);
+    }
+    stream.insert(stream.end(), encSyn[0].first.get(), encSyn[0].first.get() + encSyn[0].second);
+    stream.back() ^= 0xFF;
+    stream.push_back(0x7F);
+    stream.insert(stream.end(), encSyn[0].first.get(), encSyn[0].first.get() + encSyn[0].second);
+    expected.push_back(encSyn[0]);
+    //a false head inside corrupted bytes can hold last frames until next bytes arrive
+    for (auto &&buffer : encErr)
+    {
+        stream.insert(stream.end(), buffer.first.get(), buffer.first.get() + buffer.second);
+        expected.push_back(buffer);
+    }
+
+    for (size_t slice : {static_cast<size_t>(1), static_cast<size_t>(7), static_cast<size_t>(100), stream.size()})
+    {
+        StreamDecoder decoder;
+        vector<vector<uint8_t>> frames;
+        for (size_t i = 0; i < stream.size(); i += slice)
+        {
+            decoder.feed(stream.data() + i, min(slice, stream.size() - i), [&](const uint8_t *frame, uint16_t size)
+            {
+                frames.emplace_back(frame, frame + size);
+            });
+            EXPECT_LE(decoder.getBuffered(), HEAD_MAX_FRAME_SIZE);
+        }
+
+        ASSERT_EQ(frames.size(), expected.size());
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            ASSERT_EQ(frames[i].size(), expected[i].second);
+            EXPECT_EQ(memcmp(frames[i].data(), expected[i].first.get(), expected[i].second), 0);
+            EXPECT_NO_THROW(decode(frames[i].data(), frames[i].size()));
+        }
+        EXPECT_EQ(decoder.getStatistics().frames, expected.size());
+        EXPECT_GE(decoder.getStatistics().crcErrors, 1);
+        EXPECT_EQ(decoder.getBuffered(), 0);
+    }
+
+    EXPECT_THROW(decode(encSyn[0].first.get(), encSyn[0].second - 1), runtime_error);
+
+    //frames of a link agreed on CRC32, a corrupted copy is discarded by its checksum, false heads inside it are
+    //resolved by the copies after it
+    StreamEncoder crc32Encoder(ChecksumType::CRC32);
+    Synchro crc32Syn;
+    crc32Syn.setSerial("serial123456789");
+    ASSERT_EQ(crc32Encoder.start(crc32Syn, ACK), ErrorCode::OK);
+    auto crc32Frame = crc32Encoder.next();
+    ASSERT_EQ(crc32Frame.size, HEAD_HEADER_SIZE + crc32Frame[2] + sizeof(uint32_t));
+    vector<uint8_t> crc32Stream(crc32Frame.begin(), crc32Frame.end());
+    crc32Stream[HEAD_HEADER_SIZE] ^= 0x01;
+    for (size_t copies = 0; copies * crc32Frame.size <= HEAD_MAX_FRAME_SIZE + HEAD_MAX_CHECKSUM_SIZE; copies++)
+    {
+        crc32Stream.insert(crc32Stream.end(), crc32Frame.begin(), crc32Frame.end());
+    }
+    StreamDecoder crc32Decoder(ChecksumType::CRC32);
+    EXPECT_EQ(crc32Decoder.getChecksum(), ChecksumType::CRC32);
+    auto crc32Frames = crc32Decoder.feed(crc32Stream.data(), crc32Stream.size(), [&crc32Frame](const uint8_t *frame, uint16_t size)
+    {
+        ASSERT_EQ(size, crc32Frame.size);
+        EXPECT_EQ(memcmp(frame, crc32Frame.data, size), 0);
+        EXPECT_TRUE(tryView(frame, size, ChecksumType::CRC32));
+    });
+    EXPECT_EQ(crc32Frames, crc32Stream.size() / crc32Frame.size - 1);
+    EXPECT_GE(crc32Decoder.getStatistics().crcErrors, 1);
+    EXPECT_EQ(crc32Decoder.getBuffered(), 0);
+}
+
+TEST(ProtocolTest, view)
+{
+    Aggregation agg;
+    agg.id = 23;
+    agg.setDescription("desc");
+    agg.setStart("start");
+    agg.setEnd("end");
+    agg.weight = 20;
+
+    uint8_t out[HEAD_MAX_FRAMES * HEAD_MAX_FRAME_SIZE];
+    auto frames = encodeInto(agg, ACK, out, sizeof(out));
+
+    size_t before = allocations;
+    auto head = view(out, frames.size);
+    EXPECT_EQ(allocations, before);
+
+    EXPECT_EQ(head.flags, AGG | ACK);
+    EXPECT_EQ(head.length, agg.getSerializedSize());
+    EXPECT_EQ(head.payload.data, out + HEAD_HEADER_SIZE);
+
+    auto decoded = decode(out, frames.size);
+    EXPECT_EQ(head.crc16, decoded->crc16);
+
+    if (auto *ptr = dynamic_cast<Aggregation *>(Head::deserialize(head)))
+    {
+        EXPECT_TRUE(ptr->getDescription() == string("desc"));
+        EXPECT_TRUE(ptr->getStart() == string("start"));
+        EXPECT_TRUE(ptr->getEnd() == string("end"));
+        EXPECT_EQ(ptr->weight, 20);
+        delete ptr;
+    }
+
+    auto syn = new Synchro;
+    syn->setSerial("serial123456789");
+    auto enc = encode(syn, ACK);
+    delete syn;
+
+    auto ptr = Synchro::deserialize(view(enc[0]));
+    ASSERT_TRUE(ptr);
+    EXPECT_TRUE(ptr->getSerial() == "serial123456789");
+    delete ptr;
+
+    out[HEAD_HEADER_SIZE] ^= 0xFF;
+    EXPECT_THROW(view(out, frames.size), runtime_error);
+    EXPECT_THROW(view(out, HEAD_HEADER_SIZE), runtime_error);
+}
+
+TEST(ProtocolTest, peekAndViewBatch)
+{
+    Data data;
+    data.setPayload(string(HEAD_MAX_PAYLOAD_SIZE * 2, 'd'));
+    uint8_t out[HEAD_MAX_FRAMES * HEAD_MAX_FRAME_SIZE];
+    auto frames = encodeInto(data, out, sizeof(out));
+    ASSERT_EQ(frames.count, 4);
+
+    //header fields without crc16 check
+    size_t before = allocations;
+    auto &&peek = tryPeek(out, frames.size);
+    ASSERT_TRUE(peek);
+    EXPECT_EQ(peek->flags, DAT | CKN);
+    EXPECT_EQ(peek->length, HEAD_MAX_PAYLOAD_SIZE);
+    EXPECT_EQ(peek->crc16, tryView(out, frames.size)->crc16);
+    out[HEAD_HEADER_SIZE] ^= 0xFF;
+    EXPECT_TRUE(tryPeek(out, frames.size));
+    EXPECT_EQ(tryView(out, frames.size).getError(), ErrorCode::CRC_NOT_MATCH);
+    out[HEAD_HEADER_SIZE] ^= 0xFF;
+    EXPECT_EQ(tryPeek(out, HEAD_HEADER_SIZE + HEAD_CRC_SIZE).getError(), ErrorCode::BUFFER_TOO_SHORT);
+
+    //all frames of receive buffer, last frame not complete is left
+    HeadView views[HEAD_MAX_FRAMES];
+    size_t count = 0;
+    size_t consumed = 0;
+    ASSERT_EQ(tryViewBatch(out, frames.size - 1, views, HEAD_MAX_FRAMES, count, consumed), ErrorCode::OK);
+    EXPECT_EQ(count, frames.count - 1);
+    EXPECT_EQ(consumed, frames.offsets[frames.count - 1]);
+    ASSERT_EQ(tryViewBatch(out, frames.size, views, HEAD_MAX_FRAMES, count, consumed), ErrorCode::OK);
+    ASSERT_EQ(count, frames.count);
+    EXPECT_EQ(consumed, frames.size);
+    for (uint8_t i = 0; i < frames.count; i++)
+    {
+        EXPECT_EQ(views[i].payload.data, &out[frames.offsets[i] + HEAD_HEADER_SIZE]);
+    }
+    EXPECT_EQ((views[frames.count - 1].flags & HEAD_PACKAGE_MASK), FIN);
+    EXPECT_EQ(allocations, before);
+
+    //stop at capacity and at first frame not valid
+    ASSERT_EQ(tryViewBatch(out, frames.size, views, 2, count, consumed), ErrorCode::OK);
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(consumed, frames.offsets[2]);
+    out[frames.offsets[1] + HEAD_HEADER_SIZE] ^= 0xFF;
+    EXPECT_EQ(tryViewBatch(out, frames.size, views, HEAD_MAX_FRAMES, count, consumed), ErrorCode::CRC_NOT_MATCH);
+    EXPECT_EQ(count, 1);
+    EXPECT_EQ(consumed, frames.offsets[1]);
+
+    //more package types or nothing are not valid, only ACK is an acknowledge
+    out[0] = SYN | STA;
+    EXPECT_EQ(tryPeek(out, frames.size).getError(), ErrorCode::FLAGS_OUT_OF_RANGE);
+    out[0] = CKN;
+    EXPECT_EQ(tryPeek(out, frames.size).getError(), ErrorCode::FLAGS_OUT_OF_RANGE);
+    out[0] = ACK;
+    EXPECT_TRUE(tryPeek(out, frames.size));
+
+    //stride of frames follows size of checksum
+    frames = *tryEncodeInto<Crc32Checksum>(data, NOT_SET, out, sizeof(out));
+    ASSERT_EQ(tryViewBatch<Crc32Checksum>(out, frames.size, views, HEAD_MAX_FRAMES, count, consumed), ErrorCode::OK);
+    EXPECT_EQ(count, frames.count);
+    EXPECT_EQ(consumed, frames.size);
+    EXPECT_EQ(tryPeek<Crc32Checksum>(out + frames.offsets[1], frames.size - frames.offsets[1])->length, HEAD_MAX_PAYLOAD_SIZE);
+    frames = *tryEncodeInto<NoChecksum>(data, NOT_SET, out, sizeof(out));
+    ASSERT_EQ(tryViewBatch(out, frames.size, views, HEAD_MAX_FRAMES, count, consumed, ChecksumType::NONE), ErrorCode::OK);
+    EXPECT_EQ(count, frames.count);
+    EXPECT_EQ(consumed, frames.size);
+    EXPECT_EQ((views[frames.count - 1].flags & HEAD_PACKAGE_MASK), FIN);
+}
+
+TEST(ProtocolTest, flagDispatch)
+{
+    Aggregation agg;
+    Data data;
+    Error err;
+    Finish fin;
+    Station sta;
+    Synchro syn;
+    const Package *packages[] = {&agg, &data, &err, &fin, &sta, &syn};
+    const Flags flags[] = {AGG, DAT, ERR, FIN, STA, SYN};
+
+    uint8_t out[HEAD_MAX_FRAME_SIZE];
+    for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); i++)
+    {
+        EXPECT_EQ(packages[i]->getFlag(), flags[i]);
+        auto &&frames = encodeInto(*packages[i], ACK, out, sizeof(out));
+        EXPECT_EQ(out[0], flags[i] | ACK);
+        EXPECT_EQ(view(out, frames.size).flags, flags[i] | ACK);
+    }
+
+    uint8_t payload[] = {1, 0, 'e'};
+    HeadView head{.flags = static_cast<uint8_t>(ERR | CKN), .length = sizeof(payload), .payload = {payload, sizeof(payload)}};
+    auto ptr = head.deserialize();
+    ASSERT_TRUE(ptr);
+    EXPECT_EQ(ptr->getFlag(), ERR);
+    delete ptr;
+
+    //more packages in the same frame are not valid
+    head.flags = AGG | SYN;
+    EXPECT_EQ(head.deserialize(), nullptr);
+    head.flags = NOT_SET;
+    EXPECT_EQ(head.deserialize(), nullptr);
+}
+
 TEST(ProtocolTest, composeDecodedChunks)
 {
     auto sta = new Station;
@@ -365,6 +992,1111 @@ TEST(ProtocolTest, composeDecodedChunks)
 
 }
 
+TEST(ProtocolTest, composeDecodedChunksLinear)
+{
+    //biggest message, binary with zeros
+    string payload(HEAD_MAX_CHUNK * HEAD_MAX_PAYLOAD_SIZE + HEAD_MAX_PAYLOAD_SIZE - 3, '\0');
+    for (size_t i = 0; i < payload.size(); i++)
+    {
+        payload[i] = static_cast<char>(i % 7);
+    }
+    Data data;
+    data.setPayload(payload);
+    auto enc = encode(&data);
+    ASSERT_EQ(enc.size(), HEAD_MAX_FRAMES);
+
+    Heads heads;
+    for (auto &&it : enc)
+    {
+        heads.push_back(decode(it));
+    }
+
+    //warm up pools
+    composeDecodedChunks(heads);
+
+    size_t before = allocations;
+    auto &&[flags, pkg] = composeDecodedChunks(heads);
+    //only payload, package with its control block is pooled
+    EXPECT_EQ(allocations - before, 1);
+
+    ASSERT_EQ(flags, DAT);
+    auto ptr = static_cast<Data *>(pkg.get());
+    ASSERT_EQ(ptr->length, payload.size());
+    EXPECT_EQ(memcmp(ptr->payload, payload.data(), payload.size()), 0);
+
+    //lost chunk
+    Heads lost = heads;
+    lost.erase(lost.begin() + 3);
+    EXPECT_EQ(tryComposeDecodedChunks(lost).getError(), ErrorCode::PACKAGE_INCOMPLETE);
+
+    //chunk of other package
+    Error err;
+    err.setMsg(string(HEAD_MAX_PAYLOAD_SIZE * 2, 'e'));
+    auto encErr = encode(&err);
+    Heads mixed = heads;
+    mixed[1] = decode(encErr[1]);
+    EXPECT_EQ(tryComposeDecodedChunks(mixed).getError(), ErrorCode::INCOMPATIBLE_CHUNK);
+}
+
+TEST(ProtocolTest, reassembler)
+{
+    //three devices send a DAT with the same id interleaved
+    const size_t lengths[] = {600, 300, 1000};
+    Buffers messages[3];
+    string payloads[3];
+    for (size_t i = 0; i < 3; i++)
+    {
+        payloads[i] = generateRandomString(lengths[i]);
+        Data data;
+        data.setPayload(payloads[i]);
+        messages[i] = encode(&data);
+        updateIdToBufferEncoded(messages[i], 1);
+    }
+
+    Reassembler reassembler(4, 100);
+    size_t completed = 0;
+    for (size_t frame = 0; frame < messages[2].size(); frame++)
+    {
+        for (uint32_t source = 0; source < 3; source++)
+        {
+            if (frame >= messages[source].size())
+            {
+                continue;
+            }
+            auto &&ret = reassembler.push(source, view(messages[source][frame]));
+            ASSERT_TRUE(ret);
+            if (ret->second)
+            {
+                ASSERT_EQ(ret->first, DAT);
+                EXPECT_EQ(static_cast<Data *>(ret->second.get())->getPayload(), payloads[source]);
+                EXPECT_EQ(frame, messages[source].size() - 1);
+                completed++;
+            }
+        }
+    }
+    EXPECT_EQ(completed, 3);
+    EXPECT_EQ(reassembler.getPending(), 0);
+
+    //out of order and duplicated chunks placed by index
+    auto &&msg = messages[2];
+    const uint8_t order[] = {4, 0, 2, 0, 1, 1, 3};
+    for (auto &&chunk : order)
+    {
+        auto &&ret = reassembler.push(7, view(msg[chunk]), chunk);
+        ASSERT_TRUE(ret);
+        if (chunk == 3 && reassembler.getPending() == 0)
+        {
+            ASSERT_TRUE(ret->second);
+            EXPECT_EQ(static_cast<Data *>(ret->second.get())->getPayload(), payloads[2]);
+        }
+        else
+        {
+            EXPECT_FALSE(ret->second);
+        }
+    }
+    EXPECT_EQ(reassembler.getStatistics().duplicates, 2);
+    EXPECT_EQ(reassembler.getStatistics().packages, 4);
+
+    //no allocation while chunks are buffered
+    size_t before = allocations;
+    EXPECT_TRUE(reassembler.push(8, view(msg[0])));
+    EXPECT_EQ(allocations, before);
+
+    //memory budget
+    EXPECT_TRUE(reassembler.push(9, view(msg[0])));
+    EXPECT_TRUE(reassembler.push(10, view(msg[0])));
+    EXPECT_TRUE(reassembler.push(11, view(msg[0])));
+    EXPECT_EQ(reassembler.push(12, view(msg[0])).getError(), ErrorCode::NO_MEMORY);
+    EXPECT_EQ(reassembler.getPending(), 4);
+
+    //stale packages evicted by timer wheel
+    EXPECT_EQ(reassembler.advance(50), 0);
+    EXPECT_TRUE(reassembler.push(11, view(msg[1])));
+    EXPECT_EQ(reassembler.advance(100), 3);
+    EXPECT_EQ(reassembler.getPending(), 1);
+    EXPECT_EQ(reassembler.advance(150), 1);
+    EXPECT_EQ(reassembler.getPending(), 0);
+    EXPECT_EQ(reassembler.getStatistics().evicted, 4);
+
+    //package in one frame
+    Synchro syn;
+    syn.setSerial("serial");
+    auto &&ret = reassembler.push(0, view(encode(&syn)[0]));
+    ASSERT_TRUE(ret);
+    EXPECT_EQ(ret->first, SYN);
+}
+
+TEST(ProtocolTest, bulkTransfer)
+{
+    //bigger than HEAD_MAX_CHUNK chunks
+    vector<uint8_t> data(HEAD_MAX_PAYLOAD_SIZE * HEAD_MAX_CHUNK * 30);
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        data[i] = static_cast<uint8_t>(i * 7);
+    }
+    vector<uint8_t> received;
+
+    BulkSender sender(7, 8, 10);
+    BulkReceiver receiver(7, 8);
+    ASSERT_EQ(sender.start(data.data(), data.size()), ErrorCode::OK);
+
+    //one frame every 13 and one acknowledge every 5 are lost, poll() send them again after timeout
+    size_t frames = 0;
+    size_t acks = 0;
+    for (uint32_t now = 0; !sender.isComplete() && now < 100000; now++)
+    {
+        for (auto frame = sender.poll(now); !frame.empty(); frame = sender.poll(now))
+        {
+            if (++frames % 13 == 0)
+            {
+                continue;
+            }
+
+            auto head = tryView(frame.data, frame.size);
+            ASSERT_TRUE(head);
+            EXPECT_EQ(head->id, 7);
+            EXPECT_EQ(head->flags, BLK);
+            auto &&bytes = receiver.receive(*head);
+            ASSERT_TRUE(bytes);
+            received.insert(received.end(), bytes->begin(), bytes->end());
+
+            if (receiver.hasAcknowledge())
+            {
+                auto ack = receiver.acknowledge();
+                if (++acks % 5 == 0)
+                {
+                    continue;
+                }
+                auto ackHead = tryView(ack.data, ack.size);
+                ASSERT_TRUE(ackHead);
+                EXPECT_EQ(ackHead->flags, BLK | ACK);
+                EXPECT_EQ(sender.acknowledge(*ackHead), ErrorCode::OK);
+            }
+        }
+    }
+    EXPECT_TRUE(sender.isComplete());
+    EXPECT_TRUE(receiver.isComplete());
+    EXPECT_EQ(sender.getAcknowledged(), data.size());
+    EXPECT_TRUE(received == data);
+
+    //resume from offset received before disconnection
+    uint32_t half = data.size() / 2;
+    BulkReceiver resumed(8, BULK_DEFAULT_WINDOW, half);
+    BulkSender resumedSender(8);
+    ASSERT_EQ(resumedSender.start(data.data(), data.size(), resumed.getOffset()), ErrorCode::OK);
+    received.resize(half);
+    while (!resumedSender.isComplete())
+    {
+        auto frame = resumedSender.next();
+        if (frame.empty())
+        {
+            auto ack = resumed.acknowledge();
+            ASSERT_EQ(resumedSender.acknowledge(*tryView(ack.data, ack.size)), ErrorCode::OK);
+            continue;
+        }
+        auto &&bytes = resumed.receive(*tryView(frame.data, frame.size));
+        ASSERT_TRUE(bytes);
+        received.insert(received.end(), bytes->begin(), bytes->end());
+    }
+    EXPECT_TRUE(received == data);
+
+    //frames of other sessions are refused
+    auto frame = BulkSender(9).next();
+    EXPECT_TRUE(frame.empty());
+    BulkSender other(9);
+    ASSERT_EQ(other.start(data.data(), data.size()), ErrorCode::OK);
+    frame = other.next();
+    EXPECT_EQ(receiver.receive(*tryView(frame.data, frame.size)).getError(), ErrorCode::INCOMPATIBLE_CHUNK);
+    EXPECT_EQ(other.start(data.data(), 10, 11), ErrorCode::PAYLOAD_MALFORMED);
+
+    //offsets are little endian on every host
+    BulkSender order(3);
+    ASSERT_EQ(order.start(data.data(), data.size(), 0x010203), ErrorCode::OK);
+    frame = order.next();
+    ASSERT_FALSE(frame.empty());
+    EXPECT_EQ(frame[HEAD_HEADER_SIZE], 0x03);
+    EXPECT_EQ(frame[HEAD_HEADER_SIZE + 1], 0x02);
+    EXPECT_EQ(frame[HEAD_HEADER_SIZE + 2], 0x01);
+    EXPECT_EQ(frame[HEAD_HEADER_SIZE + 3], 0x00);
+
+    //bulk frames are not chunks of a package on a shared link
+    Reassembler reassembler(4, 100);
+    auto &&pushed = reassembler.push(1, *tryView(frame.data, frame.size));
+    ASSERT_TRUE(pushed);
+    EXPECT_EQ(pushed->second, nullptr);
+    EXPECT_EQ(reassembler.getPending(), 0);
+    EXPECT_FALSE(tryComposeChunks(BLK, &tryView(frame.data, frame.size)->payload, 1)->second);
+
+    //session on a link without checksum, frames and acknowledges end after payload
+    BulkSender plain(5, BULK_DEFAULT_WINDOW, 1000, ChecksumType::NONE);
+    BulkReceiver plainReceiver(5, BULK_DEFAULT_WINDOW, 0, ChecksumType::NONE);
+    ASSERT_EQ(plain.start(data.data(), 1000), ErrorCode::OK);
+    received.clear();
+    while (!plain.isComplete())
+    {
+        frame = plain.next();
+        if (frame.empty())
+        {
+            auto ack = plainReceiver.acknowledge();
+            ASSERT_EQ(ack.size, HEAD_HEADER_SIZE + BULK_OFFSET_SIZE + 1);
+            ASSERT_EQ(plain.acknowledge(*tryView(ack.data, ack.size, ChecksumType::NONE)), ErrorCode::OK);
+            continue;
+        }
+        ASSERT_EQ(frame.size, HEAD_HEADER_SIZE + frame[2]);
+        auto &&bytes = plainReceiver.receive(*tryView(frame.data, frame.size, ChecksumType::NONE));
+        ASSERT_TRUE(bytes);
+        received.insert(received.end(), bytes->begin(), bytes->end());
+    }
+    EXPECT_TRUE(plainReceiver.isComplete());
+    EXPECT_TRUE(received == vector<uint8_t>(data.begin(), data.begin() + 1000));
+}
+
+TEST(ProtocolTest, transport)
+{
+    Transport sender(8, 20);
+    Transport receiver(8, 20);
+
+    //frame 2 is lost, the others are acknowledged
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        Data data;
+        data.setPayload(to_string(i));
+        ASSERT_EQ(sender.send(data), ErrorCode::OK);
+    }
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        auto frame = sender.poll(0);
+        ASSERT_FALSE(frame.empty());
+        if (i != 2)
+        {
+            ASSERT_EQ(receiver.receive(frame.data, frame.size, 0), ErrorCode::OK);
+        }
+    }
+    EXPECT_TRUE(sender.poll(0).empty());
+    for (auto ack = receiver.poll(1); !ack.empty(); ack = receiver.poll(1))
+    {
+        ASSERT_EQ(sender.receive(ack.data, ack.size, 2), ErrorCode::OK);
+    }
+    EXPECT_EQ(sender.getStatistics().acknowledged, 4);
+    EXPECT_FALSE(sender.isIdle());
+
+    //only packages in order are taken
+    auto &&first = receiver.pop();
+    ASSERT_TRUE(first);
+    EXPECT_EQ(first->first, DAT);
+    EXPECT_EQ(dynamic_pointer_cast<Data>(first->second)->getPayload(), "0");
+    ASSERT_TRUE(receiver.pop());
+    EXPECT_EQ(receiver.pop()->second, nullptr);
+
+    //only lost frame is sent again after timeout
+    EXPECT_TRUE(sender.poll(19).empty());
+    auto frame = sender.poll(20);
+    ASSERT_FALSE(frame.empty());
+    EXPECT_EQ(tryView(frame.data, frame.size)->id, 2);
+    EXPECT_TRUE(sender.poll(20).empty());
+    EXPECT_EQ(sender.getStatistics().retransmitted, 1);
+    ASSERT_EQ(receiver.receive(frame.data, frame.size, 21), ErrorCode::OK);
+    auto ack = receiver.poll(21);
+    ASSERT_EQ(sender.receive(ack.data, ack.size, 22), ErrorCode::OK);
+    EXPECT_TRUE(sender.isIdle());
+    for (uint8_t i = 2; i < 5; i++)
+    {
+        auto &&package = receiver.pop();
+        ASSERT_TRUE(package);
+        EXPECT_EQ(dynamic_pointer_cast<Data>(package->second)->getPayload(), to_string(i));
+    }
+
+    //lossy link with delay in both directions, chunked packages too
+    struct Link
+    {
+        vector<pair<uint32_t, vector<uint8_t>>> frames;
+        size_t written = 0;
+    };
+    Transport a(16, 1000);
+    Transport b(16, 1000);
+    Link ab;
+    Link ba;
+    const uint32_t delay = 3;
+    auto write = [](Link &link, BytesView frame, uint32_t now)
+    {
+        //one frame every 7 is lost
+        if (++link.written % 7 != 0)
+        {
+            link.frames.emplace_back(now + delay, vector<uint8_t>(frame.begin(), frame.end()));
+        }
+    };
+    auto read = [](Link &link, Transport &to, uint32_t now)
+    {
+        size_t i = 0;
+        for (; i < link.frames.size() && link.frames[i].first <= now; i++)
+        {
+            ASSERT_EQ(to.receive(link.frames[i].second.data(), link.frames[i].second.size(), now), ErrorCode::OK);
+        }
+        link.frames.erase(link.frames.begin(), link.frames.begin() + i);
+    };
+
+    vector<string> payloads;
+    for (size_t i = 0; i < 60; i++)
+    {
+        Data data;
+        payloads.push_back(generateRandomString(i % 4 == 0 ? HEAD_MAX_PAYLOAD_SIZE * 3 : 10));
+        data.setPayload(payloads.back());
+        ASSERT_EQ(a.send(data), ErrorCode::OK);
+    }
+    size_t popped = 0;
+    uint32_t now = 0;
+    for (; (!a.isIdle() || popped < payloads.size()) && now < 100000; now++)
+    {
+        for (auto frame = a.poll(now); !frame.empty(); frame = a.poll(now))
+        {
+            write(ab, frame, now);
+        }
+        for (auto frame = b.poll(now); !frame.empty(); frame = b.poll(now))
+        {
+            write(ba, frame, now);
+        }
+        read(ab, b, now);
+        read(ba, a, now);
+        for (auto &&package = b.pop(); package && package->second; package = b.pop())
+        {
+            ASSERT_LT(popped, payloads.size());
+            EXPECT_EQ(dynamic_pointer_cast<Data>(package->second)->getPayload(), payloads[popped++]);
+        }
+    }
+    EXPECT_EQ(popped, payloads.size());
+    EXPECT_TRUE(a.isIdle());
+    EXPECT_GT(a.getStatistics().retransmitted, 0);
+    EXPECT_EQ(a.getStatistics().acknowledged, a.getStatistics().sent);
+
+    //timeout adapted to round trip time
+    EXPECT_GE(a.getTimeout(), delay * 2);
+    EXPECT_LT(a.getTimeout(), 100);
+
+    //frames not valid are refused
+    uint8_t wrong[] = {ACK, 0, 0, 0, 0};
+    EXPECT_EQ(a.receive(wrong, sizeof(wrong), now), ErrorCode::CRC_NOT_MATCH);
+}
+
+TEST(ProtocolTest, transportStream)
+{
+    //frames and acknowledges of both sides go through byte streams split in small slices
+    Transport a(8, 20);
+    Transport b(8, 20);
+    StreamDecoder fromA;
+    StreamDecoder fromB;
+    vector<uint8_t> ab;
+    vector<uint8_t> ba;
+
+    vector<string> payloads;
+    for (size_t i = 0; i < 20; i++)
+    {
+        Data data;
+        payloads.push_back(generateRandomString(i % 5 == 0 ? HEAD_MAX_PAYLOAD_SIZE * 2 : 10));
+        data.setPayload(payloads.back());
+        ASSERT_EQ(a.send(data), ErrorCode::OK);
+    }
+
+    auto transfer = [](vector<uint8_t> &stream, StreamDecoder &decoder, Transport &to, uint32_t now)
+    {
+        for (size_t offset = 0; offset < stream.size(); offset += 5)
+        {
+            size_t slice = min(stream.size() - offset, static_cast<size_t>(5));
+            decoder.feed(stream.data() + offset, slice, [&to, now](const uint8_t *frame, uint16_t size)
+            {
+                EXPECT_EQ(to.receive(frame, size, now), ErrorCode::OK);
+            });
+        }
+        stream.clear();
+    };
+
+    size_t popped = 0;
+    uint32_t now = 0;
+    for (; (!a.isIdle() || popped < payloads.size()) && now < 1000; now++)
+    {
+        for (auto frame = a.poll(now); !frame.empty(); frame = a.poll(now))
+        {
+            ab.insert(ab.end(), frame.begin(), frame.end());
+        }
+        for (auto frame = b.poll(now); !frame.empty(); frame = b.poll(now))
+        {
+            ba.insert(ba.end(), frame.begin(), frame.end());
+        }
+        transfer(ab, fromA, b, now);
+        transfer(ba, fromB, a, now);
+        for (auto &&package = b.pop(); package && package->second; package = b.pop())
+        {
+            ASSERT_LT(popped, payloads.size());
+            EXPECT_EQ(dynamic_pointer_cast<Data>(package->second)->getPayload(), payloads[popped++]);
+        }
+    }
+    EXPECT_EQ(popped, payloads.size());
+    EXPECT_TRUE(a.isIdle());
+    EXPECT_EQ(a.getStatistics().retransmitted, 0);
+    EXPECT_GT(fromB.getStatistics().frames, 0);
+    EXPECT_EQ(fromB.getStatistics().droppedBytes, 0);
+    EXPECT_EQ(fromA.getStatistics().droppedBytes, 0);
+
+    //acknowledge with a wrong length is not a frame
+    uint8_t wrong[] = {ACK, 0, 2, 0, 0, 0, 0};
+    uint16_t crc16Calc = crc16(wrong, HEAD_HEADER_SIZE + 2);
+    wrong[5] = static_cast<uint8_t>(crc16Calc & 0x00FF);
+    wrong[6] = static_cast<uint8_t>(crc16Calc >> 0x08);
+    EXPECT_EQ(fromB.feed(wrong, sizeof(wrong), [](const uint8_t *, uint16_t) {}), 0);
+
+    //both peers agree on CRC32: frames, acknowledges and stream decoders use it
+    Transport c(8, 20, 60000, ChecksumType::CRC32);
+    Transport d(8, 20, 60000, ChecksumType::CRC32);
+    StreamDecoder fromC(ChecksumType::CRC32);
+    StreamDecoder fromD(ChecksumType::CRC32);
+    EXPECT_EQ(c.getChecksum(), ChecksumType::CRC32);
+    for (size_t i = 0; i < 5; i++)
+    {
+        Data data;
+        data.setPayload(payloads[i]);
+        ASSERT_EQ(c.send(data), ErrorCode::OK);
+    }
+
+    popped = 0;
+    for (now = 0; (!c.isIdle() || popped < 5) && now < 1000; now++)
+    {
+        for (auto frame = c.poll(now); !frame.empty(); frame = c.poll(now))
+        {
+            EXPECT_EQ(frame.size, HEAD_HEADER_SIZE + frame[2] + sizeof(uint32_t));
+            ab.insert(ab.end(), frame.begin(), frame.end());
+        }
+        for (auto frame = d.poll(now); !frame.empty(); frame = d.poll(now))
+        {
+            EXPECT_EQ(frame.size, HEAD_HEADER_SIZE + 1 + sizeof(uint32_t));
+            ba.insert(ba.end(), frame.begin(), frame.end());
+        }
+        transfer(ab, fromC, d, now);
+        transfer(ba, fromD, c, now);
+        for (auto &&package = d.pop(); package && package->second; package = d.pop())
+        {
+            ASSERT_LT(popped, 5);
+            EXPECT_EQ(dynamic_pointer_cast<Data>(package->second)->getPayload(), payloads[popped++]);
+        }
+    }
+    EXPECT_EQ(popped, 5);
+    EXPECT_TRUE(c.isIdle());
+    EXPECT_EQ(c.getStatistics().retransmitted, 0);
+    EXPECT_EQ(fromC.getStatistics().crcErrors, 0);
+    EXPECT_EQ(fromD.getStatistics().droppedBytes, 0);
+}
+
+TEST(ProtocolTest, deserializeInto)
+{
+    Station sta;
+    sta.id = 3;
+    sta.setName("Name");
+    sta.setDescription("Description");
+    sta.relayNumber = 2;
+    sta.wateringTime = 10;
+    sta.wateringTimeLeft = 5;
+    sta.weight = 300;
+    uint8_t out[HEAD_MAX_FRAME_SIZE];
+    auto &&frames = encodeInto(sta, out, sizeof(out));
+    auto &&head = view(out, frames.size);
+
+    Station existing;
+    ASSERT_TRUE(Station::deserializeInto(existing, head));
+    EXPECT_EQ(existing.id, 3);
+    EXPECT_EQ(existing.getName(), "Name");
+    EXPECT_EQ(existing.getDescription(), "Description");
+    EXPECT_EQ(existing.relayNumber, 2);
+    EXPECT_EQ(existing.wateringTime, 10);
+    EXPECT_EQ(existing.wateringTimeLeft, 5);
+    EXPECT_EQ(existing.weight, 300);
+    //status is not serialized
+    EXPECT_EQ(existing.status, Status::UNACTIVE);
+    auto name = existing.name.data();
+    auto description = existing.description.data();
+
+    //polling of the same records reuse storage of fields
+    size_t before = allocations;
+    for (int i = 0; i < 200; i++)
+    {
+        ASSERT_TRUE(Station::deserializeInto(existing, head));
+    }
+    EXPECT_EQ(allocations, before);
+    EXPECT_EQ(existing.name.data(), name);
+    EXPECT_EQ(existing.description.data(), description);
+
+    //shorter values fit in fields
+    sta.setName("N");
+    frames = encodeInto(sta, out, sizeof(out));
+    before = allocations;
+    ASSERT_TRUE(Station::deserializeInto(existing, view(out, frames.size)));
+    EXPECT_EQ(allocations, before);
+    EXPECT_EQ(existing.getName(), "N");
+    EXPECT_EQ(existing.name.data(), name);
+
+    Aggregation agg;
+    agg.id = 4;
+    agg.setDescription("Description");
+    agg.setStart("08:00");
+    agg.setEnd("09:00");
+    agg.sequential = true;
+    agg.weight = 300;
+    frames = encodeInto(agg, out, sizeof(out));
+    EXPECT_FALSE(Station::deserializeInto(existing, view(out, frames.size)));
+
+    Aggregation existingAgg;
+    ASSERT_TRUE(Aggregation::deserializeInto(existingAgg, view(out, frames.size)));
+    before = allocations;
+    ASSERT_TRUE(Aggregation::deserializeInto(existingAgg, view(out, frames.size)));
+    EXPECT_EQ(allocations, before);
+    EXPECT_EQ(existingAgg.id, 4);
+    EXPECT_EQ(existingAgg.getDescription(), "Description");
+    EXPECT_EQ(existingAgg.getStart(), "08:00");
+    EXPECT_EQ(existingAgg.getEnd(), "09:00");
+    EXPECT_TRUE(existingAgg.sequential);
+    EXPECT_EQ(existingAgg.weight, 300);
+    EXPECT_EQ(existingAgg.status, Status::UNACTIVE);
+
+    Synchro syn;
+    syn.setSerial("serial");
+    frames = encodeInto(syn, out, sizeof(out));
+    Synchro existingSyn;
+    ASSERT_TRUE(Synchro::deserializeInto(existingSyn, view(out, frames.size)));
+    EXPECT_EQ(existingSyn.getSerial(), "serial");
+
+    Data data;
+    data.setPayload("payload");
+    frames = encodeInto(data, out, sizeof(out));
+    Data existingData;
+    existingData.setPayload("previous");
+    ASSERT_TRUE(Data::deserializeInto(existingData, view(out, frames.size)));
+    EXPECT_EQ(existingData.length, 7);
+    EXPECT_EQ(existingData.getChunk(), "payload");
+    EXPECT_EQ(existingData.payload, nullptr);
+
+    Error err;
+    err.setMsg("msg");
+    frames = encodeInto(err, out, sizeof(out));
+    Error existingErr;
+    ASSERT_TRUE(Error::deserializeInto(existingErr, view(out, frames.size)));
+    EXPECT_EQ(existingErr.getChunk(), "msg");
+    EXPECT_FALSE(Error::deserializeInto(existingErr, out, 1, 0));
+}
+
+//fill again crc16 of a frame changed by hand
+static void fillCrc16(uint8_t *frame)
+{
+    uint16_t crc = crc16(frame, HEAD_HEADER_SIZE + frame[2]);
+    frame[HEAD_HEADER_SIZE + frame[2]] = static_cast<uint8_t>(crc & 0x00FF);
+    frame[HEAD_HEADER_SIZE + frame[2] + 1] = static_cast<uint8_t>(crc >> 0x08);
+}
+
+TEST(ProtocolTest, deserializeMalformed)
+{
+    uint8_t out[HEAD_MAX_FRAME_SIZE];
+
+    //serial length of 4096 in a payload of 2 bytes
+    Synchro syn;
+    syn.setSerial("serial");
+    auto &&frames = encodeInto(syn, out, sizeof(out));
+    out[2] = sizeof(uint16_t);
+    out[HEAD_HEADER_SIZE] = 0x00;
+    out[HEAD_HEADER_SIZE + 1] = 0x10;
+    fillCrc16(out);
+    auto &&head = tryView(out, HEAD_HEADER_SIZE + out[2] + HEAD_CRC_SIZE);
+    ASSERT_TRUE(head);
+    EXPECT_EQ(Head::deserialize(*head), nullptr);
+    auto &&composed = tryComposeChunks(head->flags, &head->payload, 1);
+    ASSERT_TRUE(composed);
+    EXPECT_EQ(composed->second, nullptr);
+    Synchro existingSyn;
+    existingSyn.setSerial("previous");
+    EXPECT_FALSE(Synchro::deserializeInto(existingSyn, *head));
+    EXPECT_EQ(existingSyn.getSerial(), "previous");
+    EXPECT_FALSE(Synchro::deserializeInto(existingSyn, out + HEAD_HEADER_SIZE, 1, 0));
+
+    //description of aggregation over payload, existing is left unchanged
+    Aggregation agg;
+    agg.id = 4;
+    agg.setDescription("Description");
+    agg.setStart("08:00");
+    agg.setEnd("09:00");
+    frames = encodeInto(agg, out, sizeof(out));
+    Aggregation existingAgg;
+    ASSERT_TRUE(Aggregation::deserializeInto(existingAgg, view(out, frames.size)));
+    out[HEAD_HEADER_SIZE + 1] = HEAD_MAX_PAYLOAD_SIZE;
+    fillCrc16(out);
+    EXPECT_EQ(Head::deserialize(view(out, frames.size)), nullptr);
+    EXPECT_FALSE(Aggregation::deserializeInto(existingAgg, view(out, frames.size)));
+    EXPECT_EQ(existingAgg.getDescription(), "Description");
+
+    //last fixed field of aggregation truncated
+    frames = encodeInto(agg, out, sizeof(out));
+    out[2]--;
+    fillCrc16(out);
+    EXPECT_EQ(Head::deserialize(view(out, frames.size - 1)), nullptr);
+
+    //name of station over payload and last fixed field truncated
+    Station sta;
+    sta.setName("Name");
+    sta.setDescription("Description");
+    frames = encodeInto(sta, out, sizeof(out));
+    out[HEAD_HEADER_SIZE + 1] = HEAD_MAX_PAYLOAD_SIZE;
+    fillCrc16(out);
+    EXPECT_EQ(Head::deserialize(view(out, frames.size)), nullptr);
+    frames = encodeInto(sta, out, sizeof(out));
+    out[2]--;
+    fillCrc16(out);
+    EXPECT_EQ(Head::deserialize(view(out, frames.size - 1)), nullptr);
+    EXPECT_EQ(Station::deserialize(out + HEAD_HEADER_SIZE, 0, 0), nullptr);
+
+    //data and error of 4096 bytes in one chunk are not composed
+    for (auto flag : {DAT, ERR})
+    {
+        uint8_t payload[] = {0x00, 0x10, 'a', 'b'};
+        BytesView chunk{payload, sizeof(payload)};
+        EXPECT_EQ(tryComposeChunks(flag, &chunk, 1).getError(), ErrorCode::PACKAGE_INCOMPLETE);
+        chunk.size = 1;
+        EXPECT_EQ(tryComposeChunks(flag, &chunk, 1).getError(), ErrorCode::PAYLOAD_MALFORMED);
+    }
+    Data existingData;
+    EXPECT_FALSE(Data::deserializeInto(existingData, out, 1, 0));
+    Error existingErr;
+    EXPECT_FALSE(Error::deserializeInto(existingErr, out, 1, 0));
+}
+
+TEST(ProtocolTest, inlineBuffer)
+{
+    //short fields are inline in package
+    Station sta;
+    sta.setName("Name");
+    sta.setDescription("Description");
+    EXPECT_TRUE(sta.name.isInline());
+    EXPECT_TRUE(sta.description.isInline());
+    EXPECT_EQ(sizeof(sta.name), 32);
+
+    uint8_t out[HEAD_MAX_FRAME_SIZE];
+    auto &&frames = encodeInto(sta, out, sizeof(out));
+    size_t before = allocations;
+    auto des = Station::deserialize(view(out, frames.size));
+    EXPECT_EQ(allocations, before);
+    ASSERT_TRUE(des);
+    EXPECT_EQ(des->getName(), "Name");
+    EXPECT_EQ(des->getDescription(), "Description");
+    delete des;
+
+    //long fields spill and come back inline on copy only if they fit
+    auto &&description = generateRandomString(200);
+    sta.setDescription(description);
+    EXPECT_FALSE(sta.description.isInline());
+    EXPECT_EQ(sta.description.getCapacity(), 200);
+    EXPECT_EQ(sta.getDescription(), description);
+
+    Station copy(sta);
+    EXPECT_EQ(copy.getName(), "Name");
+    EXPECT_EQ(copy.getDescription(), description);
+    EXPECT_NE(copy.description.data(), sta.description.data());
+
+    Station moved(move(copy));
+    EXPECT_EQ(moved.getDescription(), description);
+    EXPECT_TRUE(copy.description.isInline());
+
+    //error and data own their chunk and payload, copies allocate them again
+    Error chunked;
+    chunked.setMsg("msg");
+    auto errEnc = encode(&chunked);
+    auto decodedErr = Error::deserialize(view(errEnc[0]));
+    ASSERT_TRUE(decodedErr);
+    ASSERT_TRUE(decodedErr->chunk);
+    Error errCopy(*decodedErr);
+    EXPECT_NE(errCopy.chunk, decodedErr->chunk);
+    EXPECT_EQ(errCopy.getChunk(), decodedErr->getChunk());
+    EXPECT_EQ(errCopy.length, decodedErr->length);
+    Error errAssigned;
+    errAssigned = errCopy;
+    EXPECT_EQ(errAssigned.getChunk(), decodedErr->getChunk());
+    Package::destroy(decodedErr);
+
+    Data data;
+    unique_ptr<uint8_t[]> adopted(new uint8_t[3]{1, 2, 3});
+    data.adoptPayload(move(adopted), 3);
+    Data dataCopy(data);
+    EXPECT_FALSE(dataCopy.payloadAdopted);
+    EXPECT_NE(dataCopy.payload, data.payload);
+    EXPECT_EQ(dataCopy.getPayload(), data.getPayload());
+    auto dataEnc = encode(&data);
+    auto decodedData = Data::deserialize(view(dataEnc[0]));
+    ASSERT_TRUE(decodedData);
+    dataCopy = *decodedData;
+    EXPECT_EQ(dataCopy.length, 3);
+    EXPECT_TRUE(dataCopy.getPayloadView().empty());
+    EXPECT_EQ(dataCopy.getChunk(), decodedData->getChunk());
+    EXPECT_NE(dataCopy.chunk, decodedData->chunk);
+    Package::destroy(decodedData);
+
+    //copy of a package in a memory resource is not in that resource
+    std::pmr::monotonic_buffer_resource errResource;
+    auto errInResource = Error::deserialize(view(errEnc[0]), 0, &errResource);
+    ASSERT_TRUE(errInResource);
+    Error errOutOfResource(*errInResource);
+    EXPECT_EQ(errOutOfResource.resource, nullptr);
+    EXPECT_EQ(errOutOfResource.getChunk(), errInResource->getChunk());
+    Package::destroy(errInResource);
+
+    //spill in memory resource of package
+    alignas(max_align_t) static uint8_t memory[4 * 1024];
+    std::pmr::monotonic_buffer_resource resource(memory, sizeof(memory), std::pmr::null_memory_resource());
+    frames = encodeInto(sta, out, sizeof(out));
+    before = allocations;
+    auto desResource = Station::deserialize(view(out, frames.size), 0, &resource);
+    EXPECT_EQ(allocations, before);
+    ASSERT_TRUE(desResource);
+    EXPECT_EQ(desResource->getDescription(), description);
+    Package::destroy(desResource);
+
+    //assign inline to spilled keep storage and clear the tail
+    InlineBuffer<HEAD_INLINE_FIELD_SIZE> spilled;
+    memset(spilled.reserve(100, nullptr), 'x', 100);
+    InlineBuffer<HEAD_INLINE_FIELD_SIZE> small;
+    memcpy(small.data(), "small", 5);
+    spilled = small;
+    EXPECT_EQ(spilled.getCapacity(), 100);
+    EXPECT_EQ(Package::viewField(spilled, 100), "small");
+    for (size_t i = HEAD_INLINE_FIELD_SIZE; i < 100; i++)
+    {
+        EXPECT_EQ(spilled[i], '\0');
+    }
+
+    //copy spill in memory resource of destination, not in the one of source
+    auto inResource = [&](const char *ptr)
+    {
+        return reinterpret_cast<const uint8_t *>(ptr) >= memory && reinterpret_cast<const uint8_t *>(ptr) < memory + sizeof(memory);
+    };
+    InlineBuffer<HEAD_INLINE_FIELD_SIZE> source;
+    memset(source.reserve(200, &resource), 'y', 200);
+    ASSERT_TRUE(inResource(source.data()));
+    InlineBuffer<HEAD_INLINE_FIELD_SIZE> copied(source);
+    EXPECT_FALSE(inResource(copied.data()));
+    EXPECT_EQ(copied.getCapacity(), 200);
+    EXPECT_EQ(copied[199], 'y');
+
+    InlineBuffer<HEAD_INLINE_FIELD_SIZE> destination;
+    destination.reserve(100, &resource);
+    destination = copied;
+    EXPECT_TRUE(inResource(destination.data()));
+    EXPECT_EQ(destination.getCapacity(), 200);
+    EXPECT_EQ(destination[199], 'y');
+
+    //value longer than length are not read over capacity
+    Error err;
+    err.length = 1000;
+    EXPECT_EQ(err.getMsg(), "");
+    EXPECT_TRUE(err.serialize().first);
+}
+
+TEST(ProtocolTest, views)
+{
+    Station sta;
+    sta.setName("Name");
+    sta.setDescription(string("Desc\0ription", 11));
+    Aggregation agg;
+    agg.setDescription("Description");
+    agg.setStart("08:00");
+    agg.setEnd("09:00");
+    Synchro syn;
+    syn.setSerial("serial");
+
+    //views not allocate and stop at first '\0' as getters
+    size_t before = allocations;
+    EXPECT_EQ(sta.getNameView(), "Name");
+    EXPECT_EQ(sta.getDescriptionView(), "Desc");
+    EXPECT_EQ(agg.getDescriptionView(), "Description");
+    EXPECT_EQ(agg.getStartView(), "08:00");
+    EXPECT_EQ(agg.getEndView(), "09:00");
+    EXPECT_EQ(syn.getSerialView(), "serial");
+    EXPECT_EQ(allocations, before);
+    EXPECT_EQ(sta.getDescription(), "Desc");
+    EXPECT_TRUE(Station().getNameView().empty());
+
+    //binary views of data and error keep zeros
+    string binary("bin\0ary", 7);
+    Data data;
+    data.setPayload(binary);
+    auto payload = data.getPayloadView();
+    ASSERT_EQ(payload.size, binary.size());
+    EXPECT_EQ(memcmp(payload.data, binary.data(), binary.size()), 0);
+    EXPECT_TRUE(Data().getPayloadView().empty());
+
+    Error err;
+    err.setMsg(binary);
+    auto msg = err.getMsgView();
+    ASSERT_EQ(msg.size, binary.size());
+    EXPECT_EQ(memcmp(msg.data, binary.data(), binary.size()), 0);
+
+    auto enc = encode(&data);
+    auto head = decode(enc[0]);
+    auto des = Data::deserialize(head->payload, head->length, 0);
+    ASSERT_TRUE(des);
+    auto chunk = des->getChunkView();
+    ASSERT_EQ(chunk.size, binary.size());
+    EXPECT_EQ(memcmp(chunk.data, binary.data(), binary.size()), 0);
+    EXPECT_EQ(head->getPayloadView().size, head->length);
+    delete des;
+}
+
+TEST(ProtocolTest, binaryPayload)
+{
+    //zeros are kept by setter and getter
+    string binary(HEAD_MAX_PAYLOAD_SIZE * 2, '\0');
+    for (size_t i = 0; i < binary.size(); i++)
+    {
+        binary[i] = static_cast<char>(i % 3 == 0 ? 0 : i);
+    }
+    Data data;
+    data.setPayload(reinterpret_cast<const uint8_t *>(binary.data()), binary.size());
+    EXPECT_EQ(data.getPayload(), binary);
+
+    //adopted payload is framed in place without copy in package
+    unique_ptr<uint8_t[]> buffer(new uint8_t[binary.size()]);
+    memcpy(buffer.get(), binary.data(), binary.size());
+    auto adopted = buffer.get();
+    size_t before = allocations;
+    data.adoptPayload(move(buffer), binary.size());
+    EXPECT_EQ(allocations, before);
+    EXPECT_EQ(data.getPayloadView().data, adopted);
+    EXPECT_EQ(data.getPayload(), binary);
+
+    auto enc = encode(&data);
+    ASSERT_EQ(enc.size(), 4);
+    Heads heads;
+    for (auto &&buf : enc)
+    {
+        heads.push_back(decode(buf));
+    }
+    auto &&[flags, pkg] = composeDecodedChunks(heads);
+    EXPECT_EQ(flags, DAT);
+    ASSERT_TRUE(pkg);
+    EXPECT_EQ(reinterpret_cast<Data *>(pkg.get())->getPayload(), binary);
+
+    //frames are the same of serialize
+    auto serialized = data.serialize();
+    uint8_t out[HEAD_MAX_FRAMES * HEAD_MAX_FRAME_SIZE];
+    auto frames = encodeInto(data, out, sizeof(out));
+    ASSERT_EQ(frames.count, enc.size());
+    for (uint8_t i = 0; i < frames.count; i++)
+    {
+        ASSERT_EQ(frames.getFrameSize(i), enc[i].second);
+        EXPECT_EQ(memcmp(&out[frames.offsets[i]], enc[i].first.get(), enc[i].second), 0);
+    }
+    EXPECT_EQ(memcmp(&out[frames.offsets[0] + HEAD_HEADER_SIZE], serialized.first.get(), HEAD_MAX_PAYLOAD_SIZE), 0);
+
+    //ownership goes back to caller
+    uint16_t size = 0;
+    auto released = data.releasePayload(size);
+    EXPECT_EQ(released.get(), adopted);
+    EXPECT_EQ(size, binary.size());
+    EXPECT_EQ(data.length, 0);
+    EXPECT_TRUE(data.getPayloadView().empty());
+
+    //setter after adoption allocate its own payload
+    data.adoptPayload(move(released), size);
+    data.setPayload("set");
+    EXPECT_FALSE(data.payloadAdopted);
+    EXPECT_EQ(data.getPayload(), "set");
+
+    //payload in a memory resource is copied when released
+    std::pmr::monotonic_buffer_resource resource;
+    auto inResource = Package::create<Data>(&resource);
+    inResource->setPayload(binary);
+    auto copy = inResource->releasePayload(size);
+    ASSERT_EQ(size, binary.size());
+    EXPECT_EQ(memcmp(copy.get(), binary.data(), size), 0);
+    Package::destroy(inResource);
+
+    //data decoded from a single frame has length but not payload, encoded again its bytes are 0
+    Data single;
+    single.setPayload("single");
+    uint8_t singleOut[HEAD_MAX_FRAME_SIZE];
+    auto singleFrames = encodeInto(single, singleOut, sizeof(singleOut));
+    auto decoded = Data::deserialize(view(singleOut, singleFrames.size));
+    ASSERT_TRUE(decoded);
+    EXPECT_EQ(decoded->length, 6);
+    EXPECT_TRUE(decoded->getPayloadView().empty());
+    memset(out, 0xAA, sizeof(out));
+    frames = encodeInto(*decoded, out, sizeof(out));
+    ASSERT_EQ(frames.count, 1);
+    ASSERT_EQ(frames.size, HEAD_HEADER_SIZE + sizeof(uint16_t) + 6 + HEAD_CRC_SIZE);
+    for (size_t i = HEAD_HEADER_SIZE + sizeof(uint16_t); i < HEAD_HEADER_SIZE + sizeof(uint16_t) + 6; i++)
+    {
+        EXPECT_EQ(out[i], 0);
+    }
+    EXPECT_TRUE(decode(out, frames.size));
+    auto decodedSerialized = decoded->serialize();
+    ASSERT_EQ(decodedSerialized.second, sizeof(uint16_t) + 6);
+    EXPECT_EQ(memcmp(&out[HEAD_HEADER_SIZE], decodedSerialized.first.get(), decodedSerialized.second), 0);
+    Package::destroy(decoded);
+
+    //bytes before tail longer than a chunk are still serialized once
+    Aggregation agg;
+    agg.setDescription(string(HEAD_MAX_PAYLOAD_SIZE, 'a'));
+    agg.setStart("08:00");
+    auto aggSerialized = agg.serialize();
+    frames = encodeInto(agg, out, sizeof(out));
+    ASSERT_EQ(frames.count, 3);
+    EXPECT_EQ(memcmp(&out[frames.offsets[0] + HEAD_HEADER_SIZE], aggSerialized.first.get(), HEAD_MAX_PAYLOAD_SIZE), 0);
+    EXPECT_EQ(memcmp(&out[frames.offsets[1] + HEAD_HEADER_SIZE], aggSerialized.first.get() + HEAD_MAX_PAYLOAD_SIZE, aggSerialized.second - HEAD_MAX_PAYLOAD_SIZE), 0);
+}
+
+TEST(ProtocolTest, pool)
+{
+    Pool pool(24, 4);
+    void *blocks[9];
+    for (auto &&it : blocks)
+    {
+        it = pool.allocate();
+        ASSERT_TRUE(it);
+        EXPECT_TRUE(pool.owns(it));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(it) % alignof(max_align_t), 0);
+    }
+    EXPECT_EQ(pool.getStatistics().slabs, 3);
+    EXPECT_EQ(pool.getStatistics().used, 9);
+    EXPECT_GE(pool.getStatistics().blockSize, 24);
+
+    int local;
+    EXPECT_FALSE(pool.owns(&local));
+
+    for (auto &&it : blocks)
+    {
+        pool.deallocate(it);
+    }
+    EXPECT_EQ(pool.getStatistics().used, 0);
+    EXPECT_EQ(pool.getStatistics().peak, 9);
+
+    //blocks are reused
+    auto block = pool.allocate();
+    EXPECT_TRUE(pool.owns(block));
+    EXPECT_EQ(pool.getStatistics().slabs, 3);
+    EXPECT_FALSE(pool.deallocateOwned(&local));
+    EXPECT_TRUE(pool.deallocateOwned(block));
+    EXPECT_EQ(pool.getStatistics().used, 0);
+
+    //ownership is found in every slab
+    Pool many(24, 1);
+    void *manyBlocks[40];
+    for (auto &&it : manyBlocks)
+    {
+        it = many.allocate();
+        ASSERT_TRUE(it);
+    }
+    for (auto &&it : manyBlocks)
+    {
+        EXPECT_TRUE(many.owns(it));
+        EXPECT_TRUE(many.deallocateOwned(it));
+    }
+    EXPECT_EQ(many.getStatistics().used, 0);
+
+    //small buffers are taken from the pool of the smallest block
+    auto small = getPoolStatistics();
+    auto buffer = allocateBuffer(8);
+    ASSERT_TRUE(buffer);
+    EXPECT_EQ(getPoolStatistics()[0].used, small[0].used + 1);
+    EXPECT_EQ(getPoolStatistics()[3].used, small[3].used);
+    deallocateBuffer(buffer, 8);
+    EXPECT_EQ(getPoolStatistics()[0].used, small[0].used);
+
+    //decode and deserialize in steady state use only pools
+    Aggregation agg;
+    agg.id = 1;
+    auto enc = encode(&agg);
+    delete decode(enc[0])->deserialize();
+
+    size_t before = allocations;
+    auto statistics = getPoolStatistics();
+    for (int i = 0; i < 100; i++)
+    {
+        auto head = decode(enc[0]);
+        delete head->deserialize();
+    }
+    EXPECT_EQ(allocations, before);
+
+    auto after = getPoolStatistics();
+    size_t used = 0;
+    for (size_t i = 0; i < after.size(); i++)
+    {
+        EXPECT_GE(after[i].allocations, statistics[i].allocations);
+        used += after[i].allocations - statistics[i].allocations;
+    }
+    //head with control block, payload and package
+    EXPECT_EQ(used, 300);
+
+    //payload assigned by user with new[]
+    Head head;
+    head.payload = new uint8_t[4];
+}
+
+TEST(ProtocolTest, memoryResource)
+{
+    Aggregation agg;
+    agg.id = 7;
+    agg.setDescription("Description");
+    agg.setStart("08:00");
+    agg.setEnd("09:00");
+    Data data;
+    auto &&payload = generateRandomString(600);
+    data.setPayload(payload);
+
+    //whole burst in one buffer, upstream throw if it is not enough
+    alignas(max_align_t) static uint8_t memory[32 * 1024];
+    std::pmr::monotonic_buffer_resource resource(memory, sizeof(memory), std::pmr::null_memory_resource());
+
+    size_t before = allocations;
+    {
+        auto encAgg = encode(&agg, NOT_SET, &resource);
+        ASSERT_EQ(encAgg.size(), 1);
+        EXPECT_EQ(encAgg.get_allocator().resource(), &resource);
+
+        PmrHeads heads(&resource);
+        heads.push_back(decode(encAgg[0].first.get(), encAgg[0].second, &resource));
+        EXPECT_EQ(heads[0]->resource, &resource);
+        auto &&[flagsAgg, pkgAgg] = composeDecodedChunks(heads, &resource);
+        ASSERT_EQ(flagsAgg, AGG);
+        EXPECT_EQ(pkgAgg->resource, &resource);
+        auto aggDecoded = static_cast<Aggregation *>(pkgAgg.get());
+        EXPECT_EQ(aggDecoded->id, 7);
+        EXPECT_EQ(aggDecoded->getStart(), "08:00");
+        EXPECT_EQ(aggDecoded->getEnd(), "09:00");
+
+        auto encDat = encode(&data, ACK, &resource);
+        ASSERT_EQ(encDat.size(), 4);
+        heads.clear();
+        for (auto &&it : encDat)
+        {
+            heads.push_back(decode(it.first.get(), it.second, &resource));
+        }
+        auto &&[flagsDat, pkgDat] = composeDecodedChunks(heads, &resource);
+        ASSERT_EQ(flagsDat, DAT);
+        EXPECT_EQ(static_cast<Data *>(pkgDat.get())->length, payload.size());
+        EXPECT_EQ(memcmp(static_cast<Data *>(pkgDat.get())->payload, payload.data(), payload.size()), 0);
+
+        //raw package
+        auto des = Aggregation::deserialize(encAgg[0].first.get() + HEAD_HEADER_SIZE, encAgg[0].second - HEAD_HEADER_SIZE - HEAD_CRC_SIZE, 0, &resource);
+        ASSERT_TRUE(des);
+        EXPECT_EQ(des->getDescription(), "Description");
+        Package::destroy(des);
+    }
+    EXPECT_EQ(allocations, before);
+
+    //everything is given back at once
+    resource.release();
+
+    //without resource packages are allocated from pools
+    auto des = Head::deserialize(view(encode(&agg)[0]), 0, nullptr);
+    ASSERT_TRUE(des);
+    EXPECT_EQ(des->resource, nullptr);
+    Package::destroy(des);
+}
+
+//test binds a string literal to char * and keeps an unused value, warnings are silenced around it
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-variable"
 TEST(ProtocolTest, generateRandomIntegral)
 {
     auto i = generateRandomIntegral<uint8_t>();
@@ -382,4 +2114,172 @@ TEST(ProtocolTest, generateRandomIntegral)
 
     EXPECT_TRUE(h->getHexPayload() == stringHexToString(h->payload, h->length));
 
-}
\ No newline at end of file
+}
+#pragma GCC diagnostic pop
+
+TEST(ProtocolTest, crc16)
+{
+    uint8_t data[HEAD_MAX_FRAME_SIZE];
+    for (auto &&it : data)
+    {
+        it = rand() % 256;
+    }
+
+    for (size_t size = 0; size <= sizeof(data); size++)
+    {
+        EXPECT_EQ(crc16(data, size), crc_16(data, size));
+        EXPECT_EQ(crc16Table(data, size), crc_16(data, size));
+        //split in two buffers
+        EXPECT_EQ(crc16(data + size / 3, size - size / 3, crc16(data, size / 3)), crc_16(data, size));
+    }
+
+    //patch a changed byte as calculate crc16 again, also after max distance
+    uint8_t frame[CRC16_PATCH_MAX_DISTANCE + 8];
+    for (auto &&it : frame)
+    {
+        it = rand() % 256;
+    }
+    for (size_t size = 2; size <= sizeof(frame); size++)
+    {
+        uint16_t crc = crc_16(frame, size);
+        uint8_t old = frame[1];
+        frame[1] = rand() % 256;
+        EXPECT_EQ(crc16Patch(crc, old ^ frame[1], size - 2), crc_16(frame, size)) << "size " << size;
+    }
+}
+
+TEST(ProtocolTest, crc16Clmul)
+{
+    if (!crc16ClmulSupported())
+    {
+        GTEST_SKIP() << "carry-less multiply not supported";
+    }
+
+    uint8_t data[HEAD_MAX_FRAME_SIZE];
+    for (int round = 0; round < 16; round++)
+    {
+        for (auto &&it : data)
+        {
+            it = rand() % 256;
+        }
+
+        for (size_t size = 0; size <= sizeof(data); size++)
+        {
+            ASSERT_EQ(crc16Clmul(data, size), crc_16(data, size)) << "size " << size;
+            //split in two buffers
+            ASSERT_EQ(crc16Clmul(data + size / 3, size - size / 3, crc16Clmul(data, size / 3)), crc_16(data, size)) << "size " << size;
+        }
+    }
+}
+
+TEST(ProtocolTest, crc32c)
+{
+    //check value of CRC32C
+    const char *check = "123456789";
+    EXPECT_EQ(crc32cTable(reinterpret_cast<const uint8_t *>(check), strlen(check)), 0xE3069283);
+    EXPECT_EQ(crc32c(reinterpret_cast<const uint8_t *>(check), strlen(check)), 0xE3069283);
+
+    //without crc32 instructions crc32cHardware() fall back to tables
+    uint8_t data[HEAD_MAX_FRAME_SIZE + HEAD_MAX_CHECKSUM_SIZE];
+    for (auto &&it : data)
+    {
+        it = rand() % 256;
+    }
+    for (size_t size = 0; size <= sizeof(data); size++)
+    {
+        ASSERT_EQ(crc32cHardware(data, size), crc32cTable(data, size)) << "size " << size;
+        ASSERT_EQ(crc32c(data, size), crc32cTable(data, size)) << "size " << size;
+        //split in two buffers, also not aligned
+        ASSERT_EQ(crc32cHardware(data + size / 3, size - size / 3, crc32cHardware(data, size / 3)), crc32cTable(data, size)) << "size " << size;
+    }
+    EXPECT_EQ(crc32c(nullptr, 1, 0x1234), 0x1234);
+}
+
+TEST(ProtocolTest, checksums)
+{
+    uint8_t data[HEAD_MAX_FRAME_SIZE];
+    for (auto &&it : data)
+    {
+        it = rand() % 256;
+    }
+
+    for (size_t size = 0; size <= sizeof(data); size++)
+    {
+        EXPECT_EQ(crcCcitt(data, size), crc_ccitt_ffff(data, size));
+        EXPECT_EQ(ModbusChecksum::calculate(data, size), crc_modbus(data, size));
+        //split in two buffers
+        EXPECT_EQ(crcCcitt(data + size / 3, size - size / 3, crcCcitt(data, size / 3)), crc_ccitt_ffff(data, size));
+        EXPECT_EQ(crc32(data + size / 3, size - size / 3, crc32(data, size / 3)), crc32(data, size));
+    }
+
+    //check values of CRC32 and Modbus, Modbus is crc16 started from 0xFFFF
+    const char *check = "123456789";
+    EXPECT_EQ(crc32(reinterpret_cast<const uint8_t *>(check), strlen(check)), 0xCBF43926);
+    EXPECT_EQ(ModbusChecksum::calculate(reinterpret_cast<const uint8_t *>(check), strlen(check)), 0x4B37);
+    EXPECT_EQ(Crc16Checksum::calculate(reinterpret_cast<const uint8_t *>(check), strlen(check)), 0xBB3D);
+}
+
+template<typename C>
+static void checkChecksumPolicy()
+{
+    Data data;
+    data.setPayload(generateRandomString(HEAD_MAX_PAYLOAD_SIZE * 2));
+    uint8_t out[HEAD_MAX_FRAMES * (HEAD_MAX_FRAME_SIZE + HEAD_MAX_CHECKSUM_SIZE)];
+    size_t size = getEncodedSize<C>(data);
+    EXPECT_EQ(size, getEncodedSize(data) + 4 * (C::SIZE - HEAD_CRC_SIZE));
+    EXPECT_EQ(getEncodedSize(data, C::TYPE), size);
+
+    auto &&frames = tryEncodeInto<C>(data, ACK, out, sizeof(out));
+    ASSERT_TRUE(frames);
+    ASSERT_EQ(frames->size, size);
+    ASSERT_EQ(frames->count, 4);
+    EXPECT_EQ(tryEncodeInto<C>(data, ACK, out, size - 1).getError(), ErrorCode::BUFFER_TOO_SMALL);
+
+    //frames of link checked with the same checksum, chosen at compile time or at runtime
+    for (uint8_t i = 0; i < frames->count; i++)
+    {
+        auto frame = &out[frames->offsets[i]];
+        auto &&head = tryView<C>(frame, frames->getFrameSize(i));
+        ASSERT_TRUE(head);
+        EXPECT_EQ(head->flags & HEAD_PACKAGE_MASK, i + 1 < frames->count ? DAT : FIN);
+        EXPECT_EQ(HEAD_HEADER_SIZE + head->length + C::SIZE, frames->getFrameSize(i));
+        EXPECT_TRUE(tryView(frame, frames->getFrameSize(i), C::TYPE));
+    }
+
+    //frames changed are detected with a checksum
+    out[HEAD_HEADER_SIZE] ^= 0x01;
+    EXPECT_EQ(tryView<C>(out, frames->getFrameSize(0)).hasValue(), C::SIZE == 0);
+}
+
+TEST(ProtocolTest, checksumPolicy)
+{
+    checkChecksumPolicy<Crc16Checksum>();
+    checkChecksumPolicy<ModbusChecksum>();
+    checkChecksumPolicy<CcittChecksum>();
+    checkChecksumPolicy<Crc32Checksum>();
+    checkChecksumPolicy<NoChecksum>();
+    checkChecksumPolicy<Crc32cChecksum>();
+
+    //head of CRC32C frames is the same of crc16 ones, checksum is agreed by the link
+    Data agreed;
+    agreed.setPayload("agreed");
+    uint8_t c[HEAD_MAX_FRAME_SIZE + HEAD_MAX_CHECKSUM_SIZE];
+    auto &&crc32cFrames = tryEncodeInto<Crc32cChecksum>(agreed, NOT_SET, c, sizeof(c));
+    ASSERT_TRUE(crc32cFrames);
+    EXPECT_EQ(c[0], DAT);
+    EXPECT_EQ(tryView(c, crc32cFrames->getFrameSize(0)).getError(), ErrorCode::CRC_NOT_MATCH);
+    auto &&crc32cHead = tryView(c, crc32cFrames->getFrameSize(0), ChecksumType::CRC32C);
+    ASSERT_TRUE(crc32cHead);
+    EXPECT_EQ(crc32cHead->version, CURRENT_PROTOCOL_ACTIVE_VERSION);
+    EXPECT_EQ(crc32cHead->flags, DAT);
+
+    //default policy is the frame of encodeInto()
+    Synchro syn;
+    syn.setSerial("serial");
+    uint8_t a[HEAD_MAX_FRAME_SIZE];
+    uint8_t b[HEAD_MAX_FRAME_SIZE];
+    auto &&frames = tryEncodeInto<Crc16Checksum>(syn, NOT_SET, a, sizeof(a));
+    ASSERT_TRUE(frames);
+    ASSERT_EQ(encodeInto(syn, b, sizeof(b)).size, frames->size);
+    EXPECT_EQ(memcmp(a, b, frames->size), 0);
+}